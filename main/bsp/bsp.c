@@ -9,8 +9,11 @@
 /* Includes ----------------------------------------------------------- */
 #include "bsp.h"
 #include "i2c_bus.h"
+#include "bsp_mem.h"
 #include "freertos/task.h"
 #include "driver/gpio.h"
+#include "driver/uart.h"
+#include "sdkconfig.h"
 
 
 #define LOG_LOCAL_LEVEL ESP_LOG_VERBOSE
@@ -18,6 +21,10 @@
 
 /* Private defines ---------------------------------------------------- */
 #define BLINK_GPIO GPIO_NUM_2
+#define BSP_UART_PORT       CONFIG_ESP_CONSOLE_UART_NUM
+#define BSP_UART_RX_BUF     256   //Driver requires more than the hardware FIFO
+#define BSP_I2C_LOCK_WAIT_MS   20    //A 32 byte burst at 400kHz holds the bus under 1ms
+#define BSP_I2C_LOCK_CEILING   1     //Priority of the PMIC task, the most urgent bus user
 
 /* Private enumerate/structure ---------------------------------------- */
 /* Private macros ----------------------------------------------------- */
@@ -41,6 +48,8 @@ void bsp_hw_init(void)
    gpio_pad_select_gpio(BLINK_GPIO);
    /* Set the GPIO as a push/pull output */
    gpio_set_direction(BLINK_GPIO, GPIO_MODE_OUTPUT);
+
+   audio_mem_arena_print(audio_mem_boot_arena(), TAG);
 }
 
 int bsp_i2c_write(uint8_t slave_addr, uint8_t reg_addr, uint8_t *p_data, uint32_t len)
@@ -48,6 +57,10 @@ int bsp_i2c_write(uint8_t slave_addr, uint8_t reg_addr, uint8_t *p_data, uint32_
    int ret;
    ret = i2c_bus_write_bytes(m_i2c_0_hdl, slave_addr, &reg_addr, sizeof(reg_addr), p_data, len);
 
+   if (ret == I2C_BUS_ERR_BUSY)
+   {
+      return ret;   //Lock busy, bus untouched: the caller retries. A hung bus still gets the restart
+   }
    if (ret != 0)
    {
       ESP_LOGE(TAG, "I2C 0 error: %d. Restart I2C", ret);
@@ -64,6 +77,10 @@ int bsp_i2c_read(uint8_t slave_addr, uint8_t reg_addr, uint8_t *p_data, uint32_t
    int ret;
    ret = i2c_bus_read_bytes(m_i2c_0_hdl, slave_addr, &reg_addr, sizeof(reg_addr), p_data, len);
 
+   if (ret == I2C_BUS_ERR_BUSY)
+   {
+      return ret;   //Lock busy, bus untouched: the caller retries. A hung bus still gets the restart
+   }
    if (ret != 0)
    {
       ESP_LOGE(TAG, "I2C 0 error: %d. Restart I2C", ret);
@@ -86,6 +103,20 @@ void bsp_gpio_write(uint8_t pin , uint8_t state)
    gpio_set_level(pin, state);
 }
 
+int bsp_uart_write(const uint8_t *p_data, uint32_t len)
+{
+   if (!uart_is_driver_installed(BSP_UART_PORT))
+   {
+      if (uart_driver_install(BSP_UART_PORT, BSP_UART_RX_BUF, 0, 0, NULL, 0) != ESP_OK)
+      {
+         ESP_LOGE(TAG, "bsp_uart_write() UART driver install failed");
+         return 1;
+      }
+   }
+
+   return (uart_write_bytes(BSP_UART_PORT, (const char *)p_data, len) == (int)len) ? 0 : 1;
+}
+
 /* Private function definitions ---------------------------------------- */
 /**
  * @brief         I2C init
@@ -111,6 +142,7 @@ void m_bsp_i2c_init(void)
 
    m_i2c_0_hdl = i2c_bus_create(I2C_NUM_0, &es_i2c_cfg);
    i2c_set_timeout(I2C_NUM_0, 0xfffff);
+   i2c_bus_set_lock(m_i2c_0_hdl, BSP_I2C_LOCK_WAIT_MS, BSP_I2C_LOCK_CEILING);
 }
 
 /* End of file -------------------------------------------------------- */
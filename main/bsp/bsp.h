@@ -133,6 +133,20 @@ void bsp_delay_ms(uint32_t ms);
  */
 void bsp_gpio_write(uint8_t pin , uint8_t state);
 
+/**
+ * @brief         Raw write to the console UART, bypassing stdio line-ending conversion
+ *
+ * @param[in]     p_data        Pointer to handle of data
+ * @param[in]     len           Data length
+ *
+ * @attention     Installs the UART driver on the console port on first use
+ *
+ * @return
+ * - 0      Succes
+ * - 1      Error
+ */
+int bsp_uart_write(const uint8_t *p_data, uint32_t len);
+
 /* -------------------------------------------------------------------------- */
 #ifdef __cplusplus
 } // extern "C"
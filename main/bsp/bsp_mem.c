@@ -30,17 +30,257 @@
 #include "bsp_mem.h"
 #include "esp_heap_caps.h"
 #include "esp_efuse.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
 
 // #define ENABLE_AUDIO_MEM_TRACE
+// #define ENABLE_AUDIO_MEM_PROFILE
 
-void *audio_malloc(size_t size)
+#define AUDIO_MEM_POOL_STORAGE(size, count)  (((count) > 0 ? (count) : 1) * (size))
+
+/* Free blocks are chained through their first word */
+typedef struct audio_mem_block {
+    struct audio_mem_block *next;
+} audio_mem_block_t;
+
+typedef struct {
+    uint8_t *base;
+    audio_mem_block_t *free;    /* Blocks returned by audio_free */
+    uint16_t fresh;             /* Blocks never handed out start here */
+    audio_mem_pool_stats_t stats;
+} audio_mem_pool_t;
+
+static uint8_t m_mem_pool_16[AUDIO_MEM_POOL_STORAGE(16, AUDIO_MEM_POOL_16_COUNT)] __attribute__((aligned(8)));
+static uint8_t m_mem_pool_32[AUDIO_MEM_POOL_STORAGE(32, AUDIO_MEM_POOL_32_COUNT)] __attribute__((aligned(8)));
+static uint8_t m_mem_pool_64[AUDIO_MEM_POOL_STORAGE(64, AUDIO_MEM_POOL_64_COUNT)] __attribute__((aligned(8)));
+static uint8_t m_mem_pool_128[AUDIO_MEM_POOL_STORAGE(128, AUDIO_MEM_POOL_128_COUNT)] __attribute__((aligned(8)));
+
+/* Ascending block sizes */
+static audio_mem_pool_t m_mem_pool[AUDIO_MEM_POOL_CLASSES] = {
+    { .base = m_mem_pool_16,  .stats = { .block_size = 16,  .blocks = AUDIO_MEM_POOL_16_COUNT } },
+    { .base = m_mem_pool_32,  .stats = { .block_size = 32,  .blocks = AUDIO_MEM_POOL_32_COUNT } },
+    { .base = m_mem_pool_64,  .stats = { .block_size = 64,  .blocks = AUDIO_MEM_POOL_64_COUNT } },
+    { .base = m_mem_pool_128, .stats = { .block_size = 128, .blocks = AUDIO_MEM_POOL_128_COUNT } },
+};
+static portMUX_TYPE m_mem_pool_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint8_t m_mem_boot_arena_buf[AUDIO_MEM_BOOT_ARENA_SIZE] __attribute__((aligned(AUDIO_MEM_ARENA_ALIGN)));
+static audio_mem_arena_t m_mem_boot_arena = {
+    .base = m_mem_boot_arena_buf,
+    .size = AUDIO_MEM_BOOT_ARENA_SIZE,
+};
+static portMUX_TYPE m_mem_arena_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/* Block of the smallest class with a free one that fits, NULL to use the heap */
+static void *m_mem_pool_alloc(size_t size)
 {
-    void *data =  NULL;
+    audio_mem_pool_t *fit = NULL;
+    audio_mem_pool_t *pool;
+    void *data = NULL;
+
+    if (size == 0 || size > AUDIO_MEM_POOL_MAX_SIZE) {
+        return NULL;
+    }
+
+    portENTER_CRITICAL(&m_mem_pool_lock);
+    for (pool = m_mem_pool; pool < &m_mem_pool[AUDIO_MEM_POOL_CLASSES]; pool++) {
+        if (pool->stats.block_size < size || pool->stats.blocks == 0) {
+            continue;
+        }
+        if (fit == NULL) {
+            fit = pool;
+        }
+        if (pool->free != NULL) {
+            data = pool->free;
+            pool->free = pool->free->next;
+        } else if (pool->fresh < pool->stats.blocks) {
+            data = pool->base + (size_t)pool->fresh++ * pool->stats.block_size;
+        } else {
+            continue;
+        }
+        pool->stats.allocs++;
+        if (++pool->stats.used > pool->stats.peak) {
+            pool->stats.peak = pool->stats.used;
+        }
+        break;
+    }
+    if (data == NULL && fit != NULL) {
+        fit->stats.fallbacks++;
+    }
+    portEXIT_CRITICAL(&m_mem_pool_lock);
+
+    return data;
+}
+
+/* Class a pointer was allocated from, NULL for the heap */
+static audio_mem_pool_t *m_mem_pool_find(const void *ptr)
+{
+    const uint8_t *p = ptr;
+
+    for (int i = 0; i < AUDIO_MEM_POOL_CLASSES; i++) {
+        if (p >= m_mem_pool[i].base &&
+            p < m_mem_pool[i].base + (size_t)m_mem_pool[i].stats.blocks * m_mem_pool[i].stats.block_size) {
+            return &m_mem_pool[i];
+        }
+    }
+    return NULL;
+}
+
+static void m_mem_pool_free(audio_mem_pool_t *pool, void *ptr)
+{
+    audio_mem_block_t *block = ptr;
+
+    portENTER_CRITICAL(&m_mem_pool_lock);
+    block->next = pool->free;
+    pool->free = block;
+    pool->stats.used--;
+    portEXIT_CRITICAL(&m_mem_pool_lock);
+}
+
+#ifdef ENABLE_AUDIO_MEM_PROFILE
+/* Live allocation, open addressing with linear probing on the pointer */
+typedef struct {
+    void *ptr;
+    int32_t size;
+    audio_mem_site_t *site;
+} audio_mem_live_t;
+
+static audio_mem_event_t m_mem_prof_event[AUDIO_MEM_PROFILE_EVENTS];
+static uint32_t m_mem_prof_events;
+static audio_mem_site_t m_mem_prof_site[AUDIO_MEM_PROFILE_SITES + 1];   /* Last one is "other" */
+static audio_mem_live_t m_mem_prof_live[AUDIO_MEM_PROFILE_LIVE];
+static uint32_t m_mem_prof_untracked;
+static portMUX_TYPE m_mem_prof_lock = portMUX_INITIALIZER_UNLOCKED;
+
+#define AUDIO_MEM_PROFILE_ALLOC(ptr, size)  m_mem_prof_alloc(ptr, size, __builtin_return_address(0))
+#define AUDIO_MEM_PROFILE_FREE(ptr)         m_mem_prof_free(ptr, __builtin_return_address(0))
+
+static uint32_t m_mem_prof_home(const void *ptr)
+{
+    uint32_t h = (uint32_t)((uintptr_t)ptr >> 3) * 2654435761u;
+    return (h ^ (h >> 16)) & (AUDIO_MEM_PROFILE_LIVE - 1);
+}
+
+static void m_mem_prof_event_put(void *ptr, int32_t size, void *caller)
+{
+    audio_mem_event_t *event = &m_mem_prof_event[m_mem_prof_events++ % AUDIO_MEM_PROFILE_EVENTS];
+
+    event->t_us = (uint32_t)esp_timer_get_time();
+    event->caller = caller;
+    event->ptr = ptr;
+    event->size = size;
+}
+
+/* Site of a caller, linear in the number of sites, the table stays small */
+static audio_mem_site_t *m_mem_prof_site_of(void *caller)
+{
+    for (int i = 0; i < AUDIO_MEM_PROFILE_SITES; i++) {
+        if (m_mem_prof_site[i].caller == caller) {
+            return &m_mem_prof_site[i];
+        }
+        if (m_mem_prof_site[i].caller == NULL) {
+            m_mem_prof_site[i].caller = caller;
+            return &m_mem_prof_site[i];
+        }
+    }
+    return &m_mem_prof_site[AUDIO_MEM_PROFILE_SITES];
+}
+
+static void m_mem_prof_alloc(void *ptr, size_t size, void *caller)
+{
+    audio_mem_site_t *site;
+    uint32_t i;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    portENTER_CRITICAL(&m_mem_prof_lock);
+    m_mem_prof_event_put(ptr, size, caller);
+    site = m_mem_prof_site_of(caller);
+    site->allocs++;
+
+    i = m_mem_prof_home(ptr);
+    for (uint32_t n = 0; n < AUDIO_MEM_PROFILE_LIVE; n++, i = (i + 1) & (AUDIO_MEM_PROFILE_LIVE - 1)) {
+        if (m_mem_prof_live[i].ptr == NULL) {
+            m_mem_prof_live[i] = (audio_mem_live_t) { ptr, size, site };
+            site->live_bytes += size;
+            if (site->live_bytes > site->peak_bytes) {
+                site->peak_bytes = site->live_bytes;
+            }
+            break;
+        }
+    }
+    if (m_mem_prof_live[i].ptr != ptr) {
+        m_mem_prof_untracked++;
+    }
+    portEXIT_CRITICAL(&m_mem_prof_lock);
+}
+
+static void m_mem_prof_free(void *ptr, void *caller)
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t k;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    portENTER_CRITICAL(&m_mem_prof_lock);
+    i = m_mem_prof_home(ptr);
+    for (uint32_t n = 1; n < AUDIO_MEM_PROFILE_LIVE && m_mem_prof_live[i].ptr != NULL && m_mem_prof_live[i].ptr != ptr; n++) {
+        i = (i + 1) & (AUDIO_MEM_PROFILE_LIVE - 1);
+    }
+    if (m_mem_prof_live[i].ptr == ptr) {
+        m_mem_prof_event_put(ptr, -m_mem_prof_live[i].size, caller);
+        m_mem_prof_live[i].site->frees++;
+        m_mem_prof_live[i].site->live_bytes -= m_mem_prof_live[i].size;
+
+        /* Backward-shift deletion keeps the probe chains intact without tombstones,
+           the hole at i ends the scan even in a full table */
+        m_mem_prof_live[i].ptr = NULL;
+        j = i;
+        for (;;) {
+            j = (j + 1) & (AUDIO_MEM_PROFILE_LIVE - 1);
+            if (m_mem_prof_live[j].ptr == NULL) {
+                break;
+            }
+            k = m_mem_prof_home(m_mem_prof_live[j].ptr);
+            if (i <= j ? (i < k && k <= j) : (i < k || k <= j)) {
+                continue;
+            }
+            m_mem_prof_live[i] = m_mem_prof_live[j];
+            m_mem_prof_live[j].ptr = NULL;
+            i = j;
+        }
+    } else {
+        m_mem_prof_event_put(ptr, 0, caller);
+    }
+    portEXIT_CRITICAL(&m_mem_prof_lock);
+}
+#else
+#define AUDIO_MEM_PROFILE_ALLOC(ptr, size)  do {} while (0)
+#define AUDIO_MEM_PROFILE_FREE(ptr)         do {} while (0)
+#endif
+
+static void *m_mem_malloc(size_t size)
+{
+    void *data = m_mem_pool_alloc(size);
+    if (data == NULL) {
 #if CONFIG_SPIRAM_BOOT_INIT
-    data = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        data = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
 #else
-    data = malloc(size);
+        data = malloc(size);
 #endif
+    }
+    return data;
+}
+
+void *audio_malloc(size_t size)
+{
+    void *data = m_mem_malloc(size);
+    AUDIO_MEM_PROFILE_ALLOC(data, size);
 #ifdef ENABLE_AUDIO_MEM_TRACE
     ESP_LOGI("AUDIO_MEM", "malloc:%p, size:%d, called:0x%08x", data, size, (intptr_t)__builtin_return_address(0) - 2);
 #endif
@@ -49,7 +289,13 @@ void *audio_malloc(size_t size)
 
 void audio_free(void *ptr)
 {
-    free(ptr);
+    audio_mem_pool_t *pool = m_mem_pool_find(ptr);
+    AUDIO_MEM_PROFILE_FREE(ptr);
+    if (pool) {
+        m_mem_pool_free(pool, ptr);
+    } else {
+        free(ptr);
+    }
 #ifdef ENABLE_AUDIO_MEM_TRACE
     ESP_LOGI("AUIDO_MEM", "free:%p, called:0x%08x", ptr, (intptr_t)__builtin_return_address(0) - 2);
 #endif
@@ -58,14 +304,23 @@ void audio_free(void *ptr)
 void *audio_calloc(size_t nmemb, size_t size)
 {
     void *data =  NULL;
-#if CONFIG_SPIRAM_BOOT_INIT
-    data = heap_caps_malloc(nmemb * size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-    if (data) {
-        memset(data, 0, nmemb * size);
+    if (size > 0 && nmemb <= AUDIO_MEM_POOL_MAX_SIZE / size) {
+        data = m_mem_pool_alloc(nmemb * size);
+        if (data) {
+            memset(data, 0, nmemb * size);
+        }
     }
+    if (data == NULL) {
+#if CONFIG_SPIRAM_BOOT_INIT
+        data = heap_caps_malloc(nmemb * size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (data) {
+            memset(data, 0, nmemb * size);
+        }
 #else
-    data = calloc(nmemb, size);
+        data = calloc(nmemb, size);
 #endif
+    }
+    AUDIO_MEM_PROFILE_ALLOC(data, nmemb * size);
 #ifdef ENABLE_AUDIO_MEM_TRACE
     ESP_LOGI("AUIDO_MEM", "calloc:%p, size:%d, called:0x%08x", data, size, (intptr_t)__builtin_return_address(0) - 2);
 #endif
@@ -75,11 +330,29 @@ void *audio_calloc(size_t nmemb, size_t size)
 void *audio_realloc(void *ptr, size_t size)
 {
     void *p = NULL;
+    audio_mem_pool_t *pool = m_mem_pool_find(ptr);
+    if (pool) {
+        if (size <= pool->stats.block_size && size > 0) {
+            return ptr;
+        }
+        p = size > 0 ? m_mem_malloc(size) : NULL;
+        if (p || size == 0) {
+            if (p) {
+                memcpy(p, ptr, pool->stats.block_size);
+            }
+            m_mem_pool_free(pool, ptr);
+        }
+    } else {
 #if CONFIG_SPIRAM_BOOT_INIT
-    p = heap_caps_realloc(ptr, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        p = heap_caps_realloc(ptr, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
 #else
-    p = heap_caps_realloc(ptr, size, MALLOC_CAP_8BIT);
+        p = heap_caps_realloc(ptr, size, MALLOC_CAP_8BIT);
 #endif
+    }
+    if (p || size == 0) {
+        AUDIO_MEM_PROFILE_FREE(ptr);
+        AUDIO_MEM_PROFILE_ALLOC(p, size);
+    }
 #ifdef ENABLE_AUDIO_MEM_TRACE
     ESP_LOGI("AUDIO_MEM", "realloc,new:%p, ptr:%p size:%d, called:0x%08x", p, ptr, size, (intptr_t)__builtin_return_address(0) - 2);
 #endif
@@ -96,6 +369,7 @@ char *audio_strdup(const char *str)
     if (copy) {
         strcpy(copy, str);
     }
+    AUDIO_MEM_PROFILE_ALLOC(copy, strlen(str) + 1);
 #ifdef ENABLE_AUDIO_MEM_TRACE
     ESP_LOGI("AUDIO_MEM", "strdup:%p, size:%d, called:0x%08x", copy, strlen(copy), (intptr_t)__builtin_return_address(0) - 2);
 #endif
@@ -127,6 +401,173 @@ void audio_mem_print(const char *tag, int line, const char *func)
 #endif
 }
 
+int audio_mem_pool_stats(int index, audio_mem_pool_stats_t *stats)
+{
+    if (index < 0 || index >= AUDIO_MEM_POOL_CLASSES) {
+        return -1;
+    }
+    portENTER_CRITICAL(&m_mem_pool_lock);
+    *stats = m_mem_pool[index].stats;
+    portEXIT_CRITICAL(&m_mem_pool_lock);
+    return 0;
+}
+
+void audio_mem_pool_print(const char *tag)
+{
+    audio_mem_pool_stats_t stats;
+
+    for (int i = 0; i < AUDIO_MEM_POOL_CLASSES; i++) {
+        audio_mem_pool_stats(i, &stats);
+        ESP_LOGI(tag, "Pool %3d B: used %d/%d, peak %d, allocs %u, heap fallbacks %u", stats.block_size,
+                 stats.used, stats.blocks, stats.peak, (unsigned)stats.allocs, (unsigned)stats.fallbacks);
+    }
+}
+
+int audio_mem_arena_init(audio_mem_arena_t *arena, size_t size, uint32_t caps)
+{
+    void *buf = heap_caps_malloc(size, caps | MALLOC_CAP_8BIT);
+    if (buf == NULL) {
+        memset(arena, 0, sizeof(*arena));
+        return -1;
+    }
+    audio_mem_arena_init_static(arena, buf, size);
+    arena->owned = true;
+    return 0;
+}
+
+void audio_mem_arena_init_static(audio_mem_arena_t *arena, void *buf, size_t size)
+{
+    uintptr_t start = ((uintptr_t)buf + AUDIO_MEM_ARENA_ALIGN - 1) & ~(uintptr_t)(AUDIO_MEM_ARENA_ALIGN - 1);
+
+    memset(arena, 0, sizeof(*arena));
+    arena->base = buf;
+    arena->size = size;
+    arena->used = start - (uintptr_t)buf < size ? start - (uintptr_t)buf : size;
+}
+
+void *audio_mem_arena_alloc(audio_mem_arena_t *arena, size_t size)
+{
+    void *data = NULL;
+    size_t need = (size + AUDIO_MEM_ARENA_ALIGN - 1) & ~(size_t)(AUDIO_MEM_ARENA_ALIGN - 1);
+
+    portENTER_CRITICAL(&m_mem_arena_lock);
+    if (size > 0 && need >= size && need <= arena->size - arena->used) {
+        data = arena->base + arena->used;
+        arena->used += need;
+        arena->allocs++;
+        if (arena->used > arena->peak) {
+            arena->peak = arena->used;
+        }
+    } else {
+        arena->failed++;
+    }
+    portEXIT_CRITICAL(&m_mem_arena_lock);
+
+    if (data) {
+        memset(data, 0, size);
+    }
+    return data;
+}
+
+void audio_mem_arena_reset(audio_mem_arena_t *arena)
+{
+    uintptr_t start = ((uintptr_t)arena->base + AUDIO_MEM_ARENA_ALIGN - 1) & ~(uintptr_t)(AUDIO_MEM_ARENA_ALIGN - 1);
+
+    portENTER_CRITICAL(&m_mem_arena_lock);
+    arena->used = start - (uintptr_t)arena->base < arena->size ? start - (uintptr_t)arena->base : arena->size;
+    arena->allocs = 0;
+    portEXIT_CRITICAL(&m_mem_arena_lock);
+}
+
+void audio_mem_arena_destroy(audio_mem_arena_t *arena)
+{
+    if (arena->owned) {
+        heap_caps_free(arena->base);
+    }
+    memset(arena, 0, sizeof(*arena));
+}
+
+void audio_mem_arena_print(const audio_mem_arena_t *arena, const char *tag)
+{
+    ESP_LOGI(tag, "Arena %p: used %d/%d B, peak %d B, allocs %u, failed %u", arena->base, (int)arena->used,
+             (int)arena->size, (int)arena->peak, (unsigned)arena->allocs, (unsigned)arena->failed);
+}
+
+audio_mem_arena_t *audio_mem_boot_arena(void)
+{
+    return &m_mem_boot_arena;
+}
+
+int audio_mem_profile_sites(audio_mem_site_t *sites, int max)
+{
+    int n = 0;
+#ifdef ENABLE_AUDIO_MEM_PROFILE
+    portENTER_CRITICAL(&m_mem_prof_lock);
+    for (int i = 0; i <= AUDIO_MEM_PROFILE_SITES && n < max; i++) {
+        if (m_mem_prof_site[i].allocs > 0) {
+            sites[n++] = m_mem_prof_site[i];
+        }
+    }
+    portEXIT_CRITICAL(&m_mem_prof_lock);
+#endif
+    return n;
+}
+
+int audio_mem_profile_events(audio_mem_event_t *events, int max)
+{
+    int n = 0;
+#ifdef ENABLE_AUDIO_MEM_PROFILE
+    uint32_t first;
+
+    portENTER_CRITICAL(&m_mem_prof_lock);
+    first = m_mem_prof_events > AUDIO_MEM_PROFILE_EVENTS ? m_mem_prof_events - AUDIO_MEM_PROFILE_EVENTS : 0;
+    if (m_mem_prof_events - first > (uint32_t)max) {
+        first = m_mem_prof_events - max;
+    }
+    for (uint32_t i = first; i != m_mem_prof_events; i++) {
+        events[n++] = m_mem_prof_event[i % AUDIO_MEM_PROFILE_EVENTS];
+    }
+    portEXIT_CRITICAL(&m_mem_prof_lock);
+#endif
+    return n;
+}
+
+void audio_mem_profile_dump(const char *tag)
+{
+#ifdef ENABLE_AUDIO_MEM_PROFILE
+    /* Copies, so the log output runs without the lock and allocations go on */
+    static audio_mem_site_t sites[AUDIO_MEM_PROFILE_SITES + 1];
+    static audio_mem_event_t events[AUDIO_MEM_PROFILE_EVENTS];
+    int n;
+
+    n = audio_mem_profile_sites(sites, AUDIO_MEM_PROFILE_SITES + 1);
+    ESP_LOGI(tag, "Alloc sites: %d, untracked allocations: %u", n, (unsigned)m_mem_prof_untracked);
+    for (int i = 0; i < n; i++) {
+        ESP_LOGI(tag, "  %p allocs %u frees %u live %d B peak %d B", sites[i].caller, (unsigned)sites[i].allocs,
+                 (unsigned)sites[i].frees, (int)sites[i].live_bytes, (int)sites[i].peak_bytes);
+    }
+    n = audio_mem_profile_events(events, AUDIO_MEM_PROFILE_EVENTS);
+    for (int i = 0; i < n; i++) {
+        ESP_LOGI(tag, "  %10u us %p %s %p %d B", (unsigned)events[i].t_us, events[i].caller,
+                 events[i].size >= 0 ? "alloc" : "free ", events[i].ptr, (int)events[i].size);
+    }
+#else
+    ESP_LOGI(tag, "Allocation profiler not built, define ENABLE_AUDIO_MEM_PROFILE");
+#endif
+}
+
+void audio_mem_profile_reset(void)
+{
+#ifdef ENABLE_AUDIO_MEM_PROFILE
+    portENTER_CRITICAL(&m_mem_prof_lock);
+    memset(m_mem_prof_site, 0, sizeof(m_mem_prof_site));
+    memset(m_mem_prof_live, 0, sizeof(m_mem_prof_live));
+    m_mem_prof_events = 0;
+    m_mem_prof_untracked = 0;
+    portEXIT_CRITICAL(&m_mem_prof_lock);
+#endif
+}
+
 #if defined (CONFIG_SPIRAM_BOOT_INIT)
 bool audio_mem_spiram_is_enabled(void)
 {
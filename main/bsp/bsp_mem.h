@@ -31,6 +31,101 @@
 extern "C" {
 #endif
 
+/*
+ * Size-class pools in front of the heap: audio_malloc/audio_calloc of up to
+ * AUDIO_MEM_POOL_MAX_SIZE bytes take a block of the smallest class that
+ * fits, in O(1) and under a spinlock instead of the heap lock. An exhausted
+ * class or a larger request falls back to the heap. Set a count to 0 to
+ * drop a class, all to 0 to disable the pools.
+ */
+#ifndef AUDIO_MEM_POOL_16_COUNT
+#define AUDIO_MEM_POOL_16_COUNT     32
+#endif
+#ifndef AUDIO_MEM_POOL_32_COUNT
+#define AUDIO_MEM_POOL_32_COUNT     16
+#endif
+#ifndef AUDIO_MEM_POOL_64_COUNT
+#define AUDIO_MEM_POOL_64_COUNT     8
+#endif
+#ifndef AUDIO_MEM_POOL_128_COUNT
+#define AUDIO_MEM_POOL_128_COUNT    8
+#endif
+
+#define AUDIO_MEM_POOL_CLASSES      4
+#define AUDIO_MEM_POOL_MAX_SIZE     128
+
+/*
+ * Allocation profiler, built with ENABLE_AUDIO_MEM_PROFILE: every
+ * allocation and free goes into a ring of recent events and is attributed
+ * to its call site (return address, resolve with addr2line) with live and
+ * peak bytes. Nothing is logged until audio_mem_profile_dump() is called.
+ */
+#ifndef AUDIO_MEM_PROFILE_EVENTS
+#define AUDIO_MEM_PROFILE_EVENTS    64      /* Recent events kept */
+#endif
+#ifndef AUDIO_MEM_PROFILE_SITES
+#define AUDIO_MEM_PROFILE_SITES     32      /* Call sites tracked, later ones count as "other" */
+#endif
+#ifndef AUDIO_MEM_PROFILE_LIVE
+#define AUDIO_MEM_PROFILE_LIVE      256     /* Live allocations tracked, a power of two */
+#endif
+
+/**
+ * @brief   Statistics of one size class
+ */
+typedef struct {
+    uint16_t block_size;    /*!< Bytes per block */
+    uint16_t blocks;        /*!< Blocks in the class */
+    uint16_t used;          /*!< Blocks handed out */
+    uint16_t peak;          /*!< Highest used */
+    uint32_t allocs;        /*!< Allocations served by the class */
+    uint32_t fallbacks;     /*!< Allocations of this class served by the heap, class exhausted */
+} audio_mem_pool_stats_t;
+
+/**
+ * @brief   One allocation or free seen by the profiler
+ */
+typedef struct {
+    uint32_t t_us;          /*!< esp_timer time, low 32 bits */
+    void *caller;           /*!< Return address of the audio_* call */
+    void *ptr;
+    int32_t size;           /*!< Bytes allocated, negative for a free */
+} audio_mem_event_t;
+
+/**
+ * @brief   Allocations of one call site
+ */
+typedef struct {
+    void *caller;           /*!< Return address, NULL for the sites past AUDIO_MEM_PROFILE_SITES */
+    uint32_t allocs;
+    uint32_t frees;
+    int32_t live_bytes;
+    int32_t peak_bytes;
+} audio_mem_site_t;
+
+/*
+ * Arenas for objects that live from init on: a bump pointer in one block,
+ * no per-object header, released all at once. The boot arena is static
+ * internal RAM so its layout is the same on every boot.
+ */
+#ifndef AUDIO_MEM_BOOT_ARENA_SIZE
+#define AUDIO_MEM_BOOT_ARENA_SIZE   1024
+#endif
+#define AUDIO_MEM_ARENA_ALIGN       8
+
+/**
+ * @brief   Arena state, fields are read-only for users
+ */
+typedef struct {
+    uint8_t *base;
+    size_t size;
+    size_t used;            /*!< Bytes handed out, alignment included */
+    size_t peak;
+    uint32_t allocs;
+    uint32_t failed;        /*!< Requests that did not fit */
+    bool owned;             /*!< base came from the heap, freed by audio_mem_arena_destroy */
+} audio_mem_arena_t;
+
 /**
  * @brief   Malloc memory in ADF
  *
@@ -131,6 +226,144 @@ bool audio_mem_spiram_is_enabled(void);
  */
 bool audio_mem_spiram_stack_is_enabled(void);
 
+/**
+ * @brief   Statistics of a size class
+ *
+ * @param[in]  index   class, 0 (16 bytes) .. AUDIO_MEM_POOL_CLASSES - 1
+ * @param[out] stats   copy of the statistics
+ *
+ * @return
+ *     - 0 on success
+ *     - -1 when the index is out of range
+ */
+int audio_mem_pool_stats(int index, audio_mem_pool_stats_t *stats);
+
+/**
+ * @brief   Log the statistics of every size class
+ *
+ * @param[in]  tag    tag of log
+ *
+ * @return
+ *     - void
+ */
+void audio_mem_pool_print(const char *tag);
+
+/**
+ * @brief   Copy the call site statistics
+ *
+ * @param[out] sites   room for max sites
+ * @param[in]  max     capacity of sites
+ *
+ * @return
+ *     - number of sites copied, 0 without ENABLE_AUDIO_MEM_PROFILE
+ */
+int audio_mem_profile_sites(audio_mem_site_t *sites, int max);
+
+/**
+ * @brief   Copy the recent events, oldest first
+ *
+ * @param[out] events  room for max events
+ * @param[in]  max     capacity of events
+ *
+ * @return
+ *     - number of events copied, 0 without ENABLE_AUDIO_MEM_PROFILE
+ */
+int audio_mem_profile_events(audio_mem_event_t *events, int max);
+
+/**
+ * @brief   Log the call sites and the recent events
+ *
+ * @param[in]  tag    tag of log
+ *
+ * @return
+ *     - void
+ */
+void audio_mem_profile_dump(const char *tag);
+
+/**
+ * @brief   Forget the events and the call sites, allocations already live are no longer tracked
+ *
+ * @return
+ *     - void
+ */
+void audio_mem_profile_reset(void);
+
+/**
+ * @brief   Create an arena in a block of the heap
+ *
+ * @param[out] arena  arena to set up
+ * @param[in]  size   bytes of the arena
+ * @param[in]  caps   heap capabilities of the block, e.g. MALLOC_CAP_INTERNAL or MALLOC_CAP_SPIRAM
+ *
+ * @return
+ *     - 0 on success
+ *     - -1 when the block could not be allocated
+ */
+int audio_mem_arena_init(audio_mem_arena_t *arena, size_t size, uint32_t caps);
+
+/**
+ * @brief   Create an arena in caller-provided memory, e.g. a static buffer
+ *
+ * @param[out] arena  arena to set up
+ * @param[in]  buf    memory of the arena
+ * @param[in]  size   bytes of buf
+ *
+ * @return
+ *     - void
+ */
+void audio_mem_arena_init_static(audio_mem_arena_t *arena, void *buf, size_t size);
+
+/**
+ * @brief   Take AUDIO_MEM_ARENA_ALIGN aligned, zeroed memory from an arena
+ *
+ * @param[in]  arena  arena
+ * @param[in]  size   bytes
+ *
+ * @return
+ *     - valid pointer on success
+ *     - NULL when the arena is full
+ */
+void *audio_mem_arena_alloc(audio_mem_arena_t *arena, size_t size);
+
+/**
+ * @brief   Release everything allocated from an arena, the arena memory is kept
+ *
+ * @param[in]  arena  arena
+ *
+ * @return
+ *     - void
+ */
+void audio_mem_arena_reset(audio_mem_arena_t *arena);
+
+/**
+ * @brief   Release an arena and give its block back to the heap
+ *
+ * @param[in]  arena  arena
+ *
+ * @return
+ *     - void
+ */
+void audio_mem_arena_destroy(audio_mem_arena_t *arena);
+
+/**
+ * @brief   Log the utilization of an arena
+ *
+ * @param[in]  arena  arena
+ * @param[in]  tag    tag of log
+ *
+ * @return
+ *     - void
+ */
+void audio_mem_arena_print(const audio_mem_arena_t *arena, const char *tag);
+
+/**
+ * @brief   Arena of the driver objects created at boot, AUDIO_MEM_BOOT_ARENA_SIZE bytes of static internal RAM
+ *
+ * @return
+ *     - the boot arena
+ */
+audio_mem_arena_t *audio_mem_boot_arena(void);
+
 #define AUDIO_MEM_SHOW(x)  audio_mem_print(x, __LINE__, __func__)
 
 #ifdef __cplusplus
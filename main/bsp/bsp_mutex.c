@@ -22,34 +22,204 @@
  *
  */
 
+#include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
 #include "bsp_mutex.h"
+#include "bsp_mem.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+
+/* Every mutex carries its statistics and sits in one registry for mutex_dump */
+typedef struct mutex_prof {
+    SemaphoreHandle_t sem;
+    mutex_stats_t stats;
+    int64_t locked_us;              /* Time of the current acquisition */
+    UBaseType_t ceiling;            /* 0: No priority ceiling */
+    UBaseType_t restore_prio;       /* Priority of the owner before the ceiling */
+    uint8_t raised;                 /* The owner runs at the ceiling */
+    struct mutex_prof *next;
+} mutex_prof_t;
+
+static mutex_prof_t *m_mutex_list;
+static portMUX_TYPE m_mutex_list_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static int m_mutex_take(mutex_prof_t *handle, TickType_t ticks);
 
 void *mutex_create(void)
 {
-    void *handle = NULL;
-    handle = xSemaphoreCreateMutex();
+    return mutex_create_named("mutex");
+}
+
+void *mutex_create_named(const char *name)
+{
+    mutex_prof_t *handle = audio_calloc(1, sizeof(mutex_prof_t));
+    if (handle == NULL) {
+        return NULL;
+    }
+    handle->sem = xSemaphoreCreateMutex();
+    if (handle->sem == NULL) {
+        audio_free(handle);
+        return NULL;
+    }
+    handle->stats.name = name;
+
+    portENTER_CRITICAL(&m_mutex_list_lock);
+    handle->next = m_mutex_list;
+    m_mutex_list = handle;
+    portEXIT_CRITICAL(&m_mutex_list_lock);
     return (void *) handle;
 }
 
 int mutex_destroy(void *mutex)
 {
-    vSemaphoreDelete((QueueHandle_t)mutex);
+    mutex_prof_t *handle = (mutex_prof_t *) mutex;
+    mutex_prof_t **link;
+
+    portENTER_CRITICAL(&m_mutex_list_lock);
+    for (link = &m_mutex_list; *link != NULL; link = &(*link)->next) {
+        if (*link == handle) {
+            *link = handle->next;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&m_mutex_list_lock);
+
+    vSemaphoreDelete(handle->sem);
+    audio_free(handle);
     return 0;
 }
 
 int mutex_lock(void *mutex)
 {
-    while (xSemaphoreTake((QueueHandle_t)mutex, portMAX_DELAY) != pdPASS);
+    return m_mutex_take((mutex_prof_t *) mutex, portMAX_DELAY);
+}
+
+int mutex_trylock(void *mutex)
+{
+    return m_mutex_take((mutex_prof_t *) mutex, 0);
+}
+
+int mutex_lock_timeout(void *mutex, uint32_t timeout_ms)
+{
+    TickType_t ticks = portMAX_DELAY;
+
+    if (timeout_ms != portMAX_DELAY) {
+        ticks = (timeout_ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+    }
+    return m_mutex_take((mutex_prof_t *) mutex, ticks);
+}
+
+int mutex_set_ceiling(void *mutex, UBaseType_t priority)
+{
+    ((mutex_prof_t *) mutex)->ceiling = priority;
     return 0;
 }
 
 int mutex_unlock(void *mutex)
 {
+    mutex_prof_t *handle = (mutex_prof_t *) mutex;
+    uint32_t hold_us = (uint32_t)(esp_timer_get_time() - handle->locked_us);
+    uint8_t raised = handle->raised;
+    UBaseType_t restore_prio = handle->restore_prio;
     int ret = 0;
-    ret = xSemaphoreGive((QueueHandle_t)mutex);
+
+    if (hold_us > handle->stats.hold_us_max) {
+        handle->stats.hold_us_max = hold_us;
+    }
+    handle->raised = 0;
+    ret = xSemaphoreGive(handle->sem);
+    /* Drop the ceiling only once released, a waiter up to the ceiling runs next */
+    if (raised) {
+        vTaskPrioritySet(NULL, restore_prio);
+    }
     return ret;
 }
+
+int mutex_get_stats(void *mutex, mutex_stats_t *stats)
+{
+    *stats = ((mutex_prof_t *) mutex)->stats;
+    return 0;
+}
+
+void mutex_dump(const char *tag)
+{
+    mutex_prof_t *handle;
+    mutex_stats_t stats;
+    int index = 0;
+
+    /* Walk the registry one entry at a time, logging runs outside the spinlock */
+    for (;;) {
+        portENTER_CRITICAL(&m_mutex_list_lock);
+        handle = m_mutex_list;
+        for (int i = 0; i < index && handle != NULL; i++) {
+            handle = handle->next;
+        }
+        if (handle != NULL) {
+            stats = handle->stats;
+        }
+        portEXIT_CRITICAL(&m_mutex_list_lock);
+        if (handle == NULL) {
+            break;
+        }
+        ESP_LOGI(tag, "Mutex %s: %u locks, %u contended, wait total %llu us max %u us, hold max %u us, last owner %s",
+                 stats.name, (unsigned)stats.acquisitions, (unsigned)stats.contended,
+                 (unsigned long long)stats.wait_us_total, (unsigned)stats.wait_us_max,
+                 (unsigned)stats.hold_us_max, stats.owner);
+        if (stats.timeouts) {
+            ESP_LOGW(tag, "Mutex %s: %u try/timed locks gave up", stats.name, (unsigned)stats.timeouts);
+        }
+        index++;
+    }
+}
+
+static int m_mutex_take(mutex_prof_t *handle, TickType_t ticks)
+{
+    int64_t start_us;
+    uint32_t wait_us = 0;
+    BaseType_t taken;
+    UBaseType_t prio;
+
+    /* The uncontended path costs one extra take attempt, no timestamp */
+    if (xSemaphoreTake(handle->sem, 0) != pdPASS) {
+        taken = pdFAIL;
+        if (ticks != 0) {
+            start_us = esp_timer_get_time();
+            do {
+                taken = xSemaphoreTake(handle->sem, ticks);
+            } while (taken != pdPASS && ticks == portMAX_DELAY);
+        }
+        if (taken != pdPASS) {
+            /* Not the owner, so the count goes under the registry lock */
+            portENTER_CRITICAL(&m_mutex_list_lock);
+            handle->stats.timeouts++;
+            portEXIT_CRITICAL(&m_mutex_list_lock);
+            return -1;
+        }
+        handle->locked_us = esp_timer_get_time();
+        wait_us = (uint32_t)(handle->locked_us - start_us);
+        handle->stats.contended++;
+    } else {
+        handle->locked_us = esp_timer_get_time();
+    }
+
+    /* Raise before anything else so no task below the ceiling delays the release */
+    if (handle->ceiling != 0) {
+        prio = uxTaskPriorityGet(NULL);
+        if (prio < handle->ceiling) {
+            handle->restore_prio = prio;
+            handle->raised = 1;
+            vTaskPrioritySet(NULL, handle->ceiling);
+        }
+    }
+
+    /* The statistics are only written by the owner */
+    handle->stats.acquisitions++;
+    handle->stats.wait_us_total += wait_us;
+    if (wait_us > handle->stats.wait_us_max) {
+        handle->stats.wait_us_max = wait_us;
+    }
+    strncpy(handle->stats.owner, pcTaskGetTaskName(NULL), sizeof(handle->stats.owner) - 1);
+    return 0;
+}
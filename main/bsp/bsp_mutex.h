@@ -33,6 +33,20 @@
 extern "C" {
 #endif
 
+/**
+ * @brief   Contention statistics of a mutex, times in microseconds
+ */
+typedef struct {
+    const char *name;
+    uint32_t acquisitions;
+    uint32_t contended;             /*!< Acquisitions that had to wait */
+    uint32_t timeouts;              /*!< Try and timed locks that gave up */
+    uint64_t wait_us_total;
+    uint32_t wait_us_max;
+    uint32_t hold_us_max;
+    char owner[configMAX_TASK_NAME_LEN];  /*!< Task of the last acquisition */
+} mutex_stats_t;
+
 /**
  * @brief       Create a mutex instance
  *
@@ -41,6 +55,14 @@ extern "C" {
  */
 void *mutex_create(void);
 
+/**
+ * @brief       Create a mutex instance with a name for the statistics
+ * @param       name        Name shown by mutex_dump, kept by reference
+ * @return      - Others:      A mutex handle is returned
+ *              - NULL:         Failed to create mutex
+ */
+void *mutex_create_named(const char *name);
+
 /**
  * @brief       Delete the mutex instance
  *
@@ -59,6 +81,41 @@ int mutex_destroy(void *mutex);
  */
 int mutex_lock(void *mutex);
 
+/**
+ * @brief       Take the mutex if it is free, without waiting
+ *
+ * @param       mutex        The pointer to mutex handle
+ *
+ * @return      - 0:        The lock was obtained
+ *              - -1:       The mutex is held by another task
+ */
+int mutex_trylock(void *mutex);
+
+/**
+ * @brief       Take the mutex, waiting at most timeout_ms
+ *
+ * @param       mutex        The pointer to mutex handle
+ * @param       timeout_ms   Longest wait, rounded up to ticks, portMAX_DELAY waits forever
+ *
+ * @return      - 0:        The lock was obtained
+ *              - -1:       Timed out
+ */
+int mutex_lock_timeout(void *mutex, uint32_t timeout_ms);
+
+/**
+ * @brief       Set the priority ceiling of the mutex. A task that takes the mutex
+ *              runs at least at the ceiling until it releases it, so no task up to
+ *              the ceiling preempts the holder. Use the priority of the most urgent
+ *              task that takes the mutex; ceiling locks must be released in reverse
+ *              order of taking.
+ *
+ * @param       mutex        The pointer to mutex handle
+ * @param       priority     Ceiling, 0 to disable
+ *
+ * @return      - 0:           Success
+ */
+int mutex_set_ceiling(void *mutex, UBaseType_t priority);
+
 /**
  * @brief       Release the mutex
  *
@@ -68,6 +125,20 @@ int mutex_lock(void *mutex);
  */
 int mutex_unlock(void *mutex);
 
+/**
+ * @brief       Copy the statistics of a mutex, the copy can be torn while the mutex is in use
+ * @param       mutex        The pointer to mutex handle
+ * @param       stats        Copy of the statistics
+ * @return      - 0:           Success
+ */
+int mutex_get_stats(void *mutex, mutex_stats_t *stats);
+
+/**
+ * @brief       Log the statistics of every mutex
+ * @param       tag          Tag of log
+ */
+void mutex_dump(const char *tag);
+
 #ifdef __cplusplus
 }
 #endif
@@ -29,6 +29,8 @@
 #include "bsp_mutex.h"
 #include "bsp_mem.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
 
 #define ESP_INTR_FLG_DEFAULT  (0)
 #define ESP_I2C_MASTER_BUF_LEN  (0)
@@ -47,8 +49,160 @@ typedef struct {
 static const char *TAG = "I2C_BUS";
 
 static i2c_bus_t *i2c_bus[I2C_NUM_MAX];
+static i2c_bus_t *i2c_bus_mem[I2C_NUM_MAX];  /*!< Boot arena objects, reused by the create after a delete */
 
-static xSemaphoreHandle _busLock;
+#define I2C_BUS_CLASS_TASKS  8   /*!< Tasks with a class other than I2C_BUS_NORMAL */
+
+typedef struct {
+    TaskHandle_t task;
+    i2c_bus_class_t cls;
+} i2c_bus_task_class_t;
+
+/* A transfer waiting for the bus, on the stack of its task */
+typedef struct i2c_bus_waiter {
+    TaskHandle_t task;
+    struct i2c_bus_waiter *next;
+    volatile uint8_t granted;        /*!< Set by the hand-off, the task owns the bus */
+} i2c_bus_waiter_t;
+
+static void *_busLock;
+static uint32_t _busLockTimeoutMs = portMAX_DELAY;  /*!< Kept across the re-create of a bus recovery */
+static UBaseType_t _busLockCeiling;
+
+/* Scheduler state: the owner flag, a FIFO of waiters per class, the class of each task and the wait statistics */
+static portMUX_TYPE _busSchedLock = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t _busHeld;             /*!< A transfer owns the bus, the queues are empty while clear */
+static i2c_bus_waiter_t *_busHead[I2C_BUS_CLASS_MAX];
+static i2c_bus_waiter_t *_busTail[I2C_BUS_CLASS_MAX];
+static i2c_bus_task_class_t _busTaskClass[I2C_BUS_CLASS_TASKS];
+static i2c_bus_class_stats_t _busStats[I2C_BUS_CLASS_MAX];
+static const char *const _busClassName[I2C_BUS_CLASS_MAX] = { "urgent", "normal", "bulk" };
+
+static i2c_bus_class_t _i2c_bus_task_class(TaskHandle_t task)
+{
+    i2c_bus_class_t cls = I2C_BUS_NORMAL;
+
+    for (int i = 0; i < I2C_BUS_CLASS_TASKS; i++) {
+        if (_busTaskClass[i].task == task) {
+            cls = _busTaskClass[i].cls;
+            break;
+        }
+    }
+    return cls;
+}
+
+/* Called with _busSchedLock held */
+static void _i2c_bus_dequeue(i2c_bus_class_t cls, i2c_bus_waiter_t *waiter)
+{
+    i2c_bus_waiter_t **link = &_busHead[cls];
+    i2c_bus_waiter_t *prev = NULL;
+
+    while (*link != NULL && *link != waiter) {
+        prev = *link;
+        link = &(*link)->next;
+    }
+    if (*link == NULL) {
+        return;
+    }
+    *link = waiter->next;
+    if (_busTail[cls] == waiter) {
+        _busTail[cls] = prev;
+    }
+}
+
+/*
+ * The bus goes to the caller at once if it is free, otherwise the caller joins
+ * the queue of its class and sleeps until the owner hands the bus over. The
+ * unlock gives it to the oldest waiter of the most urgent class, so an urgent
+ * transfer waits only for the transfer in progress, whatever is queued. The
+ * waiters do not block on _busLock, its ceiling keeps the owner from being
+ * preempted by tasks up to the most urgent one.
+ */
+static esp_err_t _i2c_bus_lock(void)
+{
+    TickType_t start = xTaskGetTickCount();
+    TickType_t limit = _busLockTimeoutMs == portMAX_DELAY ? portMAX_DELAY
+                       : (_busLockTimeoutMs + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+    TickType_t elapsed;
+    int64_t start_us = esp_timer_get_time();
+    uint32_t wait_us;
+    i2c_bus_waiter_t self = { .task = xTaskGetCurrentTaskHandle() };
+    i2c_bus_class_t cls;
+
+    portENTER_CRITICAL(&_busSchedLock);
+    cls = _i2c_bus_task_class(self.task);
+    if (!_busHeld) {
+        _busHeld = 1;
+        self.granted = 1;
+    } else if (_busTail[cls] != NULL) {
+        _busTail[cls]->next = &self;
+        _busTail[cls] = &self;
+    } else {
+        _busHead[cls] = _busTail[cls] = &self;
+    }
+    portEXIT_CRITICAL(&_busSchedLock);
+
+    /* A notification without the grant is stale, left by a hand-off that raced a timeout */
+    while (!self.granted) {
+        elapsed = xTaskGetTickCount() - start;
+        if (limit != portMAX_DELAY && elapsed >= limit) {
+            break;
+        }
+        ulTaskNotifyTake(pdTRUE, limit == portMAX_DELAY ? portMAX_DELAY : limit - elapsed);
+    }
+    wait_us = (uint32_t)(esp_timer_get_time() - start_us);
+
+    /* The grant is final once read here, a hand-off after the timeout still counts */
+    portENTER_CRITICAL(&_busSchedLock);
+    _busStats[cls].requests++;
+    if (!self.granted) {
+        _i2c_bus_dequeue(cls, &self);
+        _busStats[cls].timeouts++;
+    } else {
+        _busStats[cls].wait_us_total += wait_us;
+        if (wait_us > _busStats[cls].wait_us_max) {
+            _busStats[cls].wait_us_max = wait_us;
+        }
+    }
+    portEXIT_CRITICAL(&_busSchedLock);
+
+    if (!self.granted) {
+        ESP_LOGW(TAG, "Bus busy for %u ms, %s transfer dropped", (unsigned)_busLockTimeoutMs, _busClassName[cls]);
+        return I2C_BUS_ERR_BUSY;
+    }
+    /* Free once handed over, taken for its ceiling and contention statistics */
+    mutex_lock(_busLock);
+    return ESP_OK;
+}
+
+/*
+ * Release the bus and hand it to the oldest waiter of the most urgent class.
+ */
+static void _i2c_bus_unlock(void)
+{
+    TaskHandle_t next = NULL;
+    i2c_bus_waiter_t *waiter;
+
+    mutex_unlock(_busLock);
+
+    portENTER_CRITICAL(&_busSchedLock);
+    for (int c = 0; c < I2C_BUS_CLASS_MAX && next == NULL; c++) {
+        waiter = _busHead[c];
+        if (waiter != NULL) {
+            _i2c_bus_dequeue((i2c_bus_class_t)c, waiter);
+            next = waiter->task;
+            waiter->granted = 1;
+        }
+    }
+    if (next == NULL) {
+        _busHeld = 0;
+    }
+    portEXIT_CRITICAL(&_busSchedLock);
+
+    if (next != NULL) {
+        xTaskNotifyGive(next);
+    }
+}
 
 i2c_bus_handle_t i2c_bus_create(i2c_port_t port, i2c_config_t *conf)
 {
@@ -59,7 +213,11 @@ i2c_bus_handle_t i2c_bus_create(i2c_port_t port, i2c_config_t *conf)
         ESP_LOGW(TAG, "I2C bus has been already created, [port:%d] %s:%d:", port, __FUNCTION__, __LINE__);
         return i2c_bus[port];
     }
-    i2c_bus[port] = (i2c_bus_t *) audio_calloc(1, sizeof(i2c_bus_t));
+    if (i2c_bus_mem[port] == NULL) {
+        i2c_bus_mem[port] = (i2c_bus_t *) audio_mem_arena_alloc(audio_mem_boot_arena(), sizeof(i2c_bus_t));
+        I2C_BUS_CHECK(i2c_bus_mem[port] != NULL, "Boot arena full", NULL);
+    }
+    i2c_bus[port] = i2c_bus_mem[port];
     i2c_bus[port]->i2c_conf = *conf;
     i2c_bus[port]->i2c_port = port;
     esp_err_t ret = i2c_param_config(i2c_bus[port]->i2c_port, &i2c_bus[port]->i2c_conf);
@@ -74,15 +232,14 @@ i2c_bus_handle_t i2c_bus_create(i2c_port_t port, i2c_config_t *conf)
     if (_busLock) {
         mutex_destroy(_busLock);
     }
-    _busLock = mutex_create();
+    _busLock = mutex_create_named("i2c_bus");
+    mutex_set_ceiling(_busLock, _busLockCeiling);
 
     return (i2c_bus_handle_t) i2c_bus[port];
 
 error:
     ESP_LOGE(TAG, "i2c_bus_create() i2c_driver_install: goto error");
-    if (i2c_bus[port]) {
-        audio_free(i2c_bus[port]);
-    }
+    i2c_bus[port] = NULL;
     return NULL;
 }
 
@@ -93,7 +250,10 @@ esp_err_t i2c_bus_write_bytes(i2c_bus_handle_t bus, int addr, uint8_t *reg, int
     I2C_BUS_CHECK(p_bus->i2c_port < I2C_NUM_MAX, "I2C port error", ESP_FAIL);
     I2C_BUS_CHECK(data != NULL, "Not initialized input data pointer", ESP_FAIL);
     esp_err_t ret = ESP_OK;
-    mutex_lock(_busLock);
+    ret = _i2c_bus_lock();
+    if (ret != ESP_OK) {
+        return ret;
+    }
     i2c_cmd_handle_t cmd = i2c_cmd_link_create();
     ret |= i2c_master_start(cmd);
     ret |= i2c_master_write_byte(cmd, addr, 1);
@@ -102,7 +262,7 @@ esp_err_t i2c_bus_write_bytes(i2c_bus_handle_t bus, int addr, uint8_t *reg, int
     ret |= i2c_master_stop(cmd);
     ret |= i2c_master_cmd_begin(p_bus->i2c_port, cmd, 1000 / portTICK_RATE_MS);
     i2c_cmd_link_delete(cmd);
-    mutex_unlock(_busLock);
+    _i2c_bus_unlock();
     I2C_BUS_CHECK(ret == 0, "I2C Bus WriteReg Error", ESP_FAIL);
     return ret;
 }
@@ -114,7 +274,10 @@ esp_err_t i2c_bus_write_data(i2c_bus_handle_t bus, int addr, uint8_t *data, int
     I2C_BUS_CHECK(p_bus->i2c_port < I2C_NUM_MAX, "I2C port error", ESP_FAIL);
     I2C_BUS_CHECK(data != NULL, "Not initialized input data pointer", ESP_FAIL);
     esp_err_t ret = ESP_OK;
-    mutex_lock(_busLock);
+    ret = _i2c_bus_lock();
+    if (ret != ESP_OK) {
+        return ret;
+    }
     i2c_cmd_handle_t cmd = i2c_cmd_link_create();
     ret |= i2c_master_start(cmd);
     ret |= i2c_master_write_byte(cmd, addr, 1);
@@ -122,7 +285,7 @@ esp_err_t i2c_bus_write_data(i2c_bus_handle_t bus, int addr, uint8_t *data, int
     ret |= i2c_master_stop(cmd);
     ret |= i2c_master_cmd_begin(p_bus->i2c_port, cmd, 1000 / portTICK_RATE_MS);
     i2c_cmd_link_delete(cmd);
-    mutex_unlock(_busLock);
+    _i2c_bus_unlock();
     I2C_BUS_CHECK(ret == 0, "I2C Bus WriteReg Error", ESP_FAIL);
     return ret;
 }
@@ -134,7 +297,10 @@ esp_err_t i2c_bus_read_bytes(i2c_bus_handle_t bus, int addr, uint8_t *reg, int r
     I2C_BUS_CHECK(p_bus->i2c_port < I2C_NUM_MAX, "I2C port error", ESP_FAIL);
     I2C_BUS_CHECK(outdata != NULL, "Not initialized output data buffer pointer", ESP_FAIL);
     esp_err_t ret = ESP_OK;
-    mutex_lock(_busLock);
+    ret = _i2c_bus_lock();
+    if (ret != ESP_OK) {
+        return ret;
+    }
     i2c_cmd_handle_t cmd;
     cmd = i2c_cmd_link_create();
     ret |= i2c_master_start(cmd);
@@ -157,18 +323,80 @@ esp_err_t i2c_bus_read_bytes(i2c_bus_handle_t bus, int addr, uint8_t *reg, int r
     ret = i2c_master_cmd_begin(p_bus->i2c_port, cmd, 1000 / portTICK_RATE_MS);
     i2c_cmd_link_delete(cmd);
 
-    mutex_unlock(_busLock);
+    _i2c_bus_unlock();
     I2C_BUS_CHECK(ret == 0, "I2C Bus ReadReg Error", ESP_FAIL);
     return ret;
 }
 
+esp_err_t i2c_bus_set_lock(i2c_bus_handle_t bus, uint32_t timeout_ms, UBaseType_t ceiling)
+{
+    I2C_BUS_CHECK(bus != NULL, "Handle error", ESP_FAIL);
+    _busLockTimeoutMs = timeout_ms;
+    _busLockCeiling = ceiling;
+    mutex_set_ceiling(_busLock, ceiling);
+    return ESP_OK;
+}
+
+i2c_bus_class_t i2c_bus_set_class(i2c_bus_class_t cls)
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    i2c_bus_class_t prev;
+    int slot = -1;
+
+    I2C_BUS_CHECK(cls < I2C_BUS_CLASS_MAX, "Class error", I2C_BUS_NORMAL);
+    portENTER_CRITICAL(&_busSchedLock);
+    prev = _i2c_bus_task_class(task);
+    for (int i = 0; i < I2C_BUS_CLASS_TASKS; i++) {
+        if (_busTaskClass[i].task == task) {
+            slot = i;
+            break;
+        }
+        if (slot < 0 && _busTaskClass[i].task == NULL) {
+            slot = i;
+        }
+    }
+    if (slot >= 0) {
+        /* NORMAL is the default, it frees the entry */
+        _busTaskClass[slot].task = cls == I2C_BUS_NORMAL ? NULL : task;
+        _busTaskClass[slot].cls = cls;
+    }
+    portEXIT_CRITICAL(&_busSchedLock);
+
+    if (slot < 0) {
+        ESP_LOGE(TAG, "No room for the class of %s, it stays %s", pcTaskGetTaskName(NULL), _busClassName[prev]);
+    }
+    return prev;
+}
+
+esp_err_t i2c_bus_get_stats(i2c_bus_class_t cls, i2c_bus_class_stats_t *stats)
+{
+    I2C_BUS_CHECK(cls < I2C_BUS_CLASS_MAX, "Class error", ESP_FAIL);
+    I2C_BUS_CHECK(stats != NULL, "Stats pointer error", ESP_FAIL);
+    portENTER_CRITICAL(&_busSchedLock);
+    *stats = _busStats[cls];
+    portEXIT_CRITICAL(&_busSchedLock);
+    return ESP_OK;
+}
+
+void i2c_bus_dump_stats(const char *tag)
+{
+    i2c_bus_class_stats_t stats;
+
+    for (int cls = 0; cls < I2C_BUS_CLASS_MAX; cls++) {
+        i2c_bus_get_stats(cls, &stats);
+        ESP_LOGI(tag, "I2C %s: %u transfers, %u timed out, wait avg %u us max %u us", _busClassName[cls],
+                 (unsigned)stats.requests, (unsigned)stats.timeouts,
+                 (unsigned)(stats.requests > stats.timeouts ? stats.wait_us_total / (stats.requests - stats.timeouts) : 0),
+                 (unsigned)stats.wait_us_max);
+    }
+}
+
 esp_err_t i2c_bus_delete(i2c_bus_handle_t bus)
 {
     I2C_BUS_CHECK(bus != NULL, "Handle error", ESP_FAIL);
     i2c_bus_t *p_bus = (i2c_bus_t *) bus;
     i2c_driver_delete(p_bus->i2c_port);
     i2c_bus[p_bus->i2c_port] = NULL;
-    audio_free(p_bus);
     mutex_destroy(_busLock);
 
     _busLock = NULL;
@@ -32,6 +32,34 @@ extern "C" {
 
 typedef void *i2c_bus_handle_t;
 
+/**
+ * @brief Returned by a transfer that did not get the bus lock in time, the bus was not touched.
+ *        Driver errors of the transfer itself, a stuck bus included, return ESP_FAIL.
+ */
+#define I2C_BUS_ERR_BUSY    (ESP_ERR_INVALID_STATE)
+
+/**
+ * @brief Scheduling class of the transfers of a task. A released bus goes to the oldest
+ *        waiting transfer of the most urgent class, so fault service is not queued behind
+ *        telemetry: it waits at most for the transfer in progress.
+ */
+typedef enum {
+    I2C_BUS_URGENT = 0,      /*!< Fault interrupt service, rail control, watchdog clear */
+    I2C_BUS_NORMAL,          /*!< Default of every task */
+    I2C_BUS_BULK,            /*!< Telemetry and register dumps */
+    I2C_BUS_CLASS_MAX,
+} i2c_bus_class_t;
+
+/**
+ * @brief Bus lock statistics of a class, waits in microseconds
+ */
+typedef struct {
+    uint32_t requests;
+    uint32_t timeouts;       /*!< Transfers that did not get the bus in time */
+    uint64_t wait_us_total;  /*!< From the request to the hand-off, over the transfers that got the bus */
+    uint32_t wait_us_max;
+} i2c_bus_class_stats_t;
+
 /**
  * @brief Create and init I2C bus and return a I2C bus handle
  *
@@ -89,6 +117,49 @@ esp_err_t i2c_bus_write_data(i2c_bus_handle_t bus, int addr, uint8_t *data, int
  */
 esp_err_t i2c_bus_read_bytes(i2c_bus_handle_t bus, int addr, uint8_t *reg, int reglen, uint8_t *outdata, int datalen);
 
+/**
+ * @brief Bound the wait for the bus lock and set its priority ceiling, kept until changed
+ *
+ * @param bus        I2C bus handle
+ * @param timeout_ms Longest wait of a transfer for the bus, it returns I2C_BUS_ERR_BUSY
+ *                   after it without touching the bus. portMAX_DELAY waits forever
+ * @param ceiling    Priority of the most urgent task on the bus, 0 for none
+ *
+ * @return
+ *     - ESP_OK Success
+ *     - ESP_FAIL Handle error
+ */
+esp_err_t i2c_bus_set_lock(i2c_bus_handle_t bus, uint32_t timeout_ms, UBaseType_t ceiling);
+
+/**
+ * @brief Set the class of the transfers of the calling task, restore the returned one when done
+ *
+ * @param cls        Class of the next transfers
+ *
+ * @return
+ *     - The previous class of the task
+ */
+i2c_bus_class_t i2c_bus_set_class(i2c_bus_class_t cls);
+
+/**
+ * @brief Copy the bus lock statistics of a class
+ *
+ * @param cls        Class
+ * @param stats      Copy of the statistics
+ *
+ * @return
+ *     - ESP_OK Success
+ *     - ESP_FAIL Parameter error
+ */
+esp_err_t i2c_bus_get_stats(i2c_bus_class_t cls, i2c_bus_class_stats_t *stats);
+
+/**
+ * @brief Log the bus lock statistics of every class
+ *
+ * @param tag        Tag of log
+ */
+void i2c_bus_dump_stats(const char *tag);
+
 /**
  * @brief Delete and release the I2C bus object
  *
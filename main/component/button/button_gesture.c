@@ -0,0 +1,185 @@
+/*
+ * button_gesture.c
+ *
+ *  Button gesture recognizer: single, double, triple and long press.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include <stddef.h>
+#include "button_gesture.h"
+
+/* Private defines ---------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------- */
+enum
+{
+   M_IDLE = 0,    //Nothing in progress
+   M_PRESSED,     //Held, long press deadline running
+   M_RELEASED,    //Between clicks, gap deadline running
+   M_LONG,        //Long press reported, waiting for the release
+};
+
+/* Private macros ----------------------------------------------------- */
+/* Timestamps may wrap, compare through the signed difference */
+#define M_REACHED(t, deadline)   ((int32_t)((t) - (deadline)) >= 0)
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+static const button_gesture_cfg_t m_default_cfg =
+{
+   .debounce_ms = BUTTON_GESTURE_DEBOUNCE_MS,
+   .gap_ms      = BUTTON_GESTURE_GAP_MS,
+   .long_ms     = BUTTON_GESTURE_LONG_MS,
+   .max_clicks  = BUTTON_GESTURE_TRIPLE,
+};
+
+/* Private function prototypes ---------------------------------------- */
+static uint8_t m_button_gesture_deadline(const button_gesture_t *b, uint32_t *deadline);
+
+/* Function definitions ----------------------------------------------- */
+
+/**
+  * @brief  Reset a recognizer
+  *
+  * @param  b    recognizer.(ptr)
+  * @param  cfg  timing, NULL for the BUTTON_GESTURE_* defaults.(ptr)
+  *
+  */
+void button_gesture_init(button_gesture_t *b, const button_gesture_cfg_t *cfg)
+{
+   *b = (button_gesture_t){0};
+   b->cfg = cfg != NULL ? *cfg : m_default_cfg;
+
+   if(b->cfg.max_clicks < BUTTON_GESTURE_SINGLE || b->cfg.max_clicks > BUTTON_GESTURE_TRIPLE)
+   {
+      b->cfg.max_clicks = BUTTON_GESTURE_TRIPLE;
+   }
+}
+
+/**
+  * @brief  Feed an edge. A deadline that passed before the edge is handled
+  *         first, so an edge that arrives late still ends the right gesture.
+  *         Repeated edges of the same level are ignored.
+  *
+  * @param  b        recognizer.(ptr)
+  * @param  pressed  1: press, 0: release.
+  * @param  t_ms     time of the edge.
+  * @retval          gesture completed by this edge, BUTTON_GESTURE_NONE otherwise
+  *
+  */
+button_gesture_event_t button_gesture_edge(button_gesture_t *b, uint8_t pressed, uint32_t t_ms)
+{
+   button_gesture_event_t event = button_gesture_poll(b, t_ms);
+
+   if(pressed)
+   {
+      if(b->state == M_IDLE)
+      {
+         b->clicks = 0;
+         b->press_ms = t_ms;
+         b->state = M_PRESSED;
+      }
+      else if(b->state == M_RELEASED)
+      {
+         if(t_ms - b->release_ms < b->cfg.debounce_ms)
+         {
+            b->clicks--;   //Contact bounce, the previous press goes on
+         }
+         else
+         {
+            b->press_ms = t_ms;
+         }
+         b->state = M_PRESSED;
+      }
+   }
+   else
+   {
+      if(b->state == M_PRESSED)
+      {
+         b->clicks++;
+         b->release_ms = t_ms;
+         b->state = M_RELEASED;
+      }
+      else if(b->state == M_LONG)
+      {
+         b->state = M_IDLE;
+      }
+   }
+
+   return event;
+}
+
+/**
+  * @brief  Report the gesture whose deadline has passed: a press held for
+  *         long_ms, or clicks followed by a release longer than gap_ms
+  *         (debounce_ms once max_clicks is reached).
+  *
+  * @param  b     recognizer.(ptr)
+  * @param  t_ms  current time.
+  * @retval       completed gesture, BUTTON_GESTURE_NONE otherwise
+  *
+  */
+button_gesture_event_t button_gesture_poll(button_gesture_t *b, uint32_t t_ms)
+{
+   uint32_t deadline;
+
+   if(!m_button_gesture_deadline(b, &deadline) || !M_REACHED(t_ms, deadline))
+   {
+      return BUTTON_GESTURE_NONE;
+   }
+
+   if(b->state == M_PRESSED)
+   {
+      b->state = M_LONG;
+      return BUTTON_GESTURE_LONG;
+   }
+
+   b->state = M_IDLE;
+   return (button_gesture_event_t)b->clicks;
+}
+
+/**
+  * @brief  Time the caller may sleep if no edge arrives
+  *
+  * @param  b     recognizer.(ptr)
+  * @param  t_ms  current time.
+  * @retval       ms until the next deadline, 0 if it already passed,
+  *               BUTTON_GESTURE_NO_TIMEOUT if none is pending
+  *
+  */
+uint32_t button_gesture_timeout(const button_gesture_t *b, uint32_t t_ms)
+{
+   uint32_t deadline;
+
+   if(!m_button_gesture_deadline(b, &deadline))
+   {
+      return BUTTON_GESTURE_NO_TIMEOUT;
+   }
+
+   return M_REACHED(t_ms, deadline) ? 0 : deadline - t_ms;
+}
+
+/* Private function definitions ---------------------------------------- */
+/**
+  * @brief  Deadline of the current state
+  *
+  * @param  b         recognizer.(ptr)
+  * @param  deadline  time the state ends without an edge.(ptr)
+  * @retval           0: no deadline, 1: deadline set
+  *
+  */
+static uint8_t m_button_gesture_deadline(const button_gesture_t *b, uint32_t *deadline)
+{
+   if(b->state == M_PRESSED)
+   {
+      *deadline = b->press_ms + b->cfg.long_ms;
+      return 1;
+   }
+
+   if(b->state == M_RELEASED)
+   {
+      *deadline = b->release_ms + (b->clicks >= b->cfg.max_clicks ? b->cfg.debounce_ms : b->cfg.gap_ms);
+      return 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,81 @@
+/*
+ * button_gesture.h
+ *
+ *  Button gesture recognizer fed by timestamped press / release edges.
+ *  It never waits itself: the caller sleeps until the next edge or until
+ *  button_gesture_timeout() expires and then calls button_gesture_poll().
+ */
+
+#ifndef MAIN_COMPONENT_BUTTON_GESTURE_H_
+#define MAIN_COMPONENT_BUTTON_GESTURE_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+
+/* Public defines ----------------------------------------------------- */
+#define BUTTON_GESTURE_NO_TIMEOUT   UINT32_MAX  //No deadline pending, wait for the next edge
+
+#define BUTTON_GESTURE_DEBOUNCE_MS  30          //Defaults used by button_gesture_init(b, NULL)
+#define BUTTON_GESTURE_GAP_MS       300
+#define BUTTON_GESTURE_LONG_MS      1000
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief  Recognized gestures, the value is the number of clicks
+ */
+typedef enum
+{
+   BUTTON_GESTURE_NONE   = 0,
+   BUTTON_GESTURE_SINGLE = 1,
+   BUTTON_GESTURE_DOUBLE = 2,
+   BUTTON_GESTURE_TRIPLE = 3,
+   BUTTON_GESTURE_LONG   = 4,
+} button_gesture_event_t;
+
+/**
+ * @brief  Timing of one button
+ */
+typedef struct
+{
+   uint32_t debounce_ms;   //A press this soon after a release continues the previous press
+   uint32_t gap_ms;        //Longest release between the clicks of one gesture
+   uint32_t long_ms;       //Hold time of a long press
+   uint8_t  max_clicks;    //Clicks that end a gesture without waiting for gap_ms, 1..3
+} button_gesture_cfg_t;
+
+/**
+ * @brief  Recognizer state, one per button
+ */
+typedef struct
+{
+   button_gesture_cfg_t cfg;
+   uint8_t  state;
+   uint8_t  clicks;        //Completed clicks of the gesture in progress
+   uint32_t press_ms;      //Start of the current press
+   uint32_t release_ms;    //End of the last click
+} button_gesture_t;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+  * @brief  Reset a recognizer, cfg NULL selects the defaults
+ */
+void button_gesture_init(button_gesture_t *b, const button_gesture_cfg_t *cfg);
+
+/**
+  * @brief  Feed a press (pressed = 1) or release (pressed = 0) edge
+ */
+button_gesture_event_t button_gesture_edge(button_gesture_t *b, uint8_t pressed, uint32_t t_ms);
+
+/**
+  * @brief  Report a gesture whose deadline has passed
+ */
+button_gesture_event_t button_gesture_poll(button_gesture_t *b, uint32_t t_ms);
+
+/**
+  * @brief  Milliseconds until button_gesture_poll() can report something
+ */
+uint32_t button_gesture_timeout(const button_gesture_t *b, uint32_t t_ms);
+
+
+#endif /* MAIN_COMPONENT_BUTTON_GESTURE_H_ */
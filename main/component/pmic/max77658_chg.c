@@ -0,0 +1,145 @@
+/*
+ * max77658_chg.c
+ *
+ *  Charger state of the MAX77658.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "max77658_chg.h"
+
+/* Private defines ---------------------------------------------------- */
+#define MAX77658_CHG_REGS   3   //INT_CHG, STAT_CHG_A, STAT_CHG_B
+
+_Static_assert(MAX77658_PM_ADDR_STAT_CHG_A == MAX77658_PM_ADDR_INT_CHG + 1 && MAX77658_PM_ADDR_STAT_CHG_B == MAX77658_PM_ADDR_INT_CHG + 2,
+               "charger status block is not contiguous");
+
+/* Private enumerate/structure ---------------------------------------- */
+/* Private macros ----------------------------------------------------- */
+#define SUCCESS   0
+#define ERROR     -1
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+/* CHG_DTLS -> state, JEITA variant */
+static const uint8_t m_chg_dtls[16][2] =
+{
+   { MAX77658_CHG_OFF,                 0 },  //0b0000
+   { MAX77658_CHG_PREQUAL,             0 },  //0b0001
+   { MAX77658_CHG_FAST_CC,             0 },  //0b0010
+   { MAX77658_CHG_FAST_CC,             1 },  //0b0011
+   { MAX77658_CHG_FAST_CV,             0 },  //0b0100
+   { MAX77658_CHG_FAST_CV,             1 },  //0b0101
+   { MAX77658_CHG_TOP_OFF,             0 },  //0b0110
+   { MAX77658_CHG_TOP_OFF,             1 },  //0b0111
+   { MAX77658_CHG_DONE,                0 },  //0b1000
+   { MAX77658_CHG_DONE,                1 },  //0b1001
+   { MAX77658_CHG_FAULT_PREQUAL_TIMER, 0 },  //0b1010
+   { MAX77658_CHG_FAULT_FAST_TIMER,    0 },  //0b1011
+   { MAX77658_CHG_FAULT_TEMP,          0 },  //0b1100
+   { MAX77658_CHG_UNKNOWN,             0 },
+   { MAX77658_CHG_UNKNOWN,             0 },
+   { MAX77658_CHG_UNKNOWN,             0 },
+};
+
+/* Private function prototypes ---------------------------------------- */
+/* Function definitions ----------------------------------------------- */
+
+/**
+  * @brief  Reset the tracker
+  *
+  * @param  chg  tracker.(ptr)
+  * @param  pm   PM interface.(ptr)
+  *
+  */
+void max77658_chg_init(max77658_chg_t *chg, max77658_pm_t *pm)
+{
+   *chg = (max77658_chg_t){0};
+   chg->pm = pm;
+}
+
+/**
+  * @brief  Decode the charger status registers
+  *
+  * @param  stat_chg_a  STAT_CHG_A value.
+  * @param  stat_chg_b  STAT_CHG_B value.
+  * @param  status      decoded status.(ptr)
+  *
+  */
+void max77658_chg_decode(uint8_t stat_chg_a, uint8_t stat_chg_b, max77658_chg_status_t *status)
+{
+   uint8_t chg_dtls = MAX77658_PM_FIELD_GET(STAT_CHG_B, CHG_DTLS, stat_chg_b);
+   uint8_t thm_dtls = MAX77658_PM_FIELD_GET(STAT_CHG_A, THM_DTLS, stat_chg_a);
+
+   status->chgin = MAX77658_PM_FIELD_GET(STAT_CHG_B, CHGIN_DTLS, stat_chg_b);
+
+   //CHG_DTLS and THM_DTLS only mean something with a valid input
+   if(status->chgin == MAX77658_CHG_IN_OK)
+   {
+      status->state = m_chg_dtls[chg_dtls][0];
+      status->jeita = m_chg_dtls[chg_dtls][1];
+      status->zone = thm_dtls <= MAX77658_CHG_ZONE_NORMAL ? thm_dtls : MAX77658_CHG_ZONE_UNKNOWN;
+   }
+   else
+   {
+      status->state = MAX77658_CHG_NO_INPUT;
+      status->jeita = 0;
+      status->zone = MAX77658_CHG_ZONE_OFF;
+   }
+
+   status->flags = (MAX77658_PM_FIELD_GET(STAT_CHG_A, TJ_REG_STAT, stat_chg_a)     ? MAX77658_CHG_FLAG_TJ_REG : 0) |
+                   (MAX77658_PM_FIELD_GET(STAT_CHG_A, VSYS_MIN_STAT, stat_chg_a)   ? MAX77658_CHG_FLAG_VSYS_MIN : 0) |
+                   (MAX77658_PM_FIELD_GET(STAT_CHG_A, ICHGIN_LIM_STAT, stat_chg_a) ? MAX77658_CHG_FLAG_ICHGIN_LIM : 0) |
+                   (MAX77658_PM_FIELD_GET(STAT_CHG_A, VCHGIN_MIN_STAT, stat_chg_a) ? MAX77658_CHG_FLAG_VCHGIN_MIN : 0) |
+                   (MAX77658_PM_FIELD_GET(STAT_CHG_B, TIME_SUS, stat_chg_b)        ? MAX77658_CHG_FLAG_TIME_SUS : 0);
+}
+
+/**
+  * @brief  Decode a read of INT_CHG..STAT_CHG_B, e.g. the tail of a burst
+  *         that also covered INT_GLBL0. Only a change of the decoded status
+  *         is reported, INT_CHG alone (e.g. a loop that toggled and settled)
+  *         is kept in chg->int_chg but is not a transition.
+  *
+  * @param  chg   tracker.(ptr)
+  * @param  regs  INT_CHG, STAT_CHG_A, STAT_CHG_B.(ptr)
+  * @retval       0: No change, 1: Transition, chg->status holds the new state
+  *
+  */
+int32_t max77658_chg_process(max77658_chg_t *chg, const uint8_t regs[3])
+{
+   max77658_chg_status_t status;
+
+   chg->int_chg = regs[0];
+   max77658_chg_decode(regs[1], regs[2], &status);
+
+   if(chg->valid && status.state == chg->status.state && status.jeita == chg->status.jeita &&
+      status.zone == chg->status.zone && status.chgin == chg->status.chgin && status.flags == chg->status.flags)
+   {
+      return 0;
+   }
+
+   chg->status = status;
+   chg->valid = 1;
+   chg->transitions++;
+
+   return 1;
+}
+
+/**
+  * @brief  Read INT_CHG, STAT_CHG_A and STAT_CHG_B with one burst (which
+  *         also clears INT_CHG) and process them
+  *
+  * @param  chg  tracker.(ptr)
+  * @retval      -1: I2C error, 0: No change, 1: Transition
+  *
+  */
+int32_t max77658_chg_update(max77658_chg_t *chg)
+{
+   uint8_t regs[MAX77658_CHG_REGS];
+
+   if(max77658_pm_read_burst(chg->pm, MAX77658_PM_ADDR_INT_CHG, regs, sizeof(regs)) != SUCCESS)
+   {
+      return ERROR;
+   }
+
+   return max77658_chg_process(chg, regs);
+}
@@ -0,0 +1,114 @@
+/*
+ * max77658_chg.h
+ *
+ *  Charger state of the MAX77658, decoded from INT_CHG, STAT_CHG_A and
+ *  STAT_CHG_B (0x01..0x03) read in one burst.
+ */
+
+#ifndef MAIN_COMPONENT_MAX77658_CHG_H_
+#define MAIN_COMPONENT_MAX77658_CHG_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include "max77658_pm.h"
+
+/* Public defines ----------------------------------------------------- */
+/* max77658_chg_status_t.flags, STAT_CHG_A[6:3] and STAT_CHG_B.TIME_SUS */
+#define MAX77658_CHG_FLAG_TJ_REG      0x01  //Die temperature regulation
+#define MAX77658_CHG_FLAG_VSYS_MIN    0x02  //VSYS regulation loop active
+#define MAX77658_CHG_FLAG_ICHGIN_LIM  0x04  //Input current limit loop active
+#define MAX77658_CHG_FLAG_VCHGIN_MIN  0x08  //Minimum input voltage loop active
+#define MAX77658_CHG_FLAG_TIME_SUS    0x10  //Charge timer suspended
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief  Charger state, from CHG_DTLS when CHGIN is valid
+ */
+typedef enum
+{
+   MAX77658_CHG_NO_INPUT = 0,          //CHGIN not valid, see chgin
+   MAX77658_CHG_OFF,
+   MAX77658_CHG_PREQUAL,
+   MAX77658_CHG_FAST_CC,
+   MAX77658_CHG_FAST_CV,
+   MAX77658_CHG_TOP_OFF,
+   MAX77658_CHG_DONE,
+   MAX77658_CHG_FAULT_PREQUAL_TIMER,
+   MAX77658_CHG_FAULT_FAST_TIMER,
+   MAX77658_CHG_FAULT_TEMP,
+   MAX77658_CHG_UNKNOWN,               //Reserved CHG_DTLS code
+} max77658_chg_state_t;
+
+/**
+ * @brief  Battery temperature zone, THM_DTLS
+ */
+typedef enum
+{
+   MAX77658_CHG_ZONE_OFF = 0,          //Thermistor disabled
+   MAX77658_CHG_ZONE_COLD,
+   MAX77658_CHG_ZONE_COOL,
+   MAX77658_CHG_ZONE_WARM,
+   MAX77658_CHG_ZONE_HOT,
+   MAX77658_CHG_ZONE_NORMAL,
+   MAX77658_CHG_ZONE_UNKNOWN,
+} max77658_chg_zone_t;
+
+/**
+ * @brief  CHGIN input, CHGIN_DTLS
+ */
+typedef enum
+{
+   MAX77658_CHG_IN_UVLO = 0,
+   MAX77658_CHG_IN_OVP,
+   MAX77658_CHG_IN_DEBOUNCE,
+   MAX77658_CHG_IN_OK,
+} max77658_chg_input_t;
+
+/**
+ * @brief  Decoded charger status
+ */
+typedef struct
+{
+   uint8_t state;    //max77658_chg_state_t
+   uint8_t jeita;    //1: the state is the JEITA modified variant
+   uint8_t zone;     //max77658_chg_zone_t
+   uint8_t chgin;    //max77658_chg_input_t
+   uint8_t flags;    //MAX77658_CHG_FLAG_*
+} max77658_chg_status_t;
+
+/**
+ * @brief  Charger tracker
+ */
+typedef struct
+{
+   max77658_pm_t *pm;
+   uint8_t valid;                //status holds a decoded read
+   uint8_t int_chg;              //INT_CHG bits of the last read
+   max77658_chg_status_t status;
+   uint32_t transitions;
+} max77658_chg_t;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+  * @brief  Reset the tracker, the first update always reports a transition
+ */
+void max77658_chg_init(max77658_chg_t *chg, max77658_pm_t *pm);
+
+/**
+  * @brief  Decode STAT_CHG_A / STAT_CHG_B
+ */
+void max77658_chg_decode(uint8_t stat_chg_a, uint8_t stat_chg_b, max77658_chg_status_t *status);
+
+/**
+  * @brief  Feed INT_CHG / STAT_CHG_A / STAT_CHG_B read by the caller, 1 on a transition
+ */
+int32_t max77658_chg_process(max77658_chg_t *chg, const uint8_t regs[3]);
+
+/**
+  * @brief  Burst read INT_CHG..STAT_CHG_B and process it, 1 on a transition
+ */
+int32_t max77658_chg_update(max77658_chg_t *chg);
+
+
+#endif /* MAIN_COMPONENT_MAX77658_CHG_H_ */
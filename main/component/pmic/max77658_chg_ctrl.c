@@ -0,0 +1,290 @@
+/*
+ * max77658_chg_ctrl.c
+ *
+ *  Closed-loop charge current controller of the MAX77658.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "max77658_chg_ctrl.h"
+#include <stddef.h>
+
+/* Private defines ---------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------- */
+/* Private macros ----------------------------------------------------- */
+#define SUCCESS   0
+#define ERROR     -1
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+static const max77658_chg_ctrl_cfg_t m_chg_ctrl_default =
+{
+   .cc_min       = 0x03,                       //30mA
+   .cc_max       = 0,                          //No battery rating: never above the OTP / boot setting
+   .ilim_max     = MAX77658_CHG_ILIM_MAX_LEVEL,
+   .jeita_pct    = 50,
+   .batt_max_c   = 44,                         //Below the JEITA warm zone (45°C default)
+   .batt_hyst_c  = 1,
+   .settle_steps = 6,                          //30s at a 5s step
+   .batt_settle_steps = 60,                    //5min
+   .probe_steps  = 120,                        //10min
+   .track_pct    = 80,
+};
+
+/* Private function prototypes ---------------------------------------- */
+static uint8_t m_chg_ctrl_jeita(const max77658_chg_ctrl_t *ctrl);
+static uint8_t m_chg_ctrl_code(int32_t curr_ua);
+static uint8_t m_chg_ctrl_backoff(max77658_chg_ctrl_t *ctrl, uint8_t cc, uint8_t settle, uint8_t reason);
+
+/* Function definitions ----------------------------------------------- */
+
+/**
+  * @brief  Start from the CHG_CC and ICHGIN_LIM the charger runs with (OTP
+  *         or an earlier boot), never above the ceilings of cfg. A setting
+  *         above a ceiling is lowered by the first apply, otherwise nothing
+  *         is written until a step changes it. Without a battery rating
+  *         (cc_max 0) the CHG_CC found here is the ceiling.
+  *
+  * @param  ctrl  controller.(ptr)
+  * @param  cfg   limits and gains, NULL for the defaults.(ptr)
+  * @param  pm    PM interface.(ptr)
+  * @retval       0: Success, -1: Read failed, the controller starts at cc_min and ilim 0
+  *
+  */
+int32_t max77658_chg_ctrl_init(max77658_chg_ctrl_t *ctrl, const max77658_chg_ctrl_cfg_t *cfg, max77658_pm_t *pm)
+{
+   int32_t cc = max77658_pm_get_CHG_CC(pm);
+   int32_t ilim = max77658_pm_get_ICHGIN_LIM(pm);
+   int32_t ret = SUCCESS;
+
+   *ctrl = (max77658_chg_ctrl_t){0};
+   ctrl->cfg = cfg != NULL ? *cfg : m_chg_ctrl_default;
+
+   if(cc < 0 || ilim < 0)
+   {
+      //Unknown setting: the floors are safe whatever the battery
+      cc = ctrl->cfg.cc_min;
+      ilim = MAX77658_CHG_ILIM_CODE(0);
+      ret = ERROR;
+   }
+   if(ctrl->cfg.cc_max == 0 || ctrl->cfg.cc_max > MAX77658_CHG_CC_MAX_CODE)
+   {
+      ctrl->cfg.cc_max = cc < MAX77658_CHG_CC_MAX_CODE ? cc : MAX77658_CHG_CC_MAX_CODE;
+   }
+   if(ctrl->cfg.cc_min > ctrl->cfg.cc_max)
+   {
+      ctrl->cfg.cc_min = ctrl->cfg.cc_max;
+   }
+
+   //ICHGIN_LIM counts down, codes above the last level are the 95mA floor
+   ilim = ilim <= MAX77658_CHG_ILIM_MAX_LEVEL ? MAX77658_CHG_ILIM_MAX_LEVEL - ilim : 0;
+
+   ctrl->cc = cc < ctrl->cfg.cc_max ? cc : ctrl->cfg.cc_max;
+   ctrl->ceil = ctrl->cfg.cc_max;
+   ctrl->ilim = ilim < ctrl->cfg.ilim_max ? ilim : ctrl->cfg.ilim_max;
+   ctrl->dirty = ret != SUCCESS || ctrl->cc != cc || ctrl->ilim != ilim;
+
+   return ret;
+}
+
+/**
+  * @brief  One control step. Drops CHG_CC to the folded back current on
+  *         die temperature regulation and by 1/8 on a hot battery, resolves an active input limit by
+  *         raising ICHGIN_LIM first and lowering CHG_CC once it is at its
+  *         ceiling, and otherwise raises CHG_CC by one code per step up to
+  *         the ceiling of the last back-off, as long as the measured charge
+  *         current follows the setting. The ceiling rises by one code every
+  *         probe_steps quiet steps. Only fast-charge CC raises the current; in
+  *         CV / top-off the battery sets it and the controller holds.
+  *
+  * @param  ctrl  controller.(ptr)
+  * @param  in    charger status and fuel gauge readings.(ptr)
+  * @retval       MAX77658_CHG_CTRL_HOLD or the reason of the change
+  *
+  */
+uint8_t max77658_chg_ctrl_step(max77658_chg_ctrl_t *ctrl, const max77658_chg_ctrl_in_t *in)
+{
+   uint32_t set_ua;
+
+   if(in->status.state != MAX77658_CHG_FAST_CC && in->status.state != MAX77658_CHG_FAST_CV &&
+      in->status.state != MAX77658_CHG_TOP_OFF)
+   {
+      return MAX77658_CHG_CTRL_HOLD;
+   }
+
+   //The charger already folds back at TJ_REG, drop the setting to what it delivers there
+   if(in->status.flags & MAX77658_CHG_FLAG_TJ_REG)
+   {
+      return m_chg_ctrl_backoff(ctrl, m_chg_ctrl_code(in->avg_curr_ua), ctrl->cfg.settle_steps,
+                                MAX77658_CHG_CTRL_DIE_HOT);
+   }
+   //The battery lags by minutes, give each back-off time to show before the next
+   if(in->temp_c >= ctrl->cfg.batt_max_c)
+   {
+      if(ctrl->settle > 0)
+      {
+         ctrl->settle--;
+         return MAX77658_CHG_CTRL_HOLD;
+      }
+      return m_chg_ctrl_backoff(ctrl, ctrl->cc - ctrl->cc / 8, ctrl->cfg.batt_settle_steps,
+                                MAX77658_CHG_CTRL_BATT_HOT);
+   }
+
+   if(in->status.flags & MAX77658_CHG_FLAG_ICHGIN_LIM)
+   {
+      ctrl->settle = ctrl->cfg.settle_steps;
+      if(ctrl->ilim < ctrl->cfg.ilim_max)
+      {
+         ctrl->ilim++;
+         ctrl->dirty = 1;
+         return MAX77658_CHG_CTRL_ILIM_UP;
+      }
+      if(ctrl->cc > ctrl->cfg.cc_min)
+      {
+         //CHG_CC above what the input delivers only adds dissipation
+         ctrl->cc--;
+         ctrl->ceil = ctrl->cc;
+         ctrl->quiet = 0;
+         ctrl->dirty = 1;
+         ctrl->backoffs++;
+         return MAX77658_CHG_CTRL_ILIM_CC;
+      }
+      return MAX77658_CHG_CTRL_HOLD;
+   }
+
+   if(in->status.state != MAX77658_CHG_FAST_CC)
+   {
+      return MAX77658_CHG_CTRL_HOLD;
+   }
+   if(++ctrl->quiet >= ctrl->cfg.probe_steps)
+   {
+      ctrl->quiet = 0;
+      if(ctrl->ceil < ctrl->cfg.cc_max)
+      {
+         ctrl->ceil++;
+      }
+   }
+   if(ctrl->settle > 0)
+   {
+      ctrl->settle--;
+      return MAX77658_CHG_CTRL_HOLD;
+   }
+   if(in->temp_c >= ctrl->cfg.batt_max_c - ctrl->cfg.batt_hyst_c || ctrl->cc >= ctrl->ceil)
+   {
+      return MAX77658_CHG_CTRL_HOLD;
+   }
+
+   //A charge current short of the setting means something else limits, a raise would not help
+   set_ua = MAX77658_CHG_CC_UA(in->status.jeita ? m_chg_ctrl_jeita(ctrl) : ctrl->cc);
+   if(in->avg_curr_ua < 0 || (uint64_t)in->avg_curr_ua * 100 < (uint64_t)set_ua * ctrl->cfg.track_pct)
+   {
+      return MAX77658_CHG_CTRL_HOLD;
+   }
+
+   ctrl->cc++;
+   ctrl->dirty = 1;
+   ctrl->raises++;
+
+   return MAX77658_CHG_CTRL_RAISE;
+}
+
+/**
+  * @brief  Write CHG_CC, CHG_CC_JEITA and ICHGIN_LIM in one transaction if
+  *         the last steps changed them
+  *
+  * @param  ctrl  controller.(ptr)
+  * @param  pm    PM interface.(ptr)
+  * @retval       interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t max77658_chg_ctrl_apply(max77658_chg_ctrl_t *ctrl, max77658_pm_t *pm)
+{
+   int32_t ret;
+
+   if(!ctrl->dirty)
+   {
+      return SUCCESS;
+   }
+
+   max77658_pm_txn_begin(pm);
+   max77658_pm_set_CHG_CC(pm, ctrl->cc);
+   max77658_pm_set_CHG_CC_JEITA(pm, m_chg_ctrl_jeita(ctrl));
+   max77658_pm_set_ICHGIN_LIM(pm, MAX77658_CHG_ILIM_CODE(ctrl->ilim));
+   ret = max77658_pm_txn_commit(pm);
+   if(ret != SUCCESS)
+   {
+      ret = max77658_pm_txn_retry(pm);
+   }
+   if(ret != SUCCESS)
+   {
+      return ERROR;
+   }
+
+   ctrl->dirty = 0;
+
+   return SUCCESS;
+}
+
+/* Private function definitions ---------------------------------------- */
+/**
+  * @brief  CHG_CC_JEITA code, jeita_pct of the CHG_CC current
+  *
+  * @param  ctrl  controller.(ptr)
+  * @retval       CHG_CC_JEITA code
+  *
+  */
+static uint8_t m_chg_ctrl_jeita(const max77658_chg_ctrl_t *ctrl)
+{
+   uint32_t steps = ((uint32_t)ctrl->cc + 1) * ctrl->cfg.jeita_pct / 100;
+
+   return steps > 0 ? steps - 1 : 0;
+}
+
+/**
+  * @brief  Largest CHG_CC code at or below a current
+  *
+  * @param  curr_ua  current in uA.
+  * @retval          CHG_CC code
+  *
+  */
+static uint8_t m_chg_ctrl_code(int32_t curr_ua)
+{
+   if(curr_ua < (int32_t)MAX77658_CHG_CC_UA(0))
+   {
+      return 0;
+   }
+
+   return curr_ua >= (int32_t)MAX77658_CHG_CC_UA(MAX77658_CHG_CC_MAX_CODE) ?
+          MAX77658_CHG_CC_MAX_CODE : curr_ua / 7500 - 1;
+}
+
+/**
+  * @brief  Lower CHG_CC to cc, at least one code, not below cc_min, and
+  *         leave the new setting as the ceiling of the following raises
+  *
+  * @param  ctrl    controller.(ptr)
+  * @param  cc      target CHG_CC code.
+  * @param  settle  steps without a raise.
+  * @param  reason  MAX77658_CHG_CTRL_DIE_HOT or MAX77658_CHG_CTRL_BATT_HOT.
+  * @retval         reason, MAX77658_CHG_CTRL_HOLD if CHG_CC is at its floor
+  *
+  */
+static uint8_t m_chg_ctrl_backoff(max77658_chg_ctrl_t *ctrl, uint8_t cc, uint8_t settle, uint8_t reason)
+{
+   ctrl->settle = settle;
+   ctrl->quiet = 0;
+   if(ctrl->cc <= ctrl->cfg.cc_min)
+   {
+      return MAX77658_CHG_CTRL_HOLD;
+   }
+
+   if(cc >= ctrl->cc)
+   {
+      cc = ctrl->cc - 1;
+   }
+   ctrl->cc = cc > ctrl->cfg.cc_min ? cc : ctrl->cfg.cc_min;
+   ctrl->ceil = ctrl->cc;
+   ctrl->dirty = 1;
+   ctrl->backoffs++;
+
+   return reason;
+}
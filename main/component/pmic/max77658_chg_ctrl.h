@@ -0,0 +1,105 @@
+/*
+ * max77658_chg_ctrl.h
+ *
+ *  Closed-loop charge current controller of the MAX77658. Raises CHG_CC in
+ *  small steps while the charger delivers what it is set to, backs off fast
+ *  on die temperature regulation (TJ_REG_STAT) or a hot battery, and trades
+ *  CHG_CC against ICHGIN_LIM when the input current limit is active. A
+ *  back-off leaves a ceiling that is probed one code at a time, so the
+ *  setting sits just below the foldback instead of cycling through it. The
+ *  step is a pure function of the controller state and its inputs, the
+ *  registers are written by max77658_chg_ctrl_apply() only when they change.
+ */
+
+#ifndef MAIN_COMPONENT_MAX77658_CHG_CTRL_H_
+#define MAIN_COMPONENT_MAX77658_CHG_CTRL_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include "max77658_pm.h"
+#include "max77658_chg.h"
+
+/* Public defines ----------------------------------------------------- */
+#define MAX77658_CHG_CC_MAX_CODE     0x27   //300mA
+#define MAX77658_CHG_ILIM_MAX_LEVEL  4      //475mA, ICHGIN_LIM = 0b000
+
+/* CHG_CC / CHG_CC_JEITA code <-> uA, 7.5mA steps from 7.5mA */
+#define MAX77658_CHG_CC_UA(code)     (((uint32_t)(code) + 1) * 7500)
+/* Largest CHG_CC code at or below ua, e.g. a battery rating, ua >= 7.5mA */
+#define MAX77658_CHG_CC_CODE(ua)     ((uint8_t)((ua) / 7500 > MAX77658_CHG_CC_MAX_CODE + 1 ? \
+                                                MAX77658_CHG_CC_MAX_CODE : (ua) / 7500 - 1))
+/* ICHGIN_LIM level (0: 95mA .. 4: 475mA) <-> register code, the register counts down */
+#define MAX77658_CHG_ILIM_UA(level)  (((uint32_t)(level) + 1) * 95000)
+#define MAX77658_CHG_ILIM_CODE(level) (MAX77658_CHG_ILIM_MAX_LEVEL - (level))
+
+/* max77658_chg_ctrl_step() result, why the outputs changed */
+#define MAX77658_CHG_CTRL_HOLD       0      //No change
+#define MAX77658_CHG_CTRL_RAISE      1      //CHG_CC up one step
+#define MAX77658_CHG_CTRL_DIE_HOT    2      //CHG_CC backed off on TJ_REG_STAT
+#define MAX77658_CHG_CTRL_BATT_HOT   3      //CHG_CC backed off on the battery temperature
+#define MAX77658_CHG_CTRL_ILIM_UP    4      //ICHGIN_LIM up one step
+#define MAX77658_CHG_CTRL_ILIM_CC    5      //ICHGIN_LIM at its ceiling, CHG_CC down instead
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief  Limits and gains of the controller
+ */
+typedef struct
+{
+   uint8_t cc_min;             //CHG_CC code floor
+   uint8_t cc_max;             //CHG_CC code ceiling, the battery rating. 0: The CHG_CC found at init
+   uint8_t ilim_max;           //ICHGIN_LIM level ceiling
+   uint8_t jeita_pct;          //CHG_CC_JEITA as % of CHG_CC
+   int8_t  batt_max_c;         //Back off at or above this battery temperature
+   int8_t  batt_hyst_c;        //Raise again only below batt_max_c - batt_hyst_c
+   uint8_t settle_steps;       //Steps without a raise after a die / input limit back-off
+   uint8_t batt_settle_steps;  //Same after a battery back-off, the battery lags by minutes
+   uint8_t probe_steps;        //Quiet steps before the ceiling left by a back-off is raised by one
+   uint8_t track_pct;          //Raise only if the charge current reaches this % of CHG_CC
+} max77658_chg_ctrl_cfg_t;
+
+/**
+ * @brief  Inputs of one step
+ */
+typedef struct
+{
+   max77658_chg_status_t status;  //Decoded STAT_CHG_A / STAT_CHG_B
+   int16_t temp_c;                //Fuel gauge temperature
+   int32_t avg_curr_ua;           //Fuel gauge AvgCurrent, positive while charging
+} max77658_chg_ctrl_in_t;
+
+/**
+ * @brief  Controller state
+ */
+typedef struct
+{
+   max77658_chg_ctrl_cfg_t cfg;
+   uint8_t cc;                 //CHG_CC code
+   uint8_t ilim;               //ICHGIN_LIM level
+   uint8_t ceil;               //CHG_CC code the last back-off settled on
+   uint8_t settle;             //Steps left before the next raise
+   uint8_t quiet;              //Steps since the last back-off, up to probe_steps
+   uint8_t dirty;              //cc / ilim differ from the registers
+   uint32_t raises;
+   uint32_t backoffs;
+} max77658_chg_ctrl_t;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+  * @brief  Start at the CHG_CC / ICHGIN_LIM read from pm, capped by cfg (NULL for the defaults)
+ */
+int32_t max77658_chg_ctrl_init(max77658_chg_ctrl_t *ctrl, const max77658_chg_ctrl_cfg_t *cfg, max77658_pm_t *pm);
+
+/**
+  * @brief  One control step, no bus access. Returns MAX77658_CHG_CTRL_*
+ */
+uint8_t max77658_chg_ctrl_step(max77658_chg_ctrl_t *ctrl, const max77658_chg_ctrl_in_t *in);
+
+/**
+  * @brief  Write CHG_CC, CHG_CC_JEITA and ICHGIN_LIM if the step changed them
+ */
+int32_t max77658_chg_ctrl_apply(max77658_chg_ctrl_t *ctrl, max77658_pm_t *pm);
+
+
+#endif /* MAIN_COMPONENT_MAX77658_CHG_CTRL_H_ */
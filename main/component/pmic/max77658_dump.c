@@ -0,0 +1,196 @@
+/*
+ * max77658_dump.c
+ *
+ *  Register image of the MAX77658.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "max77658_dump.h"
+#include <stddef.h>
+#include <string.h>
+
+/* Private defines ---------------------------------------------------- */
+#define MAX77658_DUMP_BITMAP_OFFSET   10
+
+/* Private enumerate/structure ---------------------------------------- */
+/* Private macros ----------------------------------------------------- */
+#define SUCCESS   0
+#define ERROR     -1
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+static const uint8_t m_dump_fg_ranges[][2] = MAX77658_DUMP_FG_RANGES;
+
+/* Private function prototypes ---------------------------------------- */
+static int32_t m_dump_pm(max77658_pm_t *pm, uint8_t cor, uint8_t *image);
+static int32_t m_dump_fg(max77658_fg_t *fg, uint8_t *image);
+static uint8_t m_dump_pm_wanted(uint8_t reg, uint8_t cor);
+
+/* Function definitions ----------------------------------------------- */
+
+/**
+  * @brief  Capture the register image with bursts of at most
+  *         MAX77658_DUMP_MAX_BURST bytes, so the image never holds the bus
+  *         for longer than one of them.
+  *         A part that fails is left zero and its _OK flag clear, the
+  *         other part is still captured.
+  *
+  * @param  pm     PM interface, NULL to skip the PM map.(ptr)
+  * @param  fg     FG interface, NULL to skip the FG map.(ptr)
+  * @param  flags  MAX77658_DUMP_COR to read the clear-on-read registers too,
+  *                which clears the interrupts they hold.
+  * @param  t_ms   capture time stored in the image.
+  * @param  image  MAX77658_DUMP_SIZE bytes.(ptr)
+  * @retval        -1: A burst failed, 0: Every requested part read
+  *
+  */
+int32_t max77658_dump_capture(max77658_pm_t *pm, max77658_fg_t *fg, uint8_t flags, uint32_t t_ms,
+                              uint8_t image[MAX77658_DUMP_SIZE])
+{
+   int32_t ret = SUCCESS;
+
+   memset(image, 0, MAX77658_DUMP_SIZE);
+   memcpy(image, "MXRD", 4);
+   image[4] = MAX77658_DUMP_VERSION;
+   image[5] = flags & MAX77658_DUMP_COR;
+   image[6] = t_ms & 0xFF;
+   image[7] = (t_ms >> 8) & 0xFF;
+   image[8] = (t_ms >> 16) & 0xFF;
+   image[9] = t_ms >> 24;
+
+   if(pm != NULL)
+   {
+      if(m_dump_pm(pm, flags & MAX77658_DUMP_COR, image) == SUCCESS)
+      {
+         image[5] |= MAX77658_DUMP_PM_OK;
+      }
+      else
+      {
+         ret = ERROR;
+      }
+   }
+
+   if(fg != NULL)
+   {
+      if(m_dump_fg(fg, image) == SUCCESS)
+      {
+         image[5] |= MAX77658_DUMP_FG_OK;
+      }
+      else
+      {
+         ret = ERROR;
+      }
+   }
+
+   return ret;
+}
+
+/* Private function definitions ---------------------------------------- */
+/**
+  * @brief  Read the PM map straight into the image. A burst reads through
+  *         up to MAX77658_DUMP_MAX_GAP unused addresses but never through
+  *         a clear-on-read register that was not asked for, and stops at
+  *         MAX77658_DUMP_MAX_BURST registers.
+  *
+  * @param  pm     PM interface.(ptr)
+  * @param  cor    1: Include the clear-on-read registers.
+  * @param  image  register image.(ptr)
+  * @retval        -1: A burst failed, 0: Success
+  *
+  */
+static int32_t m_dump_pm(max77658_pm_t *pm, uint8_t cor, uint8_t *image)
+{
+   int32_t ret = SUCCESS;
+   uint8_t start = 0;
+   uint8_t last;
+   uint8_t next;
+
+   while(start < MAX77658_PM_REG_SPAN)
+   {
+      if(!m_dump_pm_wanted(start, cor))
+      {
+         start++;
+         continue;
+      }
+
+      last = start;
+      for(next = start + 1; next < MAX77658_PM_REG_SPAN && next - last <= MAX77658_DUMP_MAX_GAP + 1 &&
+                             next - start < MAX77658_DUMP_MAX_BURST; next++)
+      {
+         if(!cor && max77658_pm_reg_clear_on_read(next))
+         {
+            break;
+         }
+         if(m_dump_pm_wanted(next, cor))
+         {
+            last = next;
+         }
+      }
+
+      if(max77658_pm_read_burst(pm, start, &image[MAX77658_DUMP_PM_OFFSET + start], last - start + 1) != SUCCESS)
+      {
+         memset(&image[MAX77658_DUMP_PM_OFFSET + start], 0, last - start + 1);
+         ret = ERROR;
+      }
+      else
+      {
+         for(uint8_t reg = start; reg <= last; reg++)
+         {
+            image[MAX77658_DUMP_BITMAP_OFFSET + reg / 8] |= 1 << (reg % 8);
+         }
+      }
+      start = last + 1;
+   }
+
+   return ret;
+}
+
+/**
+  * @brief  Read the FG ranges straight into the image, the gauge sends
+  *         each register LSB first like the image stores it. A range is
+  *         read MAX77658_DUMP_MAX_BURST bytes at a time.
+  *
+  * @param  fg     FG interface.(ptr)
+  * @param  image  register image.(ptr)
+  * @retval        -1: A burst failed, 0: Success
+  *
+  */
+static int32_t m_dump_fg(max77658_fg_t *fg, uint8_t *image)
+{
+   int32_t ret = SUCCESS;
+   uint32_t offset = MAX77658_DUMP_FG_OFFSET;
+   uint8_t count;
+
+   for(uint8_t i = 0; i < sizeof(m_dump_fg_ranges) / sizeof(m_dump_fg_ranges[0]); i++)
+   {
+      for(uint8_t reg = 0; reg < m_dump_fg_ranges[i][1]; reg += count)
+      {
+         count = m_dump_fg_ranges[i][1] - reg;
+         if(count > MAX77658_DUMP_MAX_BURST / 2)
+         {
+            count = MAX77658_DUMP_MAX_BURST / 2;
+         }
+         if(fg->read_reg(fg->device_address, m_dump_fg_ranges[i][0] + reg, &image[offset], 2 * count) != SUCCESS)
+         {
+            memset(&image[offset], 0, 2 * count);
+            ret = ERROR;
+         }
+         offset += 2 * count;
+      }
+   }
+
+   return ret;
+}
+
+/**
+  * @brief  Register belongs in the image
+  *
+  * @param  reg  register address.
+  * @param  cor  1: Include the clear-on-read registers.
+  * @retval      1: Read it, 0: Skip it
+  *
+  */
+static uint8_t m_dump_pm_wanted(uint8_t reg, uint8_t cor)
+{
+   return (max77658_pm_reg_flags[reg] & MAX77658_PM_DEFINED) && (cor || !max77658_pm_reg_clear_on_read(reg));
+}
@@ -0,0 +1,56 @@
+/*
+ * max77658_dump.h
+ *
+ *  Register image of the MAX77658: the whole PM map (0x00..0x4B) and the
+ *  fuel gauge map read with a handful of burst reads into one flat,
+ *  little-endian byte image. tools/regdump.py decodes an image with the
+ *  register and field names of max77658_pm_regmap.def and diffs two.
+ *
+ *  Image layout, keep tools/regdump.py in sync:
+ *     0  u8[4]   "MXRD"
+ *     4  u8      version (1)
+ *     5  u8      MAX77658_DUMP_* flags
+ *     6  u32     t_ms
+ *    10  u8[10]  PM address bitmap, bit n of byte n/8 set if address n was read
+ *    20  u8[80]  PM registers 0x00..0x4F
+ *   100  u16[..] FG registers of MAX77658_DUMP_FG_RANGES, in order
+ */
+
+#ifndef MAIN_COMPONENT_MAX77658_DUMP_H_
+#define MAIN_COMPONENT_MAX77658_DUMP_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include "max77658_pm.h"
+#include "max77658_fg.h"
+
+/* Public defines ----------------------------------------------------- */
+#define MAX77658_DUMP_VERSION     1
+
+/* Image flags */
+#define MAX77658_DUMP_PM_OK       0x01   //PM part read without error
+#define MAX77658_DUMP_FG_OK       0x02   //FG part read without error
+#define MAX77658_DUMP_COR         0x04   //Clear-on-read registers were read, and cleared
+
+/* FG ranges as (first register, count): the main map, the 0xB0 and 0xD0 blocks */
+#define MAX77658_DUMP_FG_RANGES   { { 0x00, 0x50 }, { 0xB0, 0x10 }, { 0xD0, 0x30 } }
+#define MAX77658_DUMP_FG_REGS     (0x50 + 0x10 + 0x30)
+
+#define MAX77658_DUMP_MAX_GAP     8      //Unused PM addresses a burst may read through
+#define MAX77658_DUMP_MAX_BURST   32     //Bytes per burst, the bus serves urgent transfers in between
+
+#define MAX77658_DUMP_PM_OFFSET   20
+#define MAX77658_DUMP_FG_OFFSET   (MAX77658_DUMP_PM_OFFSET + MAX77658_PM_REG_SPAN)
+#define MAX77658_DUMP_SIZE        (MAX77658_DUMP_FG_OFFSET + 2 * MAX77658_DUMP_FG_REGS)
+
+/* Public enumerate/structure ----------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+  * @brief  Fill image with the PM and FG maps, either interface may be NULL. -1 if any burst failed
+ */
+int32_t max77658_dump_capture(max77658_pm_t *pm, max77658_fg_t *fg, uint8_t flags, uint32_t t_ms,
+                              uint8_t image[MAX77658_DUMP_SIZE]);
+
+
+#endif /* MAIN_COMPONENT_MAX77658_DUMP_H_ */
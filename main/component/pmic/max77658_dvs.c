@@ -0,0 +1,331 @@
+/*
+ * max77658_dvs.c
+ *
+ *  Rail voltage conversions and SBB0 dynamic voltage scaling.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "max77658_dvs.h"
+#include <stddef.h>
+
+/* Private defines ---------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------- */
+/**
+ * @brief  Linear transfer function of a TV_* field
+ */
+typedef struct
+{
+   uint16_t min_mv;            //Code 0
+   uint16_t step_mv;
+   uint8_t  max_code;          //Highest valid code
+} max77658_rail_range_t;
+
+/* Private macros ----------------------------------------------------- */
+#define SUCCESS   0
+#define ERROR     -1
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+static const max77658_rail_range_t m_rail_range[MAX77658_RAIL_COUNT] =
+{
+   [MAX77658_RAIL_SBB0] = { 500, 25, 200 },   //0.5V..5.5V
+   [MAX77658_RAIL_SBB1] = { 500, 25, 200 },
+   [MAX77658_RAIL_SBB2] = { 500, 25, 200 },
+   [MAX77658_RAIL_LDO0] = { 500, 25, 0x7F },  //0.5V..3.675V, TV_OFS_LDO0 not included
+   [MAX77658_RAIL_LDO1] = { 500, 25, 0x7F },
+};
+
+/* Private function prototypes ---------------------------------------- */
+static int32_t m_dvs_write(max77658_dvs_t *dvs, uint8_t code);
+
+/* Function definitions ----------------------------------------------- */
+
+/**
+  * @brief  Code of a rail voltage, rounded up so the output never ends
+  *         below the request
+  *
+  * @param  rail  regulator output.
+  * @param  mv    output voltage in mV.
+  * @retval       -1: Unknown rail or out of range, otherwise TV_* code
+  *
+  */
+int32_t max77658_rail_mv_to_code(max77658_rail_t rail, uint16_t mv)
+{
+   const max77658_rail_range_t *range;
+   uint32_t code;
+
+   if(rail >= MAX77658_RAIL_COUNT)
+   {
+      return ERROR;
+   }
+
+   range = &m_rail_range[rail];
+   if(mv < range->min_mv)
+   {
+      return ERROR;
+   }
+
+   code = (mv - range->min_mv + range->step_mv - 1) / range->step_mv;
+
+   return code <= range->max_code ? (int32_t)code : ERROR;
+}
+
+/**
+  * @brief  Rail voltage of a code, codes past the range read as the top
+  *
+  * @param  rail  regulator output.
+  * @param  code  TV_* code.
+  * @retval       output voltage in mV, 0 for an unknown rail
+  *
+  */
+uint16_t max77658_rail_code_to_mv(max77658_rail_t rail, uint8_t code)
+{
+   const max77658_rail_range_t *range;
+
+   if(rail >= MAX77658_RAIL_COUNT)
+   {
+      return 0;
+   }
+
+   range = &m_rail_range[rail];
+   if(code > range->max_code)
+   {
+      code = range->max_code;
+   }
+
+   return range->min_mv + code * range->step_mv;
+}
+
+/**
+  * @brief  Start from the current TV_SBB0, no ramp and no operating points
+  *
+  * @param  dvs        DVS state.(ptr)
+  * @param  pm         PM interface.(ptr)
+  * @param  step_mv    largest change per ramp write, rounded up to whole codes.
+  * @param  settle_ms  delay between ramp writes.
+  * @retval            interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t max77658_dvs_init(max77658_dvs_t *dvs, max77658_pm_t *pm, uint16_t step_mv, uint32_t settle_ms)
+{
+   int32_t code;
+   uint16_t step_code = m_rail_range[MAX77658_RAIL_SBB0].step_mv;
+
+   *dvs = (max77658_dvs_t){0};
+   dvs->pm = pm;
+   dvs->step = (step_mv + step_code - 1) / step_code > 0 ? (step_mv + step_code - 1) / step_code : 1;
+   dvs->settle_ms = settle_ms;
+
+   code = max77658_pm_get_TV_SBB0(pm);
+   if(code < 0)
+   {
+      return ERROR;
+   }
+
+   dvs->code = code;
+   dvs->target = code;
+   dvs->run_code = code;
+   dvs->idle_code = code;
+
+   return SUCCESS;
+}
+
+/**
+  * @brief  Start a ramp of TV_SBB0. A ramp in progress continues from where
+  *         it is towards the new target.
+  *
+  * @param  dvs     DVS state.(ptr)
+  * @param  mv      target voltage in mV.
+  * @param  now_ms  current time, the first step is due now.
+  * @retval         -1: Out of range, 0: Ramp scheduled or already there
+  *
+  */
+int32_t max77658_dvs_ramp_to(max77658_dvs_t *dvs, uint16_t mv, uint32_t now_ms)
+{
+   int32_t code = max77658_rail_mv_to_code(MAX77658_RAIL_SBB0, mv);
+
+   if(code < 0)
+   {
+      return ERROR;
+   }
+
+   dvs->target = code;
+   if(dvs->target == dvs->code)
+   {
+      dvs->ramping = 0;
+      return SUCCESS;
+   }
+
+   if(!dvs->ramping)
+   {
+      dvs->ramping = 1;
+      dvs->due_ms = now_ms;
+   }
+
+   return SUCCESS;
+}
+
+/**
+  * @brief  Write the next ramp step once the previous one has settled. A
+  *         failed write is tried again after settle_ms.
+  *
+  * @param  dvs     DVS state.(ptr)
+  * @param  now_ms  current time.
+  * @retval         -1: I2C error, 0: Not due or no ramp, 1: Stepped, 2: Target reached
+  *
+  */
+int32_t max77658_dvs_step(max77658_dvs_t *dvs, uint32_t now_ms)
+{
+   uint8_t next;
+
+   if(!dvs->ramping || (int32_t)(now_ms - dvs->due_ms) < 0)
+   {
+      return 0;
+   }
+
+   if(dvs->target > dvs->code)
+   {
+      next = dvs->target - dvs->code > dvs->step ? dvs->code + dvs->step : dvs->target;
+   }
+   else
+   {
+      next = dvs->code - dvs->target > dvs->step ? dvs->code - dvs->step : dvs->target;
+   }
+
+   dvs->due_ms = now_ms + dvs->settle_ms;
+   if(m_dvs_write(dvs, next) != SUCCESS)
+   {
+      return ERROR;
+   }
+
+   if(dvs->code == dvs->target)
+   {
+      dvs->ramping = 0;
+      return 2;
+   }
+
+   return 1;
+}
+
+/**
+  * @brief  Time of the next ramp step
+  *
+  * @param  dvs  DVS state.(ptr)
+  * @retval      due time in ms, MAX77658_DVS_NO_WAKE if no ramp is in progress
+  *
+  */
+uint32_t max77658_dvs_due(const max77658_dvs_t *dvs)
+{
+   return dvs->ramping ? dvs->due_ms : MAX77658_DVS_NO_WAKE;
+}
+
+/**
+  * @brief  Convert the run and idle points once. TV_SBB0_DVS gets the idle
+  *         code; with a GPIO1 driver, ALT_GPIO1 hands the choice between
+  *         TV_SBB0 and TV_SBB0_DVS to the pin, so a switch is one GPIO edge.
+  *         TV_SBB0 is not touched here, ramp it to run_mv first.
+  *
+  * @param  dvs      DVS state.(ptr)
+  * @param  run_mv   operating point under load in mV.
+  * @param  idle_mv  operating point at rest in mV.
+  * @param  pin      GPIO1 driver, NULL if GPIO1 is not wired.
+  * @retval          interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t max77658_dvs_set_points(max77658_dvs_t *dvs, uint16_t run_mv, uint16_t idle_mv, max77658_dvs_pin_ptr pin)
+{
+   int32_t run_code = max77658_rail_mv_to_code(MAX77658_RAIL_SBB0, run_mv);
+   int32_t idle_code = max77658_rail_mv_to_code(MAX77658_RAIL_SBB0, idle_mv);
+   int32_t ret;
+
+   if(run_code < 0 || idle_code < 0)
+   {
+      return ERROR;
+   }
+
+   dvs->run_code = run_code;
+   dvs->idle_code = idle_code;
+   dvs->idle = 0;
+   dvs->pin = pin;
+
+   if(pin != NULL)
+   {
+      pin(0);
+   }
+
+   max77658_pm_txn_begin(dvs->pm);
+   max77658_pm_set_TV_SBB0_DVS(dvs->pm, idle_code);
+   if(pin != NULL)
+   {
+      max77658_pm_set_DIR_1(dvs->pm, 1);
+      max77658_pm_set_ALT_GPIO1(dvs->pm, 1);
+   }
+   ret = max77658_pm_txn_commit(dvs->pm);
+   if(ret != SUCCESS)
+   {
+      ret = max77658_pm_txn_retry(dvs->pm);
+   }
+
+   return ret != SUCCESS ? ERROR : SUCCESS;
+}
+
+/**
+  * @brief  Switch operating point. With GPIO1 wired this is one pin edge
+  *         and the PMIC slews on its own. Without it, the run point is
+  *         restored with one TV_SBB0 write since the load is waiting for
+  *         it, and the idle point is ramped down in settle_ms steps.
+  *
+  * @param  dvs     DVS state.(ptr)
+  * @param  idle    1: Idle point, 0: Run point.
+  * @param  now_ms  current time.
+  * @retval         interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t max77658_dvs_select(max77658_dvs_t *dvs, uint8_t idle, uint32_t now_ms)
+{
+   if(dvs->pin != NULL)
+   {
+      dvs->pin(idle);
+      dvs->idle = idle;
+      return SUCCESS;
+   }
+
+   if(idle)
+   {
+      dvs->idle = 1;
+      dvs->target = dvs->idle_code;
+      if(!dvs->ramping && dvs->code != dvs->target)
+      {
+         dvs->ramping = 1;
+         dvs->due_ms = now_ms;
+      }
+      return SUCCESS;
+   }
+
+   dvs->idle = 0;
+   dvs->ramping = 0;
+   dvs->target = dvs->run_code;
+
+   return m_dvs_write(dvs, dvs->run_code);
+}
+
+/* Private function definitions ---------------------------------------- */
+/**
+  * @brief  Write TV_SBB0, with one retry
+  *
+  * @param  dvs   DVS state.(ptr)
+  * @param  code  TV_SBB0 code.
+  * @retval       interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+static int32_t m_dvs_write(max77658_dvs_t *dvs, uint8_t code)
+{
+   if(max77658_pm_set_TV_SBB0(dvs->pm, code) != SUCCESS && max77658_pm_retry(dvs->pm) != SUCCESS)
+   {
+      return ERROR;
+   }
+
+   dvs->code = code;
+
+   return SUCCESS;
+}
@@ -0,0 +1,101 @@
+/*
+ * max77658_dvs.h
+ *
+ *  Rail voltage conversions and SBB0 dynamic voltage scaling. Millivolt
+ *  targets go through the per-rail code tables, changes of TV_SBB0 are
+ *  ramped in steps with a settling delay between writes, and a run / idle
+ *  pair of operating points is kept in TV_SBB0 / TV_SBB0_DVS so the switch
+ *  between them needs no arithmetic and, with GPIO1 wired, no I2C.
+ */
+
+#ifndef MAIN_COMPONENT_MAX77658_DVS_H_
+#define MAIN_COMPONENT_MAX77658_DVS_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include "max77658_pm.h"
+
+/* Public defines ----------------------------------------------------- */
+#define MAX77658_DVS_NO_WAKE   UINT32_MAX  //No ramp in progress
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief  Regulator outputs, same numbering as the TELEMETRY_RAIL records
+ */
+typedef enum
+{
+   MAX77658_RAIL_SBB0 = 0,
+   MAX77658_RAIL_SBB1,
+   MAX77658_RAIL_SBB2,
+   MAX77658_RAIL_LDO0,
+   MAX77658_RAIL_LDO1,
+   MAX77658_RAIL_COUNT,
+} max77658_rail_t;
+
+/**
+ * @brief  Drives the GPIO1 input of the PMIC, 1 selects TV_SBB0_DVS
+ */
+typedef void (*max77658_dvs_pin_ptr)(uint8_t level);
+
+/**
+ * @brief  SBB0 DVS state
+ */
+typedef struct
+{
+   max77658_pm_t *pm;
+   uint8_t  code;              //TV_SBB0 as written
+   uint8_t  target;            //TV_SBB0 at the end of the ramp
+   uint8_t  step;              //Codes per ramp write
+   uint32_t settle_ms;         //Delay between ramp writes
+   uint32_t due_ms;            //Next ramp write
+   uint8_t  ramping;
+   uint8_t  run_code;          //Operating points, precomputed by max77658_dvs_set_points()
+   uint8_t  idle_code;
+   uint8_t  idle;              //Idle point selected
+   max77658_dvs_pin_ptr pin;   //NULL: switch through TV_SBB0
+} max77658_dvs_t;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+  * @brief  Code of the lowest output voltage at or above mv, -1 if out of range
+ */
+int32_t max77658_rail_mv_to_code(max77658_rail_t rail, uint16_t mv);
+
+/**
+  * @brief  Output voltage of a code in mV, 0 for an unknown rail
+ */
+uint16_t max77658_rail_code_to_mv(max77658_rail_t rail, uint8_t code);
+
+/**
+  * @brief  Read TV_SBB0 as the starting point, ramp in step_mv steps every settle_ms
+ */
+int32_t max77658_dvs_init(max77658_dvs_t *dvs, max77658_pm_t *pm, uint16_t step_mv, uint32_t settle_ms);
+
+/**
+  * @brief  Start a ramp of TV_SBB0 to mv, the first step is due at now_ms
+ */
+int32_t max77658_dvs_ramp_to(max77658_dvs_t *dvs, uint16_t mv, uint32_t now_ms);
+
+/**
+  * @brief  Write the next ramp step if due. -1: I2C error, 0: Not due, 1: Stepped, 2: Target reached
+ */
+int32_t max77658_dvs_step(max77658_dvs_t *dvs, uint32_t now_ms);
+
+/**
+  * @brief  Time of the next ramp step, MAX77658_DVS_NO_WAKE if none
+ */
+uint32_t max77658_dvs_due(const max77658_dvs_t *dvs);
+
+/**
+  * @brief  Program the run / idle points, pin != NULL hands the selection to GPIO1
+ */
+int32_t max77658_dvs_set_points(max77658_dvs_t *dvs, uint16_t run_mv, uint16_t idle_mv, max77658_dvs_pin_ptr pin);
+
+/**
+  * @brief  Switch between the run and the idle point
+ */
+int32_t max77658_dvs_select(max77658_dvs_t *dvs, uint8_t idle, uint32_t now_ms);
+
+
+#endif /* MAIN_COMPONENT_MAX77658_DVS_H_ */
@@ -9,23 +9,15 @@
 #define MAIN_COMPONENT_PMIC_MAX77658_C_
 
 #include "max77658_fg.h"
+#include "max77658_fg_async.h"
 #include "esp_log.h"
 #include "bsp.h"
 
 static const char *TAG = "MAX_FG";
 
 /* POR Mask */
-#define MAX17055_POR_MASK               (0xFFFD)
 #define MAX17055_CYCLE_MASK             (0x0002)
 
-
-/* MODELCFG register bits */
-#define MAX17055_MODELCFG_REFRESH       (1 << 15)
-
-
-/* FSTAT register bits */
-#define MAX17055_FSTAT_DNR              (1)
-
 /* LIBRARY FUNCTION SUCCESS*/
 #define F_SUCCESS_0  0
 
@@ -164,61 +156,12 @@ int max77658_fg_write_and_verify_reg(max77658_fg_t *ctx, uint8_t reg_addr, uint1
  */
 int max77658_fg_init(max77658_fg_t *ctx)
 {
-   int ret;
-   int time_out = 10;
-   int32_t status;
-   uint16_t hibcfg_value;
-   uint16_t version;
-
-   pdata.designcap  = 0x015E;  //Design Battery Capacity mAh this can change depending on the batteries implemented see battery data sheet for details.
-   pdata.ichgterm  = 0x0070;  // Charge Termination Current for the Battery This is specified by the manufacturer.
-   pdata.vempty  = 0x9600;  // Battery Empty Voltage This is specified by design, but manufacturer has a min Empty voltage specification.
-   pdata.vcharge  = 4200;  // Battery Charge Voltage can be obtained from MAX77650 configuration
-   pdata.rsense = 10; //5mOhms for MAX32620, keep in mind the MAX17055EVKIT has a 10mOhm resistor. This is a design specific value. Used for calculation results.
-
-   ESP_LOGI(TAG, "max77658_fg_init() Read Address = %X",ctx->device_address);
-
-   status = max77658_fg_read_reg(ctx, VERSION_REG, &version);
-   if (status != F_SUCCESS_0)
-      return status;
-
-   ESP_LOGI(TAG, "max77658_fg_init() version: %d", version);
-    
-
-   ///STEP 0. Check for POR (Skip load model if POR bit is cleared)
-
-   if (max77658_fg_check_POR_func(ctx) == F_ERROR_5)
-      return F_ERROR_5;  //POR not detected. Skip Initialization.
-
-   ///STEP 1. Check if FStat.DNR == 0 (Do not continue until FSTAT.DNR == 0)
-   ret = max77658_fg_poll_flag_clear(ctx, FSTAT_REG, MAX17055_FSTAT_DNR, time_out);
-   if (ret < F_SUCCESS_0) {
-      return ret;
-   }
-
-   ///STEP 1.2. Force exit from hibernate
-   hibcfg_value = max77658_fg_forcedExitHiberMode(ctx);
-   ESP_LOGI(TAG, "max77658_fg_init() hibcfg_value: %d", hibcfg_value);
-
-   ///STEP 2. Initialize configuration
-   ///STEP 2.1. Load EZ Config
-   max77658_fg_config_option_1(ctx);
-
-   ///STEP 2.2. Poll ModelCFG.ModelRefresh bit for clear
-   ret = max77658_fg_poll_flag_clear(ctx, MODELCFG_REG, MAX17055_MODELCFG_REFRESH, time_out);
-   if(ret < F_SUCCESS_0) {
-      return ret;
-   }
-   ///STEP3. Restore original HibCfg
-   max77658_fg_write_reg(&ctx, HIBCFG_REG, hibcfg_value);
+   max77658_fg_async_t op;
 
+   ///STEPS 0 - 3, see max77658_fg_async.c
+   max77658_fg_async_init(&op, ctx, 0);
 
-   /* Clear Status.POR */
-   ret = max77658_fg_clear_POR_bit(ctx);
-   if (ret < F_SUCCESS_0)
-      return ret; //See errors
-
-   return F_SUCCESS_0;
+   return max77658_fg_async_run(&op);
 }
 
 /**
@@ -939,44 +882,12 @@ int max77658_fg_save_Params(max77658_fg_t *ctx, saved_FG_params_t FG_params)
  */
 int max77658_fg_restore_Params(max77658_fg_t *ctx, saved_FG_params_t FG_params)
 {
-    int ret;
-    uint16_t temp_data, fullcapnom_data, mixCap_calc, dQacc_calc;
-    uint16_t dPacc_value = 0x0C80;//Set it to 200%
-
-    ///STEP 1. Restoring capacity parameters
-    max77658_fg_write_and_verify_reg(ctx, RCOMP0_REG, FG_params.rcomp0);
-    max77658_fg_write_and_verify_reg(ctx, TEMPCO_REG, FG_params.temp_co);
-    max77658_fg_write_and_verify_reg(ctx, FULLCAPNOM_REG, FG_params.full_cap_nom);
+    max77658_fg_async_t op;
 
-    bsp_delay_ms(350);//check the type of wait
+    ///STEPS 1 - 4, see max77658_fg_async.c
+    max77658_fg_async_restore(&op, ctx, &FG_params, 0);
 
-    ///STEP 2. Restore FullCap
-    ret = max77658_fg_read_reg(ctx, FULLCAPNOM_REG, &fullcapnom_data);
-    if (ret < F_SUCCESS_0)
-        return ret;
-
-    ret = max77658_fg_read_reg(ctx, MIXSOC_REG, &temp_data);
-    if (ret < F_SUCCESS_0)
-        return ret;
-
-    mixCap_calc = (temp_data*fullcapnom_data)/25600;
-
-    max77658_fg_write_and_verify_reg(ctx, MIXCAP_REG, mixCap_calc);
-    max77658_fg_write_and_verify_reg(ctx, FULLCAPREP_REG, FG_params.full_cap_rep);
-
-    ///STEP 3. Write DQACC to 200% of Capacity and DPACC to 200%
-    dQacc_calc = (FG_params.full_cap_nom/ 16) ;
-
-    max77658_fg_write_and_verify_reg(ctx, DPACC_REG, dPacc_value);
-    max77658_fg_write_and_verify_reg(ctx, DQACC_REG, dQacc_calc);
-
-    bsp_delay_ms(350);
-
-    ///STEP 4. Restore Cycles register
-    ret = max77658_fg_write_and_verify_reg(ctx, CYCLES_REG, FG_params.cycles);
-    if (ret < F_SUCCESS_0)
-        return ret;
-    return ret;
+    return max77658_fg_async_run(&op);
 }
 
 /**
@@ -1008,4 +919,64 @@ int max77658_fg_avCurr_2_atRate(max77658_fg_t *ctx)
     return F_SUCCESS_0;
 }
 
+/**
+ * @brief        Program the alert thresholds of the MAX17055.
+ * @par          Details
+ *               VAlrtTh has a 20mV LSB, SAlrtTh a 1% LSB. Voltage and SOC
+ *               alerts are made sticky so a slow poll of STATUS still sees
+ *               a threshold that was only crossed briefly.
+ *
+ * @param[in]    vmin_mv   Minimum voltage alert threshold
+ * @param[in]    vmax_mv   Maximum voltage alert threshold
+ * @param[in]    smin      Minimum SOC alert threshold in %
+ * @param[in]    smax      Maximum SOC alert threshold in %
+ *
+ * @retval      0 for success
+ * @retval      non-0 negative for errors
+ */
+int max77658_fg_set_alerts(max77658_fg_t *ctx, uint16_t vmin_mv, uint16_t vmax_mv, uint8_t smin, uint8_t smax)
+{
+    int ret;
+    uint16_t config;
+
+    ret = max77658_fg_write_reg(ctx, VALRTTH_REG, ((vmax_mv / 20) << 8) | (vmin_mv / 20));
+    if (ret < F_SUCCESS_0)
+        return ret;
+
+    ret = max77658_fg_write_reg(ctx, SALRTTH_REG, (smax << 8) | smin);
+    if (ret < F_SUCCESS_0)
+        return ret;
+
+    ret = max77658_fg_read_reg(ctx, CONFIG_REG, &config);
+    if (ret < F_SUCCESS_0)
+        return ret;
+
+    return max77658_fg_write_reg(ctx, CONFIG_REG, config | MAX17055_CONFIG_AEN | MAX17055_CONFIG_VS | MAX17055_CONFIG_SS);
+}
+
+/**
+ * @brief        Read and clear the alert bits of STATUS.
+ *
+ * @retval      MAX17055_STATUS_ALERTS bits that were set, 0 if none
+ * @retval      non-0 negative for errors
+ */
+int32_t max77658_fg_get_alerts(max77658_fg_t *ctx)
+{
+    int ret;
+    uint16_t status;
+
+    ret = max77658_fg_read_reg(ctx, STATUS_REG, &status);
+    if (ret < F_SUCCESS_0)
+        return ret;
+
+    if (!(status & MAX17055_STATUS_ALERTS))
+        return 0;
+
+    ret = max77658_fg_write_reg(ctx, STATUS_REG, status & ~MAX17055_STATUS_ALERTS);
+    if (ret < F_SUCCESS_0)
+        return ret;
+
+    return status & MAX17055_STATUS_ALERTS;
+}
+
 #endif /* MAIN_COMPONENT_PMIC_MAX77658_C_ */
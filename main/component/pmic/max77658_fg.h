@@ -15,6 +15,32 @@
 /* STATUS register bits */
 #define MAX17055_STATUS_BST             (1 << 3)
 #define MAX17055_STATUS_POR             (1 << 1)
+#define MAX17055_STATUS_IMN             (1 << 2)
+#define MAX17055_STATUS_IMX             (1 << 6)
+#define MAX17055_STATUS_VMN             (1 << 8)
+#define MAX17055_STATUS_TMN             (1 << 9)
+#define MAX17055_STATUS_SMN             (1 << 10)
+#define MAX17055_STATUS_VMX             (1 << 12)
+#define MAX17055_STATUS_TMX             (1 << 13)
+#define MAX17055_STATUS_SMX             (1 << 14)
+#define MAX17055_STATUS_ALERTS          (MAX17055_STATUS_IMN | MAX17055_STATUS_IMX | \
+                                         MAX17055_STATUS_VMN | MAX17055_STATUS_TMN | MAX17055_STATUS_SMN | \
+                                         MAX17055_STATUS_VMX | MAX17055_STATUS_TMX | MAX17055_STATUS_SMX)
+
+/* POR Mask */
+#define MAX17055_POR_MASK               (0xFFFD)
+
+/* MODELCFG register bits */
+#define MAX17055_MODELCFG_REFRESH       (1 << 15)
+
+/* FSTAT register bits */
+#define MAX17055_FSTAT_DNR              (1)
+
+/* CONFIG register bits */
+#define MAX17055_CONFIG_AEN             (1 << 2)   //Alert enable
+#define MAX17055_CONFIG_VS              (1 << 12)  //Voltage alerts stay set until cleared
+#define MAX17055_CONFIG_TS              (1 << 13)  //Temperature alerts stay set until cleared
+#define MAX17055_CONFIG_SS              (1 << 14)  //SOC alerts stay set until cleared
 
 /// Model loading options
 #define MODEL_LOADING_OPTION1           1 //EZ Config
@@ -47,6 +73,9 @@ typedef struct
    dev_write_ptr  write_reg;
 }max77658_fg_t;
 
+/* Platform data of the design, set by max77658_fg_init() */
+extern platform_data pdata;
+
 /*
  * Helper function Read generic device register
  */
@@ -199,5 +228,15 @@ int max77658_fg_avCurr_2_atRate();
  */
 int16_t max77658_fg_get_regInfo(max77658_fg_t *ctx, uint8_t reg_addr);
 
+/**
+ * @brief       Program the voltage and SOC alert thresholds and latch the alerts in STATUS.
+ */
+int max77658_fg_set_alerts(max77658_fg_t *ctx, uint16_t vmin_mv, uint16_t vmax_mv, uint8_t smin, uint8_t smax);
+
+/**
+ * @brief       Read and clear the latched alert bits of STATUS.
+ */
+int32_t max77658_fg_get_alerts(max77658_fg_t *ctx);
+
 
 #endif /* MAIN_COMPONENT_PMIC_MAX77658_FG_H_ */
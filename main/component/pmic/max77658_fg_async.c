@@ -0,0 +1,509 @@
+/*
+ * max77658_fg_async.c
+ *
+ *  Resumable fuel gauge sequences.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "max77658_fg_async.h"
+#include <stddef.h>
+#include "esp_log.h"
+#include "bsp.h"
+
+/* Private defines ---------------------------------------------------- */
+#define MAX77658_FG_ASYNC_DPACC   0x0C80       //dPAcc of the restore, 200%
+
+/* Private enumerate/structure ---------------------------------------- */
+/* Private macros ----------------------------------------------------- */
+#define SUCCESS   0
+#define ERROR     -1
+
+#define M_REACHED(now, t)   ((int32_t)((now) - (t)) >= 0)
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+static const char *TAG = "MAX_FG_ASYNC";
+
+/* Private function prototypes ---------------------------------------- */
+static void m_fg_async_start(max77658_fg_async_t *op, max77658_fg_t *fg, uint8_t state, uint32_t now_ms);
+static void m_fg_async_queue(max77658_fg_async_t *op, uint8_t reg, uint16_t value);
+static void m_fg_async_write(max77658_fg_async_t *op, uint8_t next, uint32_t next_delay_ms, uint8_t fatal, uint32_t now_ms);
+static int32_t m_fg_async_finish(max77658_fg_async_t *op, int32_t result);
+static void m_fg_async_init_por(max77658_fg_async_t *op, uint32_t now_ms);
+static void m_fg_async_init_dnr(max77658_fg_async_t *op, uint32_t now_ms);
+static void m_fg_async_init_load(max77658_fg_async_t *op, uint32_t now_ms);
+static void m_fg_async_init_refresh(max77658_fg_async_t *op, uint32_t now_ms);
+static void m_fg_async_restore_cap(max77658_fg_async_t *op, uint32_t now_ms);
+static void m_fg_async_verify(max77658_fg_async_t *op, uint32_t now_ms);
+
+/* Function definitions ----------------------------------------------- */
+
+/**
+  * @brief  Start the EZ config model load. The platform data of the
+  *         design is set here, like max77658_fg_init() always did.
+  *
+  * @param  op      sequence.(ptr)
+  * @param  fg      FG interface.(ptr)
+  * @param  now_ms  current time.
+  *
+  */
+void max77658_fg_async_init(max77658_fg_async_t *op, max77658_fg_t *fg, uint32_t now_ms)
+{
+   pdata.designcap = 0x015E;   //Design Battery Capacity mAh, see the battery data sheet
+   pdata.ichgterm  = 0x0070;   //Charge Termination Current, specified by the manufacturer
+   pdata.vempty    = 0x9600;   //Battery Empty Voltage, the manufacturer has a min Empty voltage specification
+   pdata.vcharge   = 4200;     //Battery Charge Voltage, from the charger configuration
+   pdata.rsense    = 10;       //mOhm, design specific, used for calculation results
+
+   m_fg_async_start(op, fg, MAX77658_FG_ASYNC_INIT_POR, now_ms);
+}
+
+/**
+  * @brief  Start the restore of the learned parameters
+  *
+  * @param  op      sequence.(ptr)
+  * @param  fg      FG interface.(ptr)
+  * @param  params  saved parameters, copied.(ptr)
+  * @param  now_ms  current time.
+  *
+  */
+void max77658_fg_async_restore(max77658_fg_async_t *op, max77658_fg_t *fg, const saved_FG_params_t *params, uint32_t now_ms)
+{
+   m_fg_async_start(op, fg, MAX77658_FG_ASYNC_IDLE, now_ms);
+   op->params = *params;
+
+   //Step 1: model parameters, then let the gauge settle
+   m_fg_async_queue(op, RCOMP0_REG, op->params.rcomp0);
+   m_fg_async_queue(op, TEMPCO_REG, op->params.temp_co);
+   m_fg_async_queue(op, FULLCAPNOM_REG, op->params.full_cap_nom);
+   op->next = MAX77658_FG_ASYNC_RESTORE_CAP;
+   op->next_delay_ms = MAX77658_FG_ASYNC_SETTLE_MS;
+   op->state = MAX77658_FG_ASYNC_VERIFY;
+   op->tries = 0;
+}
+
+/**
+  * @brief  Hold the init before the model load: the POR check and the DNR
+  *         poll still run, the first write waits for the release.
+  *
+  * @param  op      sequence.(ptr)
+  * @param  hold    1: Hold, 0: Release.
+  * @param  now_ms  current time, a held init is due at once.
+  *
+  */
+void max77658_fg_async_hold(max77658_fg_async_t *op, uint8_t hold, uint32_t now_ms)
+{
+   if(!hold && max77658_fg_async_held(op))
+   {
+      op->due_ms = now_ms;
+   }
+   op->hold = hold;
+}
+
+/**
+  * @brief  Init waiting for its release
+  *
+  * @param  op  sequence.(ptr)
+  * @retval     1: Held before the model load, 0: Running or done
+  *
+  */
+uint8_t max77658_fg_async_held(const max77658_fg_async_t *op)
+{
+   return op->hold && op->state == MAX77658_FG_ASYNC_INIT_LOAD;
+}
+
+/**
+  * @brief  Do the work that is due. Nothing happens before the due time,
+  *         so the step may be called on every wake of the caller.
+  *
+  * @param  op      sequence.(ptr)
+  * @param  now_ms  current time.
+  * @retval         MAX77658_FG_ASYNC_BUSY, 0: Done, negative: MAX77658_FG_ASYNC_ERR_*
+  *
+  */
+int32_t max77658_fg_async_step(max77658_fg_async_t *op, uint32_t now_ms)
+{
+   if(op->state == MAX77658_FG_ASYNC_DONE)
+   {
+      return op->result;
+   }
+   if(op->state == MAX77658_FG_ASYNC_IDLE || max77658_fg_async_held(op) || !M_REACHED(now_ms, op->due_ms))
+   {
+      return MAX77658_FG_ASYNC_BUSY;
+   }
+
+   op->steps++;
+   switch(op->state)
+   {
+      case MAX77658_FG_ASYNC_INIT_POR:
+         m_fg_async_init_por(op, now_ms);
+         break;
+      case MAX77658_FG_ASYNC_INIT_DNR:
+         m_fg_async_init_dnr(op, now_ms);
+         break;
+      case MAX77658_FG_ASYNC_INIT_LOAD:
+         m_fg_async_init_load(op, now_ms);
+         break;
+      case MAX77658_FG_ASYNC_INIT_REFRESH:
+         m_fg_async_init_refresh(op, now_ms);
+         break;
+      case MAX77658_FG_ASYNC_RESTORE_CAP:
+         m_fg_async_restore_cap(op, now_ms);
+         break;
+      case MAX77658_FG_ASYNC_RESTORE_CYCLES:
+         //Step 4: Cycles, the only restore write whose failure is reported
+         m_fg_async_queue(op, CYCLES_REG, op->params.cycles);
+         m_fg_async_write(op, MAX77658_FG_ASYNC_DONE, 0, 1, now_ms);
+         break;
+      case MAX77658_FG_ASYNC_VERIFY:
+         m_fg_async_verify(op, now_ms);
+         break;
+      default:
+         break;
+   }
+
+   return op->state == MAX77658_FG_ASYNC_DONE ? op->result : MAX77658_FG_ASYNC_BUSY;
+}
+
+/**
+  * @brief  Time of the next step
+  *
+  * @param  op  sequence.(ptr)
+  * @retval     due time, MAX77658_FG_ASYNC_NO_WAKE: Done, not started or held
+  *
+  */
+uint32_t max77658_fg_async_due(const max77658_fg_async_t *op)
+{
+   if(op->state == MAX77658_FG_ASYNC_IDLE || op->state == MAX77658_FG_ASYNC_DONE || max77658_fg_async_held(op))
+   {
+      return MAX77658_FG_ASYNC_NO_WAKE;
+   }
+
+   return op->due_ms;
+}
+
+/**
+  * @brief  Run a started sequence to the end on a clock of its own, for
+  *         callers that have nothing else to do meanwhile
+  *
+  * @param  op  sequence.(ptr)
+  * @retval     0: Done, negative: MAX77658_FG_ASYNC_ERR_*
+  *
+  */
+int32_t max77658_fg_async_run(max77658_fg_async_t *op)
+{
+   uint32_t now_ms = op->due_ms;
+   int32_t ret;
+
+   while((ret = max77658_fg_async_step(op, now_ms)) == MAX77658_FG_ASYNC_BUSY)
+   {
+      bsp_delay_ms(op->due_ms - now_ms);
+      now_ms = op->due_ms;
+   }
+
+   return ret;
+}
+
+/* Private function definitions ---------------------------------------- */
+/**
+  * @brief  Reset the sequence and make its first step due now
+  *
+  * @param  op      sequence.(ptr)
+  * @param  fg      FG interface.(ptr)
+  * @param  state   first state.
+  * @param  now_ms  current time.
+  *
+  */
+static void m_fg_async_start(max77658_fg_async_t *op, max77658_fg_t *fg, uint8_t state, uint32_t now_ms)
+{
+   *op = (max77658_fg_async_t){0};
+   op->fg = fg;
+   op->state = state;
+   op->due_ms = now_ms;
+}
+
+/**
+  * @brief  Add a verified write to the pending group
+  *
+  * @param  op     sequence.(ptr)
+  * @param  reg    register.
+  * @param  value  value to write.
+  *
+  */
+static void m_fg_async_queue(max77658_fg_async_t *op, uint8_t reg, uint16_t value)
+{
+   if(op->writes < MAX77658_FG_ASYNC_MAX_WRITES)
+   {
+      op->write[op->writes++] = (max77658_fg_async_write_t){ .reg = reg, .value = value };
+   }
+}
+
+/**
+  * @brief  Write every pending register not verified yet and read them
+  *         back after MAX77658_FG_ASYNC_VERIFY_MS. After the verify the
+  *         sequence continues in next, next_delay_ms later.
+  *
+  * @param  op             sequence.(ptr)
+  * @param  next           state after the verify.
+  * @param  next_delay_ms  wait before next.
+  * @param  fatal          1: A bus error ends the sequence.
+  * @param  now_ms         current time.
+  *
+  */
+static void m_fg_async_write(max77658_fg_async_t *op, uint8_t next, uint32_t next_delay_ms, uint8_t fatal, uint32_t now_ms)
+{
+   op->next = next;
+   op->next_delay_ms = next_delay_ms;
+   op->fatal = fatal;
+   op->tries = 0;
+   op->bus_error = 0;
+
+   for(uint8_t i = 0; i < op->writes; i++)
+   {
+      if(max77658_fg_write_reg(op->fg, op->write[i].reg, op->write[i].value) != SUCCESS)
+      {
+         op->bus_error = 1;
+      }
+   }
+   op->tries++;
+   op->state = MAX77658_FG_ASYNC_VERIFY;
+   op->due_ms = now_ms + MAX77658_FG_ASYNC_VERIFY_MS;
+}
+
+/**
+  * @brief  End the sequence
+  *
+  * @param  op      sequence.(ptr)
+  * @param  result  0 or MAX77658_FG_ASYNC_ERR_*.
+  * @retval         result
+  *
+  */
+static int32_t m_fg_async_finish(max77658_fg_async_t *op, int32_t result)
+{
+   op->state = MAX77658_FG_ASYNC_DONE;
+   op->result = result;
+
+   return result;
+}
+
+/**
+  * @brief  Step 0 of the init: read the version and skip the model load if
+  *         Status.POR is clear. The first DNR poll is one interval later.
+  *
+  * @param  op      sequence.(ptr)
+  * @param  now_ms  current time.
+  *
+  */
+static void m_fg_async_init_por(max77658_fg_async_t *op, uint32_t now_ms)
+{
+   uint16_t version;
+   uint16_t status;
+
+   ESP_LOGI(TAG, "m_fg_async_init_por() Read Address = %X", op->fg->device_address);
+
+   if(max77658_fg_read_reg(op->fg, VERSION_REG, &version) != SUCCESS)
+   {
+      m_fg_async_finish(op, MAX77658_FG_ASYNC_ERR_BUS);
+      return;
+   }
+   ESP_LOGI(TAG, "m_fg_async_init_por() version: %d", version);
+
+   if(max77658_fg_read_reg(op->fg, STATUS_REG, &status) != SUCCESS)
+   {
+      m_fg_async_finish(op, MAX77658_FG_ASYNC_ERR_BUS);
+      return;
+   }
+   if(!(status & MAX17055_STATUS_POR))
+   {
+      m_fg_async_finish(op, MAX77658_FG_ASYNC_ERR_NO_POR);
+      return;
+   }
+
+   op->state = MAX77658_FG_ASYNC_INIT_DNR;
+   op->due_ms = now_ms + MAX77658_FG_ASYNC_POLL_MS;
+   op->deadline_ms = now_ms + MAX77658_FG_ASYNC_POLL_LIMIT_MS;
+}
+
+/**
+  * @brief  Step 1 of the init: wait for FStat.DNR to clear
+  *
+  * @param  op      sequence.(ptr)
+  * @param  now_ms  current time.
+  *
+  */
+static void m_fg_async_init_dnr(max77658_fg_async_t *op, uint32_t now_ms)
+{
+   uint16_t fstat;
+
+   if(max77658_fg_read_reg(op->fg, FSTAT_REG, &fstat) != SUCCESS)
+   {
+      m_fg_async_finish(op, MAX77658_FG_ASYNC_ERR_BUS);
+      return;
+   }
+   if(fstat & MAX17055_FSTAT_DNR)
+   {
+      if(M_REACHED(now_ms, op->deadline_ms))
+      {
+         m_fg_async_finish(op, MAX77658_FG_ASYNC_ERR_TIMEOUT);
+         return;
+      }
+      op->due_ms = now_ms + MAX77658_FG_ASYNC_POLL_MS;
+      return;
+   }
+
+   op->state = MAX77658_FG_ASYNC_INIT_LOAD;
+   op->due_ms = now_ms;
+}
+
+/**
+  * @brief  Steps 1.2 and 2.1 of the init: force the hibernate exit and
+  *         write the EZ config
+  *
+  * @param  op      sequence.(ptr)
+  * @param  now_ms  current time.
+  *
+  */
+static void m_fg_async_init_load(max77658_fg_async_t *op, uint32_t now_ms)
+{
+   op->hibcfg = max77658_fg_forcedExitHiberMode(op->fg);
+   ESP_LOGI(TAG, "m_fg_async_init_load() hibcfg_value: %d", op->hibcfg);
+   max77658_fg_config_option_1(op->fg);
+
+   op->state = MAX77658_FG_ASYNC_INIT_REFRESH;
+   op->due_ms = now_ms + MAX77658_FG_ASYNC_POLL_MS;
+   op->deadline_ms = now_ms + MAX77658_FG_ASYNC_POLL_LIMIT_MS;
+}
+
+/**
+  * @brief  Step 2.2 of the init: wait for ModelCFG.Refresh to clear, then
+  *         restore HibCFG and clear Status.POR with a verified write
+  *
+  * @param  op      sequence.(ptr)
+  * @param  now_ms  current time.
+  *
+  */
+static void m_fg_async_init_refresh(max77658_fg_async_t *op, uint32_t now_ms)
+{
+   uint16_t modelcfg;
+   uint16_t status;
+
+   if(max77658_fg_read_reg(op->fg, MODELCFG_REG, &modelcfg) != SUCCESS)
+   {
+      m_fg_async_finish(op, MAX77658_FG_ASYNC_ERR_BUS);
+      return;
+   }
+   if(modelcfg & MAX17055_MODELCFG_REFRESH)
+   {
+      if(M_REACHED(now_ms, op->deadline_ms))
+      {
+         m_fg_async_finish(op, MAX77658_FG_ASYNC_ERR_TIMEOUT);
+         return;
+      }
+      op->due_ms = now_ms + MAX77658_FG_ASYNC_POLL_MS;
+      return;
+   }
+
+   max77658_fg_write_reg(op->fg, HIBCFG_REG, op->hibcfg);
+
+   if(max77658_fg_read_reg(op->fg, STATUS_REG, &status) != SUCCESS)
+   {
+      m_fg_async_finish(op, MAX77658_FG_ASYNC_ERR_ABSENT);
+      return;
+   }
+   m_fg_async_queue(op, STATUS_REG, status & MAX17055_POR_MASK);
+   m_fg_async_write(op, MAX77658_FG_ASYNC_DONE, 0, 1, now_ms);
+}
+
+/**
+  * @brief  Steps 2 and 3 of the restore: MixCap from MixSOC and the
+  *         restored FullCapNom, FullCapRep, and both accumulators at 200%
+  *
+  * @param  op      sequence.(ptr)
+  * @param  now_ms  current time.
+  *
+  */
+static void m_fg_async_restore_cap(max77658_fg_async_t *op, uint32_t now_ms)
+{
+   uint16_t fullcapnom;
+   uint16_t mixsoc;
+
+   if(max77658_fg_read_reg(op->fg, FULLCAPNOM_REG, &fullcapnom) != SUCCESS ||
+      max77658_fg_read_reg(op->fg, MIXSOC_REG, &mixsoc) != SUCCESS)
+   {
+      m_fg_async_finish(op, MAX77658_FG_ASYNC_ERR_BUS);
+      return;
+   }
+
+   op->writes = 0;
+   m_fg_async_queue(op, MIXCAP_REG, (uint16_t)((mixsoc * fullcapnom) / 25600));
+   m_fg_async_queue(op, FULLCAPREP_REG, op->params.full_cap_rep);
+   m_fg_async_queue(op, DPACC_REG, MAX77658_FG_ASYNC_DPACC);
+   m_fg_async_queue(op, DQACC_REG, op->params.full_cap_nom / 16);
+   m_fg_async_write(op, MAX77658_FG_ASYNC_RESTORE_CYCLES, MAX77658_FG_ASYNC_SETTLE_MS, 0, now_ms);
+}
+
+/**
+  * @brief  Read the pending writes back. Registers that differ are written
+  *         again, up to MAX77658_FG_ASYNC_WRITE_TRIES writes, then left as
+  *         they are; the group is done once all match or the tries are up.
+  *         A restore group that was only queued is written first.
+  *
+  * @param  op      sequence.(ptr)
+  * @param  now_ms  current time.
+  *
+  */
+static void m_fg_async_verify(max77658_fg_async_t *op, uint32_t now_ms)
+{
+   uint8_t pending = 0;
+   uint16_t value;
+
+   if(op->tries == 0)
+   {
+      m_fg_async_write(op, op->next, op->next_delay_ms, 0, now_ms);
+      return;
+   }
+
+   for(uint8_t i = 0; i < op->writes; i++)
+   {
+      if(op->write[i].ok)
+      {
+         continue;
+      }
+      if(max77658_fg_read_reg(op->fg, op->write[i].reg, &value) != SUCCESS)
+      {
+         op->bus_error = 1;
+         continue;
+      }
+      op->write[i].ok = value == op->write[i].value;
+      pending |= !op->write[i].ok;
+   }
+
+   if(op->bus_error && op->fatal)
+   {
+      m_fg_async_finish(op, MAX77658_FG_ASYNC_ERR_BUS);
+      return;
+   }
+
+   if(pending && op->tries < MAX77658_FG_ASYNC_WRITE_TRIES)
+   {
+      for(uint8_t i = 0; i < op->writes; i++)
+      {
+         if(!op->write[i].ok && max77658_fg_write_reg(op->fg, op->write[i].reg, op->write[i].value) != SUCCESS)
+         {
+            op->bus_error = 1;
+         }
+      }
+      op->tries++;
+      op->due_ms = now_ms + MAX77658_FG_ASYNC_VERIFY_MS;
+      return;
+   }
+
+   op->writes = 0;
+   if(op->next == MAX77658_FG_ASYNC_DONE)
+   {
+      m_fg_async_finish(op, SUCCESS);
+      return;
+   }
+   op->state = op->next;
+   op->due_ms = now_ms + op->next_delay_ms;
+}
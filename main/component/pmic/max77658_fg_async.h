@@ -0,0 +1,126 @@
+/*
+ * max77658_fg_async.h
+ *
+ *  Resumable fuel gauge sequences: the EZ config model load of
+ *  max77658_fg_init() and the learned parameter restore of
+ *  max77658_fg_restore_Params() as state machines. A step does the bus
+ *  work that is due and returns at the next delay or poll, the caller runs
+ *  other work until max77658_fg_async_due() and steps again, e.g. from a
+ *  supervisor job. Register writes that are verified are sent together and
+ *  read back together after one delay. A held init stops before its first
+ *  write, once the gauge is ready for the model load, until it is released.
+ */
+
+#ifndef MAIN_COMPONENT_MAX77658_FG_ASYNC_H_
+#define MAIN_COMPONENT_MAX77658_FG_ASYNC_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include "max77658_fg.h"
+
+/* Public defines ----------------------------------------------------- */
+#define MAX77658_FG_ASYNC_BUSY          1            //Not done, step again at the due time
+#define MAX77658_FG_ASYNC_NO_WAKE       UINT32_MAX   //Done or not started
+
+/* Results, the error codes of max77658_fg_init() */
+#define MAX77658_FG_ASYNC_ERR_BUS       -1           //I2C read / write error
+#define MAX77658_FG_ASYNC_ERR_ABSENT    -2           //Status not readable before the POR clear
+#define MAX77658_FG_ASYNC_ERR_TIMEOUT   -4           //FStat.DNR or ModelCFG.Refresh did not clear
+#define MAX77658_FG_ASYNC_ERR_NO_POR    -5           //No power-on reset, the model is kept
+
+#define MAX77658_FG_ASYNC_POLL_MS       50           //FStat.DNR / ModelCFG.Refresh poll interval
+#define MAX77658_FG_ASYNC_POLL_LIMIT_MS 1000         //Longest wait for one of them
+#define MAX77658_FG_ASYNC_SETTLE_MS     350          //Between the restore write groups
+#define MAX77658_FG_ASYNC_VERIFY_MS     1            //Write to read back
+#define MAX77658_FG_ASYNC_WRITE_TRIES   4            //Writes of a register before its value is left as is
+#define MAX77658_FG_ASYNC_MAX_WRITES    4            //Verified writes of one group
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief  Sequence states
+ */
+typedef enum
+{
+   MAX77658_FG_ASYNC_IDLE = 0,
+   MAX77658_FG_ASYNC_INIT_POR,         //Version and Status.POR
+   MAX77658_FG_ASYNC_INIT_DNR,         //Poll FStat.DNR
+   MAX77658_FG_ASYNC_INIT_LOAD,        //Leave hibernate and load the EZ config, waits here while held
+   MAX77658_FG_ASYNC_INIT_REFRESH,     //Poll ModelCFG.Refresh, then restore HibCFG and clear Status.POR
+   MAX77658_FG_ASYNC_RESTORE_CAP,      //MixCap, FullCapRep, dPAcc and dQAcc
+   MAX77658_FG_ASYNC_RESTORE_CYCLES,   //Cycles
+   MAX77658_FG_ASYNC_VERIFY,           //Read back the pending writes
+   MAX77658_FG_ASYNC_DONE,
+} max77658_fg_async_state_t;
+
+/**
+ * @brief  Register write that is read back
+ */
+typedef struct
+{
+   uint8_t  reg;
+   uint16_t value;
+   uint8_t  ok;                        //Read back equal
+} max77658_fg_async_write_t;
+
+/**
+ * @brief  Sequence in progress
+ */
+typedef struct
+{
+   max77658_fg_t *fg;
+   uint8_t  state;                     //max77658_fg_async_state_t
+   uint8_t  next;                      //State after the pending writes are verified
+   uint32_t next_delay_ms;             //Wait between the verify and next
+   uint8_t  fatal;                     //A bus error on the pending writes ends the sequence
+   uint32_t due_ms;
+   uint32_t deadline_ms;               //End of the current poll
+   int32_t  result;                    //Valid in MAX77658_FG_ASYNC_DONE
+   uint16_t hibcfg;                    //HibCFG before the forced hibernate exit
+   saved_FG_params_t params;
+   max77658_fg_async_write_t write[MAX77658_FG_ASYNC_MAX_WRITES];
+   uint8_t  writes;
+   uint8_t  tries;
+   uint8_t  bus_error;                 //A pending write or read back failed
+   uint8_t  hold;                      //1: Wait in MAX77658_FG_ASYNC_INIT_LOAD
+   uint32_t steps;                     //Steps that did bus work
+} max77658_fg_async_t;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+  * @brief  Start the model load of max77658_fg_init(), the first step is due at now_ms
+ */
+void max77658_fg_async_init(max77658_fg_async_t *op, max77658_fg_t *fg, uint32_t now_ms);
+
+/**
+  * @brief  Start the restore of max77658_fg_restore_Params(), the first step is due at now_ms
+ */
+void max77658_fg_async_restore(max77658_fg_async_t *op, max77658_fg_t *fg, const saved_FG_params_t *params, uint32_t now_ms);
+
+/**
+  * @brief  Hold the init before the model load, or release it at now_ms
+ */
+void max77658_fg_async_hold(max77658_fg_async_t *op, uint8_t hold, uint32_t now_ms);
+
+/**
+  * @brief  1: The init waits for max77658_fg_async_hold() to release it
+ */
+uint8_t max77658_fg_async_held(const max77658_fg_async_t *op);
+
+/**
+  * @brief  Do the work due at now_ms. MAX77658_FG_ASYNC_BUSY, or the result once done
+ */
+int32_t max77658_fg_async_step(max77658_fg_async_t *op, uint32_t now_ms);
+
+/**
+  * @brief  Time of the next step, MAX77658_FG_ASYNC_NO_WAKE once done or while held
+ */
+uint32_t max77658_fg_async_due(const max77658_fg_async_t *op);
+
+/**
+  * @brief  Run the sequence to the end, sleeping with bsp_delay_ms() in between
+ */
+int32_t max77658_fg_async_run(max77658_fg_async_t *op);
+
+
+#endif /* MAIN_COMPONENT_MAX77658_FG_ASYNC_H_ */
@@ -0,0 +1,261 @@
+/*
+ * max77658_fg_energy.c
+ *
+ *  Battery power and energy accounting from fuel gauge samples.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "max77658_fg_energy.h"
+
+/* Private defines ---------------------------------------------------- */
+#define HNJ_PER_UWH   7200000LL   //1µWh = 3.6mJ = 7.2e6 half nJ
+
+/* Private enumerate/structure ---------------------------------------- */
+/* Private macros ----------------------------------------------------- */
+#define SUCCESS   0
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+
+/* Private function prototypes ---------------------------------------- */
+static void m_max77658_fg_energy_accumulate(max77658_fg_energy_t *energy, int32_t p0, int32_t p1, uint32_t dt);
+static void m_max77658_fg_energy_window_open(max77658_fg_energy_t *energy, uint32_t t_ms);
+static void m_max77658_fg_energy_window_close(max77658_fg_energy_t *energy);
+
+/* Function definitions ----------------------------------------------- */
+
+/**
+  * @brief  Reset the counters
+  *
+  * @param  energy       integrator state.(ptr)
+  * @param  rsense_mohm  sense resistor in mOhm, 10 if 0.
+  * @param  window_ms    length of a statistics window.
+  *
+  */
+void max77658_fg_energy_init(max77658_fg_energy_t *energy, uint32_t rsense_mohm, uint32_t window_ms)
+{
+   *energy = (max77658_fg_energy_t){0};
+   energy->rsense_mohm = rsense_mohm ? rsense_mohm : 10;
+   energy->window_ms = window_ms;
+}
+
+/**
+  * @brief  Load power from raw register values:
+  *         VCell LSB 78.125µV, Current LSB 1.5625µV / Rsense (positive while charging).
+  *
+  * @param  vcell_raw    VCELL register.
+  * @param  current_raw  CURRENT register.
+  * @param  rsense_mohm  sense resistor in mOhm.
+  * @retval              power drawn from the battery in µW (negative while charging)
+  *
+  */
+int32_t max77658_fg_energy_power_uw(uint16_t vcell_raw, uint16_t current_raw, uint32_t rsense_mohm)
+{
+   int64_t vcell_uv = ((int64_t)vcell_raw * 625) / 8;
+   int64_t current_na = ((int64_t)(int16_t)current_raw * 1562500) / (int64_t)rsense_mohm;
+
+   return (int32_t)(-(vcell_uv * current_na) / 1000000000LL);
+}
+
+/**
+  * @brief  Read VCell (0x09) and Current (0x0A) with one burst read and
+  *         integrate the resulting power.
+  *
+  * @param  ctx     fuel gauge interface.(ptr)
+  * @param  energy  integrator state.(ptr)
+  * @param  t_ms    sample timestamp.
+  * @retval         interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t max77658_fg_energy_sample(max77658_fg_t *ctx, max77658_fg_energy_t *energy, uint32_t t_ms)
+{
+   int32_t ret;
+   uint8_t data[4];
+
+   ret = ctx->read_reg(ctx->device_address, VCELL_REG, data, sizeof(data));
+   if(ret != SUCCESS)
+   {
+      return ret;
+   }
+
+   max77658_fg_energy_add(energy, t_ms,
+                          max77658_fg_energy_power_uw((data[1] << 8) | data[0], (data[3] << 8) | data[2],
+                                                      energy->rsense_mohm));
+
+   return SUCCESS;
+}
+
+/**
+  * @brief  Integrate a power sample with the trapezoidal rule. A gap longer
+  *         than MAX77658_FG_ENERGY_MAX_GAP_MS restarts the integration.
+  *
+  * @param  energy    integrator state.(ptr)
+  * @param  t_ms      sample timestamp, may wrap.
+  * @param  power_uw  power drawn from the battery in µW.
+  *
+  */
+void max77658_fg_energy_add(max77658_fg_energy_t *energy, uint32_t t_ms, int32_t power_uw)
+{
+   uint32_t dt;
+
+   if(!energy->has_last)
+   {
+      energy->has_last = 1;
+      m_max77658_fg_energy_window_open(energy, t_ms);
+   }
+   else
+   {
+      dt = t_ms - energy->last_ms;
+      if(dt > MAX77658_FG_ENERGY_MAX_GAP_MS)
+      {
+         energy->gaps++;
+      }
+      else
+      {
+         m_max77658_fg_energy_accumulate(energy, energy->last_uw, power_uw, dt);
+         energy->window.duration_ms += dt;
+      }
+   }
+
+   if(energy->window.samples == 0 || power_uw < energy->window.min_uw)
+   {
+      energy->window.min_uw = power_uw;
+   }
+   if(energy->window.samples == 0 || power_uw > energy->window.max_uw)
+   {
+      energy->window.max_uw = power_uw;
+   }
+   energy->window.samples++;
+
+   energy->last_ms = t_ms;
+   energy->last_uw = power_uw;
+
+   if(energy->window_ms && t_ms - energy->window.start_ms >= energy->window_ms)
+   {
+      m_max77658_fg_energy_window_close(energy);
+      m_max77658_fg_energy_window_open(energy, t_ms);
+   }
+}
+
+/**
+  * @brief  Attribute the segments that end after this call to a consumer
+  *
+  * @param  energy  integrator state.(ptr)
+  * @param  tag     consumer, < MAX77658_FG_ENERGY_TAGS.
+  *
+  */
+void max77658_fg_energy_set_tag(max77658_fg_energy_t *energy, uint8_t tag)
+{
+   if(tag < MAX77658_FG_ENERGY_TAGS)
+   {
+      energy->tag = tag;
+   }
+}
+
+/**
+  * @brief  Energy drawn from the battery since init
+  *
+  * @param  energy  integrator state.(ptr)
+  * @retval         energy in µWh
+  *
+  */
+int64_t max77658_fg_energy_discharge_uwh(max77658_fg_energy_t *energy)
+{
+   return energy->discharge_hnj / HNJ_PER_UWH;
+}
+
+/**
+  * @brief  Energy put into the battery since init
+  *
+  * @param  energy  integrator state.(ptr)
+  * @retval         energy in µWh
+  *
+  */
+int64_t max77658_fg_energy_charge_uwh(max77658_fg_energy_t *energy)
+{
+   return energy->charge_hnj / HNJ_PER_UWH;
+}
+
+/**
+  * @brief  Net energy drawn while a consumer tag was active
+  *
+  * @param  energy  integrator state.(ptr)
+  * @param  tag     consumer.
+  * @retval         energy in µWh, 0 for an unknown tag
+  *
+  */
+int64_t max77658_fg_energy_tag_uwh(max77658_fg_energy_t *energy, uint8_t tag)
+{
+   if(tag >= MAX77658_FG_ENERGY_TAGS)
+   {
+      return 0;
+   }
+
+   return energy->tag_hnj[tag] / HNJ_PER_UWH;
+}
+
+/* Private function definitions ---------------------------------------- */
+/**
+  * @brief  Add the trapezoid p0..p1 over dt. When the power changes sign the
+  *         segment is split at the zero crossing so charge and discharge
+  *         energy are kept apart.
+  *
+  * @param  energy  integrator state.(ptr)
+  * @param  p0      power at the start of the segment in µW.
+  * @param  p1      power at the end of the segment in µW.
+  * @param  dt      segment length in ms.
+  *
+  */
+static void m_max77658_fg_energy_accumulate(max77658_fg_energy_t *energy, int32_t p0, int32_t p1, uint32_t dt)
+{
+   int64_t area = ((int64_t)p0 + p1) * dt;  //Twice the trapezoid, half nJ
+   int64_t t_cross;
+   int64_t pos;
+   int64_t neg;
+
+   if((int64_t)p0 * p1 >= 0)
+   {
+      pos = area >= 0 ? area : 0;
+      neg = area < 0 ? -area : 0;
+   }
+   else
+   {
+      t_cross = ((int64_t)dt * p0) / ((int64_t)p0 - p1);
+      pos = (p0 > 0 ? (int64_t)p0 * t_cross : (int64_t)p1 * ((int64_t)dt - t_cross));
+      neg = (p0 < 0 ? -(int64_t)p0 * t_cross : -(int64_t)p1 * ((int64_t)dt - t_cross));
+   }
+
+   energy->discharge_hnj += pos;
+   energy->charge_hnj += neg;
+   energy->tag_hnj[energy->tag] += pos - neg;
+   energy->window_hnj += pos - neg;
+}
+
+/**
+  * @brief  Start a statistics window
+  *
+  * @param  energy  integrator state.(ptr)
+  * @param  t_ms    start timestamp.
+  *
+  */
+static void m_max77658_fg_energy_window_open(max77658_fg_energy_t *energy, uint32_t t_ms)
+{
+   energy->window = (max77658_fg_energy_window_t){0};
+   energy->window.start_ms = t_ms;
+   energy->window_hnj = 0;
+}
+
+/**
+  * @brief  Publish the current window as last_window
+  *
+  * @param  energy  integrator state.(ptr)
+  *
+  */
+static void m_max77658_fg_energy_window_close(max77658_fg_energy_t *energy)
+{
+   energy->window.energy_uwh = energy->window_hnj / HNJ_PER_UWH;
+   if(energy->window.duration_ms)
+   {
+      energy->window.avg_uw = (int32_t)(energy->window_hnj / (2 * (int64_t)energy->window.duration_ms));
+   }
+   energy->last_window = energy->window;
+}
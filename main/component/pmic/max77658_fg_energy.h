@@ -0,0 +1,105 @@
+/*
+ * max77658_fg_energy.h
+ *
+ *  Battery power and energy accounting from fuel gauge samples.
+ */
+
+#ifndef MAIN_COMPONENT_MAX77658_FG_ENERGY_H_
+#define MAIN_COMPONENT_MAX77658_FG_ENERGY_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include "max77658_fg.h"
+
+/* Public defines ----------------------------------------------------- */
+#ifndef MAX77658_FG_ENERGY_TAGS
+#define MAX77658_FG_ENERGY_TAGS 8            //Consumers energy is attributed to, see max77658_fg_energy_set_tag()
+#endif
+#ifndef MAX77658_FG_ENERGY_MAX_GAP_MS
+#define MAX77658_FG_ENERGY_MAX_GAP_MS 10000  //Longer sample gaps are not integrated
+#endif
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief  Statistics of one integration window. Power is positive while the
+ *         battery is discharging (load power).
+ */
+typedef struct
+{
+   uint32_t start_ms;      //Timestamp of the first sample
+   uint32_t duration_ms;   //Integrated time
+   int64_t  energy_uwh;    //Net energy drawn from the battery
+   int32_t  min_uw;
+   int32_t  max_uw;
+   int32_t  avg_uw;        //energy / duration
+   uint32_t samples;
+} max77658_fg_energy_window_t;
+
+/**
+ * @brief  Integrator state. Energies are kept in half nanojoules (µW x ms)
+ *         so the trapezoidal rule stays exact in integer arithmetic.
+ */
+typedef struct
+{
+   uint32_t rsense_mohm;   //Sense resistor used to scale Current
+   uint32_t window_ms;     //Length of a statistics window, e.g. 3600000 for hourly
+   uint8_t  tag;           //Consumer the next segments are attributed to
+
+   uint8_t  has_last;
+   uint32_t last_ms;
+   int32_t  last_uw;
+   uint32_t gaps;          //Samples dropped from integration by MAX77658_FG_ENERGY_MAX_GAP_MS
+
+   int64_t  discharge_hnj;
+   int64_t  charge_hnj;
+   int64_t  tag_hnj[MAX77658_FG_ENERGY_TAGS];
+
+   int64_t  window_hnj;
+   max77658_fg_energy_window_t window;       //Window being accumulated
+   max77658_fg_energy_window_t last_window;  //Last completed window
+} max77658_fg_energy_t;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+  * @brief  Reset the counters
+ */
+void max77658_fg_energy_init(max77658_fg_energy_t *energy, uint32_t rsense_mohm, uint32_t window_ms);
+
+/**
+  * @brief  Load power in µW from raw VCell and Current register values
+ */
+int32_t max77658_fg_energy_power_uw(uint16_t vcell_raw, uint16_t current_raw, uint32_t rsense_mohm);
+
+/**
+  * @brief  Read VCell and Current with one burst and integrate the sample
+ */
+int32_t max77658_fg_energy_sample(max77658_fg_t *ctx, max77658_fg_energy_t *energy, uint32_t t_ms);
+
+/**
+  * @brief  Integrate a power sample from any source
+ */
+void max77658_fg_energy_add(max77658_fg_energy_t *energy, uint32_t t_ms, int32_t power_uw);
+
+/**
+  * @brief  Attribute the following segments to a consumer
+ */
+void max77658_fg_energy_set_tag(max77658_fg_energy_t *energy, uint8_t tag);
+
+/**
+  * @brief  Energy drawn from the battery since init, in µWh
+ */
+int64_t max77658_fg_energy_discharge_uwh(max77658_fg_energy_t *energy);
+
+/**
+  * @brief  Energy put into the battery since init, in µWh
+ */
+int64_t max77658_fg_energy_charge_uwh(max77658_fg_energy_t *energy);
+
+/**
+  * @brief  Net energy drawn while a consumer tag was active, in µWh
+ */
+int64_t max77658_fg_energy_tag_uwh(max77658_fg_energy_t *energy, uint8_t tag);
+
+
+#endif /* MAIN_COMPONENT_MAX77658_FG_ENERGY_H_ */
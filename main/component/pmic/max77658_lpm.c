@@ -0,0 +1,147 @@
+/*
+ * max77658_lpm.c
+ *
+ *  Load driven power mode governor of the MAX77658.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "max77658_lpm.h"
+#include <stddef.h>
+
+/* Private defines ---------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------- */
+/* Private macros ----------------------------------------------------- */
+#define SUCCESS   0
+#define ERROR     -1
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+static const max77658_lpm_cfg_t m_lpm_default =
+{
+   .save_enter_ua = 20000,
+   .save_exit_ua  = 40000,
+   .low_enter_ua  = 2000,
+   .low_exit_ua   = 5000,                      //PMIC_IDLE_CURRENT_UA, the rest / load boundary
+   .dwell_samples = 3,                         //15s at the 5s rest cadence of the battery job
+};
+
+/* Private function prototypes ---------------------------------------- */
+static void m_lpm_enter(max77658_lpm_t *lpm, max77658_lpm_mode_t mode);
+
+/* Function definitions ----------------------------------------------- */
+
+/**
+  * @brief  Start in NORMAL, the first apply writes it whatever the OTP
+  *         default of DIS_LPM was.
+  *
+  * @param  lpm  governor.(ptr)
+  * @param  cfg  thresholds, NULL for the defaults.(ptr)
+  *
+  */
+void max77658_lpm_init(max77658_lpm_t *lpm, const max77658_lpm_cfg_t *cfg)
+{
+   *lpm = (max77658_lpm_t){0};
+   lpm->cfg = cfg != NULL ? *cfg : m_lpm_default;
+   lpm->mode = MAX77658_LPM_NORMAL;
+   lpm->dirty = 1;
+}
+
+/**
+  * @brief  One governor step. A sample above the exit threshold of the
+  *         current mode moves up at once, to the mode the load fits; a
+  *         lower mode is entered after dwell_samples samples in a row
+  *         allow it. The gap between the enter and exit thresholds keeps
+  *         a load sitting on one of them from toggling the mode.
+  *
+  * @param  lpm          governor.(ptr)
+  * @param  avg_curr_ua  fuel gauge AvgCurrent, either sign.
+  * @retval              1: Mode changed, 0: Held
+  *
+  */
+uint8_t max77658_lpm_step(max77658_lpm_t *lpm, int32_t avg_curr_ua)
+{
+   uint32_t load = avg_curr_ua < 0 ? (uint32_t)0 - (uint32_t)avg_curr_ua : (uint32_t)avg_curr_ua;
+   max77658_lpm_mode_t lower;
+
+   if(lpm->mode != MAX77658_LPM_NORMAL && load > lpm->cfg.save_exit_ua)
+   {
+      m_lpm_enter(lpm, MAX77658_LPM_NORMAL);
+      return 1;
+   }
+   if(lpm->mode == MAX77658_LPM_LOW && load > lpm->cfg.low_exit_ua)
+   {
+      m_lpm_enter(lpm, MAX77658_LPM_SAVE);
+      return 1;
+   }
+
+   lower = load < lpm->cfg.low_enter_ua ? MAX77658_LPM_LOW :
+           load < lpm->cfg.save_enter_ua ? MAX77658_LPM_SAVE : MAX77658_LPM_NORMAL;
+   if(lower <= lpm->mode)
+   {
+      lpm->dwell = 0;
+      return 0;
+   }
+
+   if(++lpm->dwell < lpm->cfg.dwell_samples)
+   {
+      return 0;
+   }
+
+   m_lpm_enter(lpm, lower);
+
+   return 1;
+}
+
+/**
+  * @brief  Write SBIA_LPM and DIS_LPM in one transaction if the mode
+  *         changed. On failure the mode stays dirty and the next apply
+  *         writes it again.
+  *
+  * @param  lpm  governor.(ptr)
+  * @param  pm   PM interface.(ptr)
+  * @retval      interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t max77658_lpm_apply(max77658_lpm_t *lpm, max77658_pm_t *pm)
+{
+   int32_t ret;
+
+   if(!lpm->dirty)
+   {
+      return SUCCESS;
+   }
+
+   max77658_pm_txn_begin(pm);
+   max77658_pm_set_SBIA_LPM(pm, lpm->mode == MAX77658_LPM_LOW);
+   max77658_pm_set_DIS_LPM(pm, lpm->mode == MAX77658_LPM_NORMAL);
+   ret = max77658_pm_txn_commit(pm);
+   if(ret != SUCCESS)
+   {
+      ret = max77658_pm_txn_retry(pm);
+   }
+   if(ret != SUCCESS)
+   {
+      return ERROR;
+   }
+
+   lpm->dirty = 0;
+
+   return SUCCESS;
+}
+
+/* Private function definitions ---------------------------------------- */
+/**
+  * @brief  Switch the mode and count it
+  *
+  * @param  lpm   governor.(ptr)
+  * @param  mode  new mode.
+  *
+  */
+static void m_lpm_enter(max77658_lpm_t *lpm, max77658_lpm_mode_t mode)
+{
+   lpm->mode = mode;
+   lpm->dwell = 0;
+   lpm->dirty = 1;
+   lpm->switches++;
+   lpm->entries[mode]++;
+}
@@ -0,0 +1,78 @@
+/*
+ * max77658_lpm.h
+ *
+ *  Load driven power mode governor of the MAX77658. Under load the SIMO
+ *  channels are kept out of their automatic low-power mode (DIS_LPM) for
+ *  the best transient response; at light load they are allowed into it,
+ *  and at rest the main bias goes to low-power mode too (SBIA_LPM). The
+ *  fuel gauge |AvgCurrent| picks the mode: stepping down needs dwell
+ *  samples in a row below the enter threshold of the lower mode, stepping
+ *  up happens on the first sample above the exit threshold of the current
+ *  one. The step is a pure function of the state and the sample, the
+ *  registers are written by max77658_lpm_apply() only when the mode changes.
+ */
+
+#ifndef MAIN_COMPONENT_MAX77658_LPM_H_
+#define MAIN_COMPONENT_MAX77658_LPM_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include "max77658_pm.h"
+
+/* Public defines ----------------------------------------------------- */
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief  Power modes, same numbering as the TELEMETRY_POWER_MODE records
+ */
+typedef enum
+{
+   MAX77658_LPM_NORMAL = 0,    //Main bias normal, SIMO automatic LPM disabled
+   MAX77658_LPM_SAVE,          //Main bias normal, SIMO automatic LPM allowed
+   MAX77658_LPM_LOW,           //Main bias low-power, SIMO automatic LPM allowed
+   MAX77658_LPM_COUNT,
+} max77658_lpm_mode_t;
+
+/**
+ * @brief  Thresholds of the governor, |AvgCurrent| in uA
+ */
+typedef struct
+{
+   uint32_t save_enter_ua;     //Below this SAVE is allowed
+   uint32_t save_exit_ua;      //Above this SAVE / LOW go back to NORMAL
+   uint32_t low_enter_ua;      //Below this LOW is allowed
+   uint32_t low_exit_ua;       //Above this LOW goes back to SAVE
+   uint8_t  dwell_samples;     //Samples in a row below an enter threshold before stepping down
+} max77658_lpm_cfg_t;
+
+/**
+ * @brief  Governor state
+ */
+typedef struct
+{
+   max77658_lpm_cfg_t cfg;
+   max77658_lpm_mode_t mode;
+   uint8_t  dwell;             //Samples in a row that allow a lower mode
+   uint8_t  dirty;             //mode differs from the registers
+   uint32_t switches;
+   uint32_t entries[MAX77658_LPM_COUNT];
+} max77658_lpm_t;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+  * @brief  Start in NORMAL with cfg (NULL for the defaults), first apply writes it
+ */
+void max77658_lpm_init(max77658_lpm_t *lpm, const max77658_lpm_cfg_t *cfg);
+
+/**
+  * @brief  One governor step on a fuel gauge sample, no bus access. 1: Mode changed
+ */
+uint8_t max77658_lpm_step(max77658_lpm_t *lpm, int32_t avg_curr_ua);
+
+/**
+  * @brief  Write SBIA_LPM and DIS_LPM if the step changed the mode
+ */
+int32_t max77658_lpm_apply(max77658_lpm_t *lpm, max77658_pm_t *pm);
+
+
+#endif /* MAIN_COMPONENT_MAX77658_LPM_H_ */
@@ -11,8 +11,6 @@
 #include "max77658_defines.h"
 
 /* Private defines ---------------------------------------------------- */
-
-
 /* Private enumerate/structure ---------------------------------------- */
 /* Private macros ----------------------------------------------------- */
 #define SUCCESS   0
@@ -23,6 +21,17 @@ static const char *TAG = "MAX77658 PM";
 
 
 /* Private function prototypes ---------------------------------------- */
+static uint8_t m_max77658_pm_verify_mask(uint8_t reg, uint8_t mask);
+static int32_t m_max77658_pm_apply_reg(max77658_pm_t *ctx, uint8_t reg, uint8_t mask, uint8_t value);
+static int32_t m_max77658_pm_txn_stage(max77658_pm_t *ctx, uint8_t reg, uint8_t mask, uint8_t value);
+static int32_t m_max77658_pm_verify_queue(max77658_pm_t *ctx, uint8_t reg, uint8_t mask, uint8_t value);
+static uint8_t m_max77658_pm_burst_can_extend(uint8_t start, uint8_t last, uint8_t next);
+static uint8_t m_max77658_pm_cache_get(max77658_pm_t *ctx, uint8_t reg, uint8_t *data);
+static void m_max77658_pm_cache_put(max77658_pm_t *ctx, uint8_t reg, uint8_t data);
+static void m_max77658_pm_cache_drop(max77658_pm_t *ctx, uint8_t reg);
+static void m_max77658_pm_set_error(max77658_pm_t *ctx, max77658_pm_err_code_t code, max77658_pm_step_t step,
+                                    uint8_t reg, uint8_t mask, uint8_t value, int32_t bus_status);
+
 /* Function definitions ----------------------------------------------- */
 
 /**
@@ -33,15 +42,16 @@ void max77658_pm_base_line_init(max77658_pm_t *ctx)
 {
    ESP_LOGI(TAG, "max77658_pm_base_line_init() Baseline Initialization!");
 
-   if(max77658_pm_set_SBIA_LPM(ctx, 0x00) > -1)  //Set Main Bias to normal Mode
+   //On failure replay only the failing register update once
+   if(max77658_pm_set_SBIA_LPM(ctx, 0x00) > -1 || max77658_pm_retry(ctx) > -1)  //Set Main Bias to normal Mode
    {
       ESP_LOGI(TAG, "max77658_pm_base_line_init() Set Main Bias to normal Mode: OK");
    }
-   if(max77658_pm_set_nEN_MODE(ctx, 0x00) > -1)  //set on/off-button to push-button
+   if(max77658_pm_set_nEN_MODE(ctx, 0x00) > -1 || max77658_pm_retry(ctx) > -1)  //set on/off-button to push-button
    {
       ESP_LOGI(TAG, "max77658_pm_base_line_init() Set on/off-button to push-button: OK");
    }
-   if(max77658_pm_set_DBEN_nEN(ctx, 0x00) > -1)  //Set nEN input debounce time to 30ms
+   if(max77658_pm_set_DBEN_nEN(ctx, 0x00) > -1 || max77658_pm_retry(ctx) > -1)  //Set nEN input debounce time to 30ms
    {
       ESP_LOGI(TAG, "max77658_pm_base_line_init() Set nEN input debounce time to 30ms: OK");
    }
@@ -74,11 +84,55 @@ int32_t max77658_pm_read_reg(max77658_pm_t *ctx, uint8_t reg, uint8_t *data)
 {
    int32_t ret;
 
+   if(m_max77658_pm_cache_get(ctx, reg, data))
+   {
+      return SUCCESS;
+   }
+
    ret = ctx->read_reg(ctx->device_address, reg, data, 1);
+   if(ret != SUCCESS)
+   {
+      m_max77658_pm_set_error(ctx, MAX77658_PM_ERR_BUS, MAX77658_PM_STEP_READ, reg, 0, 0, ret);
+   }
+   else
+   {
+      m_max77658_pm_cache_put(ctx, reg, *data);
+   }
 
    return ret;
 }
 
+/**
+  * @brief  Read consecutive device registers with one bus transaction. The
+  *         caller asks for every register of the range, clear-on-read ones
+  *         included. Cacheable registers refresh the cache.
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  * @param  reg   first register address to read.
+  * @param  data  buffer for data read.(ptr)
+  * @param  len   number of consecutive register to read.
+  * @retval       interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t max77658_pm_read_burst(max77658_pm_t *ctx, uint8_t reg, uint8_t *data, uint32_t len)
+{
+   int32_t ret;
+
+   ret = ctx->read_reg(ctx->device_address, reg, data, len);
+   if(ret != SUCCESS)
+   {
+      m_max77658_pm_set_error(ctx, MAX77658_PM_ERR_BUS, MAX77658_PM_STEP_READ, reg, 0, 0, ret);
+      return ret;
+   }
+
+   for(uint32_t i = 0; i < len; i++)
+   {
+      m_max77658_pm_cache_put(ctx, reg + i, data[i]);
+   }
+
+   return SUCCESS;
+}
+
 /**
   * @brief  Write generic device register
   *
@@ -94,6 +148,353 @@ int32_t max77658_pm_write_reg(max77658_pm_t *ctx, uint8_t reg, uint8_t *data)
    int32_t ret;
 
    ret = ctx->write_reg(ctx->device_address, reg, data, 1);
+   if(ret != SUCCESS)
+   {
+      m_max77658_pm_set_error(ctx, MAX77658_PM_ERR_BUS, MAX77658_PM_STEP_WRITE, reg, 0b11111111, *data, ret);
+      m_max77658_pm_cache_drop(ctx, reg);
+   }
+   else
+   {
+      m_max77658_pm_cache_put(ctx, reg, *data);
+   }
+
+   return ret;
+}
+
+/**
+  * @brief  Update a bit-field of a device register
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  * @param  reg   register address to update.
+  * @param  mask  bits of the register owned by the field.
+  * @param  value new field value, already shifted into position.
+  * @retval       -1: I2C error or read-back mismatch, 0: Success
+  *
+  * @note   Inside a max77658_pm_txn_begin()/max77658_pm_txn_commit() scope
+  *         the update is only staged in ctx and reaches the device on commit.
+  */
+int32_t max77658_pm_update_reg(max77658_pm_t *ctx, uint8_t reg, uint8_t mask, uint8_t value)
+{
+   if(ctx->txn.depth > 0)
+   {
+      return m_max77658_pm_txn_stage(ctx, reg, mask, value);
+   }
+
+   return m_max77658_pm_apply_reg(ctx, reg, mask, value);
+}
+
+/**
+  * @brief  Open a transaction scope. Field updates made by the setters are
+  *         accumulated per register until max77658_pm_txn_commit().
+  *         Scopes may be nested, only the outermost commit touches the bus.
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  *
+  */
+void max77658_pm_txn_begin(max77658_pm_t *ctx)
+{
+   if(ctx->txn.depth == 0)
+   {
+      ctx->txn.count = 0;
+   }
+   ctx->txn.depth++;
+}
+
+/**
+  * @brief  Close a transaction scope. On the outermost commit every dirty
+  *         register is read (only if partially updated), written and verified once.
+  *         Registers that fail stay staged for max77658_pm_txn_retry().
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  * @retval       -1: I2C error or read-back mismatch on any register, 0: Success
+  *
+  */
+int32_t max77658_pm_txn_commit(max77658_pm_t *ctx)
+{
+   if(ctx->txn.depth == 0)
+   {
+      m_max77658_pm_set_error(ctx, MAX77658_PM_ERR_TXN_STATE, MAX77658_PM_STEP_NONE, 0, 0, 0, SUCCESS);
+      return ERROR;
+   }
+
+   if(--ctx->txn.depth > 0)
+   {
+      return SUCCESS;
+   }
+
+   return max77658_pm_txn_retry(ctx);
+}
+
+/**
+  * @brief  Write and verify the registers still staged after a failed commit.
+  *         Registers that succeed are dropped, the others stay staged until
+  *         the next max77658_pm_txn_begin().
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  * @retval       -1: I2C error or read-back mismatch on any register, 0: Success
+  *
+  */
+int32_t max77658_pm_txn_retry(max77658_pm_t *ctx)
+{
+   uint8_t failed = 0;
+   max77658_pm_txn_entry_t *entry;
+
+   if(ctx->txn.depth > 0)
+   {
+      m_max77658_pm_set_error(ctx, MAX77658_PM_ERR_TXN_STATE, MAX77658_PM_STEP_NONE, 0, 0, 0, SUCCESS);
+      return ERROR;
+   }
+
+   for(uint8_t i = 0; i < ctx->txn.count; i++)
+   {
+      entry = &ctx->txn.entry[i];
+      if(m_max77658_pm_apply_reg(ctx, entry->reg, entry->mask, entry->value) != SUCCESS)
+      {
+         ESP_LOGE(TAG, "max77658_pm_txn_retry() reg 0x%02X failed, step %d", entry->reg, ctx->err.step);
+         ctx->txn.entry[failed++] = *entry;
+      }
+   }
+   ctx->txn.count = failed;
+
+   return (failed == 0)?SUCCESS:ERROR;
+}
+
+/**
+  * @brief  Drop every update staged in the current transaction scope.
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  *
+  */
+void max77658_pm_txn_abort(max77658_pm_t *ctx)
+{
+   ctx->txn.depth = 0;
+   ctx->txn.count = 0;
+}
+
+/**
+  * @brief  Replay the register update recorded in ctx->err, so a caller can
+  *         recover from a bus glitch without re-running a whole sequence.
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  * @retval       -1: Nothing to replay or the replay failed, 0: Success (error record cleared)
+  *
+  */
+int32_t max77658_pm_retry(max77658_pm_t *ctx)
+{
+   max77658_pm_err_t err = ctx->err;
+
+   if(err.code == MAX77658_PM_ERR_NONE || err.mask == 0)
+   {
+      return ERROR;
+   }
+
+   if(m_max77658_pm_apply_reg(ctx, err.reg, err.mask, err.value) != SUCCESS)
+   {
+      return ERROR;
+   }
+
+   max77658_pm_clear_error(ctx);
+
+   return SUCCESS;
+}
+
+/**
+  * @brief  Reset the error record of ctx
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  *
+  */
+void max77658_pm_clear_error(max77658_pm_t *ctx)
+{
+   ctx->err.code = MAX77658_PM_ERR_NONE;
+   ctx->err.step = MAX77658_PM_STEP_NONE;
+   ctx->err.reg = 0;
+   ctx->err.mask = 0;
+   ctx->err.value = 0;
+   ctx->err.bus_status = SUCCESS;
+   ctx->err.count = 0;
+}
+
+/**
+  * @brief  Select the read-back verification policy of the register updates.
+  *         Checks still queued by the deferred mode are verified before
+  *         switching to another mode.
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  * @param  mode  MAX77658_PM_VERIFY_IMMEDIATE, _DEFERRED or _OFF.
+  * @retval       -1: Pending deferred check failed, 0: Success
+  *
+  */
+int32_t max77658_pm_set_verify_mode(max77658_pm_t *ctx, max77658_pm_verify_mode_t mode)
+{
+   int32_t ret = SUCCESS;
+
+   if(mode != MAX77658_PM_VERIFY_DEFERRED && ctx->verify.count > 0)
+   {
+      ret = max77658_pm_verify_sync(ctx);
+   }
+   ctx->verify_mode = mode;
+
+   return ret;
+}
+
+/**
+  * @brief  Verify the registers written in deferred mode. Neighbouring
+  *         registers are checked with one burst read; a burst never spans
+  *         a clear-on-read register so no interrupt flag is lost.
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  * @retval       -1: I2C error or read-back mismatch, 0: Success
+  *
+  * @note   Mismatches are recorded in ctx->err and dropped from the queue,
+  *         max77658_pm_retry() replays the last one. Registers whose burst
+  *         read failed stay queued for the next sync.
+  */
+int32_t max77658_pm_verify_sync(max77658_pm_t *ctx)
+{
+   int32_t ret = SUCCESS;
+   int32_t status;
+   uint8_t burst[MAX77658_PM_VERIFY_MAX_BURST];
+   uint8_t first = 0;
+   uint8_t last;
+   uint8_t kept = 0;
+   uint8_t start;
+   uint8_t verify_mask;
+   max77658_pm_txn_entry_t *entry = ctx->verify.entry;
+
+   //Entries are kept sorted by register address
+   while(first < ctx->verify.count)
+   {
+      start = entry[first].reg;
+      last = first;
+      while(last + 1 < ctx->verify.count &&
+            m_max77658_pm_burst_can_extend(start, entry[last].reg, entry[last + 1].reg))
+      {
+         last++;
+      }
+
+      status = ctx->read_reg(ctx->device_address, start, burst, entry[last].reg - start + 1);
+      for(uint8_t i = first; i <= last; i++)
+      {
+         if(status != SUCCESS)
+         {
+            m_max77658_pm_set_error(ctx, MAX77658_PM_ERR_BUS, MAX77658_PM_STEP_VERIFY,
+                                    entry[i].reg, entry[i].mask, entry[i].value, status);
+            entry[kept++] = entry[i];
+            ret = ERROR;
+            continue;
+         }
+
+         verify_mask = m_max77658_pm_verify_mask(entry[i].reg, entry[i].mask);
+         if((burst[entry[i].reg - start] & verify_mask) != (entry[i].value & verify_mask))
+         {
+            ESP_LOGE(TAG, "max77658_pm_verify_sync() reg 0x%02X mismatch", entry[i].reg);
+            m_max77658_pm_set_error(ctx, MAX77658_PM_ERR_MISMATCH, MAX77658_PM_STEP_VERIFY,
+                                    entry[i].reg, entry[i].mask, entry[i].value, SUCCESS);
+            m_max77658_pm_cache_drop(ctx, entry[i].reg);
+            ret = ERROR;
+            continue;
+         }
+         m_max77658_pm_cache_put(ctx, entry[i].reg, burst[entry[i].reg - start]);
+      }
+      first = last + 1;
+   }
+   ctx->verify.count = kept;
+
+   return ret;
+}
+
+/**
+  * @brief  Enable or disable the shadow copy of the non-volatile registers.
+  *         While enabled, reads and the read step of read-modify-writes of
+  *         registers without MAX77658_PM_VOL are served from ctx->cache.
+  *         The copy starts empty; each register is loaded on first access
+  *         or by max77658_pm_cache_fill().
+  *
+  * @param  ctx     communication interface handler.(ptr)
+  * @param  enable  1: enable, 0: disable
+  *
+  */
+void max77658_pm_cache_enable(max77658_pm_t *ctx, uint8_t enable)
+{
+   max77658_pm_cache_invalidate(ctx);
+   ctx->cache.enabled = enable;
+}
+
+/**
+  * @brief  Drop every register of the shadow copy
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  *
+  */
+void max77658_pm_cache_invalidate(max77658_pm_t *ctx)
+{
+   for(uint8_t i = 0; i < sizeof(ctx->cache.valid); i++)
+   {
+      ctx->cache.valid[i] = 0;
+   }
+}
+
+/**
+  * @brief  Load every cacheable register of the register map, grouping
+  *         neighbours into burst reads.
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  * @retval       -1: Cache disabled or I2C error, 0: Success
+  *
+  */
+int32_t max77658_pm_cache_fill(max77658_pm_t *ctx)
+{
+   int32_t ret = SUCCESS;
+   int32_t status;
+   uint8_t burst[MAX77658_PM_VERIFY_MAX_BURST];
+   uint8_t start;
+   uint8_t last;
+   uint8_t next;
+
+   if(!ctx->cache.enabled)
+   {
+      return ERROR;
+   }
+
+   start = 0;
+   while(start < MAX77658_PM_REG_SPAN)
+   {
+      if(!max77658_pm_reg_cacheable(start))
+      {
+         start++;
+         continue;
+      }
+
+      last = start;
+      for(next = start + 1; next < MAX77658_PM_REG_SPAN; next++)
+      {
+         if(!max77658_pm_reg_cacheable(next))
+         {
+            continue;
+         }
+         if(!m_max77658_pm_burst_can_extend(start, last, next))
+         {
+            break;
+         }
+         last = next;
+      }
+
+      status = ctx->read_reg(ctx->device_address, start, burst, last - start + 1);
+      if(status != SUCCESS)
+      {
+         m_max77658_pm_set_error(ctx, MAX77658_PM_ERR_BUS, MAX77658_PM_STEP_READ, start, 0, 0, status);
+         ret = ERROR;
+      }
+      else
+      {
+         for(uint8_t reg = start; reg <= last; reg++)
+         {
+            m_max77658_pm_cache_put(ctx, reg, burst[reg - start]);
+         }
+      }
+      start = last + 1;
+   }
 
    return ret;
 }
@@ -134,7 +535,7 @@ int32_t max77658_pm_get_INT_GLBL1(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_INT_GLBL1, &data);
    if(ret > -1)
    {
-      ret = data & 0xb01111111;
+      ret = data & MAX77658_PM_USED_INT_GLBL1;
    }
 
    return ret;
@@ -177,7 +578,7 @@ int32_t max77658_pm_get_DIDM(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_STAT_GLBL, &data);
    if(ret > -1)
    {
-      ret = (data << 7) & 0x0b00000001;
+      ret = MAX77658_PM_FIELD_GET(STAT_GLBL, DIDM, data);
    }
 
    return ret;
@@ -199,7 +600,7 @@ int32_t max77658_pm_get_BOK(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_STAT_GLBL, &data);
    if(ret > -1)
    {
-      ret = (data << 6) & 0x0b00000001;
+      ret = MAX77658_PM_FIELD_GET(STAT_GLBL, BOK, data);
    }
 
    return ret;
@@ -221,7 +622,7 @@ int32_t max77658_pm_get_DOD0_S(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_STAT_GLBL, &data);
    if(ret > -1)
    {
-      ret = (data << 5) & 0x0b00000001;
+      ret = MAX77658_PM_FIELD_GET(STAT_GLBL, DOD0_S, data);
    }
 
    return ret;
@@ -243,7 +644,7 @@ int32_t max77658_pm_get_DOD1_S(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_STAT_GLBL, &data);
    if(ret > -1)
    {
-      ret = (data << 4) & 0x0b00000001;
+      ret = MAX77658_PM_FIELD_GET(STAT_GLBL, DOD1_S, data);
    }
 
    return ret;
@@ -265,7 +666,7 @@ int32_t max77658_pm_get_TJAL2_S(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_STAT_GLBL, &data);
    if(ret > -1)
    {
-      ret = (data << 3) & 0x0b00000001;
+      ret = MAX77658_PM_FIELD_GET(STAT_GLBL, TJAL2_S, data);
    }
 
    return ret;
@@ -287,7 +688,7 @@ int32_t max77658_pm_get_TJAL1_S(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_STAT_GLBL, &data);
    if(ret > -1)
    {
-      ret = (data << 2) & 0x0b00000001;
+      ret = MAX77658_PM_FIELD_GET(STAT_GLBL, TJAL1_S, data);
    }
 
    return ret;
@@ -309,7 +710,7 @@ int32_t max77658_pm_get_STAT_EN(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_STAT_GLBL, &data);
    if(ret > -1)
    {
-      ret = (data << 1) & 0x0b00000001;
+      ret = MAX77658_PM_FIELD_GET(STAT_GLBL, STAT_EN, data);
    }
 
    return ret;
@@ -331,7 +732,7 @@ int32_t max77658_pm_get_STAT_IRQ(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_STAT_GLBL, &data);
    if(ret > -1)
    {
-      ret = data & 0x0b00000001;
+      ret = MAX77658_PM_FIELD_GET(STAT_GLBL, STAT_IRQ, data);
    }
 
    return ret;
@@ -375,7 +776,7 @@ int32_t max77658_pm_get_INTM_GLBL1(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_INTM_GLBL1, &data);
    if(ret > -1)
    {
-      ret = data & 0b01111111;
+      ret = data & MAX77658_PM_USED_INTM_GLBL1;
    }
 
    return ret;
@@ -397,7 +798,7 @@ int32_t max77658_pm_get_PU_DIS(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GLBL, &data);
    if(ret > -1)
    {
-      ret = (data >> 7) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GLBL, PU_DIS, data);
    }
 
    return ret;
@@ -418,7 +819,7 @@ int32_t max77658_pm_get_T_MRST(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GLBL, &data);
    if(ret > -1)
    {
-      ret = (data >> 6) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GLBL, T_MRST, data);
    }
 
    return ret;
@@ -441,7 +842,7 @@ int32_t max77658_pm_get_SBIA_LPM(max77658_pm_t *ctx)
 
    if(ret > -1)
    {
-      ret = (data >> 5) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GLBL, SBIA_LPM, data);
    }
 
    return ret;
@@ -465,7 +866,7 @@ int32_t max77658_pm_get_nEN_MODE(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GLBL, &data);
    if(ret > -1)
    {
-      ret = (data >> 3) & 0b00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GLBL, nEN_MODE, data);
    }
 
    return ret;
@@ -487,7 +888,7 @@ int32_t max77658_pm_get_DBEN_nEN(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GLBL, &data);
    if(ret > -1)
    {
-      ret = (data >> 3) & 0b00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GLBL, DBEN_nEN, data);
    }
 
    return ret;
@@ -508,7 +909,7 @@ int32_t max77658_pm_get_SFT_CTRL(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GLBL, &data);
    if(ret > -1)
    {
-      ret = data & 0b00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GLBL, SFT_CTRL, data);
    }
 
    return ret;
@@ -530,7 +931,7 @@ int32_t max77658_pm_get_SBB_F_SHUTDN(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO0, &data);
    if(ret > -1)
    {
-      ret = (data >> 7) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO0, SBB_F_SHUTDN, data);
    }
 
    return ret;
@@ -552,7 +953,7 @@ int32_t max77658_pm_get_ALT_GPIO0(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO0, &data);
    if(ret > -1)
    {
-      ret = (data >> 5) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO0, ALT_GPIO, data);
    }
 
    return ret;
@@ -574,7 +975,7 @@ int32_t max77658_pm_get_DBEN_GPI_0(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO0, &data);
    if(ret > -1)
    {
-      ret = (data >> 4) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO0, DBEN_GPI, data);
    }
 
    return ret;
@@ -598,7 +999,7 @@ int32_t max77658_pm_get_DO_0(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO0, &data);
    if(ret > -1)
    {
-      ret = (data >> 3) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO0, DO, data);
    }
 
    return ret;
@@ -621,7 +1022,7 @@ int32_t max77658_pm_get_DRV_0(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO0, &data);
    if(ret > -1)
    {
-      ret = (data >> 2) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO0, DRV, data);
    }
 
    return ret;
@@ -644,7 +1045,7 @@ int32_t max77658_pm_get_DI_0(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO0, &data);
    if(ret > -1)
    {
-      ret = (data >> 1) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO0, DI, data);
    }
 
    return ret;
@@ -666,7 +1067,7 @@ int32_t max77658_pm_get_DIR_0(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO0, &data);
    if(ret > -1)
    {
-      ret = data & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO0, DIR, data);
    }
 
    return ret;
@@ -689,7 +1090,7 @@ int32_t max77658_pm_get_ALT_GPIO1(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO1, &data);
    if(ret > -1)
    {
-      ret = (data >> 5) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO1, ALT_GPIO, data);
    }
 
    return ret;
@@ -711,7 +1112,7 @@ int32_t max77658_pm_get_DBEN_GPI_1(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO1, &data);
    if(ret > -1)
    {
-      ret = (data >> 4) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO1, DBEN_GPI, data);
    }
 
    return ret;
@@ -735,7 +1136,7 @@ int32_t max77658_pm_get_DO_1(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO1, &data);
    if(ret > -1)
    {
-      ret = (data >> 3) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO1, DO, data);
    }
 
    return ret;
@@ -758,7 +1159,7 @@ int32_t max77658_pm_get_DRV_1(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO1, &data);
    if(ret > -1)
    {
-      ret = (data >> 2) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO1, DRV, data);
    }
 
    return ret;
@@ -781,7 +1182,7 @@ int32_t max77658_pm_get_DI_1(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO1, &data);
    if(ret > -1)
    {
-      ret = (data >> 1) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO1, DI, data);
    }
 
    return ret;
@@ -803,7 +1204,7 @@ int32_t max77658_pm_get_DIR_1(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO1, &data);
    if(ret > -1)
    {
-      ret = data & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO1, DIR, data);
    }
 
    return ret;
@@ -825,7 +1226,7 @@ int32_t max77658_pm_get_ALT_GPIO2(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO2, &data);
    if(ret > -1)
    {
-      ret = (data >> 5) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO2, ALT_GPIO, data);
    }
 
    return ret;
@@ -847,7 +1248,7 @@ int32_t max77658_pm_get_DBEN_GPI_2(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO2, &data);
    if(ret > -1)
    {
-      ret = (data >> 4) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO2, DBEN_GPI, data);
    }
 
    return ret;
@@ -871,7 +1272,7 @@ int32_t max77658_pm_get_DO_2(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO2, &data);
    if(ret > -1)
    {
-      ret = (data >> 3) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO2, DO, data);
    }
 
    return ret;
@@ -894,7 +1295,7 @@ int32_t max77658_pm_get_DRV_2(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO2, &data);
    if(ret > -1)
    {
-      ret = (data >> 2) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO2, DRV, data);
    }
 
    return ret;
@@ -917,7 +1318,7 @@ int32_t max77658_pm_get_DI_2(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO2, &data);
    if(ret > -1)
    {
-      ret = (data >> 1) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO2, DI, data);
    }
 
    return ret;
@@ -939,7 +1340,7 @@ int32_t max77658_pm_get_DIR_2(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO2, &data);
    if(ret > -1)
    {
-      ret = data & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_GPIO2, DIR, data);
    }
 
    return ret;
@@ -961,7 +1362,7 @@ int32_t max77658_pm_get_CID(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CID, &data);
    if(ret > -1)
    {
-      ret = data & 0b00001111;
+      ret = MAX77658_PM_FIELD_GET(CID, CID, data);
    }
 
    return ret;
@@ -985,7 +1386,7 @@ int32_t max77658_pm_get_WDT_PER(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_WDT, &data);
    if(ret > -1)
    {
-      ret = (data >> 4) & 0b00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_WDT, WDT_PER, data);
    }
 
    return ret;
@@ -1007,7 +1408,7 @@ int32_t max77658_pm_get_WDT_MODE(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_WDT, &data);
    if(ret > -1)
    {
-      ret = (data >> 3) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_WDT, WDT_MODE, data);
    }
 
    return ret;
@@ -1029,7 +1430,7 @@ int32_t max77658_pm_get_WDT_CLR(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_WDT, &data);
    if(ret > -1)
    {
-      ret = (data >> 2) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_WDT, WDT_CLR, data);
    }
 
    return ret;
@@ -1051,7 +1452,7 @@ int32_t max77658_pm_get_WDT_EN(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_WDT, &data);
    if(ret > -1)
    {
-      ret = (data >> 1) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_WDT, WDT_EN, data);
    }
 
    return ret;
@@ -1073,7 +1474,7 @@ int32_t max77658_pm_get_WDT_LOCK(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_WDT, &data);
    if(ret > -1)
    {
-      ret = data & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_WDT, WDT_LOCK, data);
    }
 
    return ret;
@@ -1100,7 +1501,7 @@ int32_t max77658_pm_get_SYS_CNFG_I(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_INT_CHG, &data);
    if(ret > -1)
    {
-      ret = (data >> 6) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(INT_CHG, SYS_CNFG_I, data);
    }
 
    return ret;
@@ -1123,7 +1524,7 @@ int32_t max77658_pm_get_SYS_CTRL_I(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_INT_CHG, &data);
    if(ret > -1)
    {
-      ret = (data >> 5) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(INT_CHG, SYS_CTRL_I, data);
    }
 
    return ret;
@@ -1146,7 +1547,7 @@ int32_t max77658_pm_get_CHGIN_CTRL_I(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_INT_CHG, &data);
    if(ret > -1)
    {
-      ret = (data >> 4) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(INT_CHG, CHGIN_CTRL_I, data);
    }
 
    return ret;
@@ -1169,7 +1570,7 @@ int32_t max77658_pm_get_TJ_REG_I(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_INT_CHG, &data);
    if(ret > -1)
    {
-      ret = (data >> 3) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(INT_CHG, TJ_REG_I, data);
    }
 
    return ret;
@@ -1192,7 +1593,7 @@ int32_t max77658_pm_get_CHGIN_I(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_INT_CHG, &data);
    if(ret > -1)
    {
-      ret = (data >> 2) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(INT_CHG, CHGIN_I, data);
    }
 
    return ret;
@@ -1215,7 +1616,7 @@ int32_t max77658_pm_get_CHG_I(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_INT_CHG, &data);
    if(ret > -1)
    {
-      ret = (data >> 1) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(INT_CHG, CHG_I, data);
    }
 
    return ret;
@@ -1238,7 +1639,7 @@ int32_t max77658_pm_get_THM_I(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_INT_CHG, &data);
    if(ret > -1)
    {
-      ret = data & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(INT_CHG, THM_I, data);
    }
 
    return ret;
@@ -1261,7 +1662,7 @@ int32_t max77658_pm_get_VCHGIN_MIN_STAT(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_STAT_CHG_A, &data);
    if(ret > -1)
    {
-      ret = (data >> 6) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(STAT_CHG_A, VCHGIN_MIN_STAT, data);
    }
 
    return ret;
@@ -1284,7 +1685,7 @@ int32_t max77658_pm_get_ICHGIN_LIM_STAT(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_STAT_CHG_A, &data);
    if(ret > -1)
    {
-      ret = (data >> 5) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(STAT_CHG_A, ICHGIN_LIM_STAT, data);
    }
 
    return ret;
@@ -1307,7 +1708,7 @@ int32_t max77658_pm_get_VSYS_MIN_STAT(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_STAT_CHG_A, &data);
    if(ret > -1)
    {
-      ret = (data >> 4) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(STAT_CHG_A, VSYS_MIN_STAT, data);
    }
 
    return ret;
@@ -1330,7 +1731,7 @@ int32_t max77658_pm_get_TJ_REG_STAT(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_STAT_CHG_A, &data);
    if(ret > -1)
    {
-      ret = (data >> 3) & 0b00000001;
+      ret = MAX77658_PM_FIELD_GET(STAT_CHG_A, TJ_REG_STAT, data);
    }
 
    return ret;
@@ -1358,7 +1759,7 @@ int32_t max77658_pm_get_THM_DTLS(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_STAT_CHG_A, &data);
    if(ret > -1)
    {
-      ret = (data >> 2) & 0b0000111;
+      ret = MAX77658_PM_FIELD_GET(STAT_CHG_A, THM_DTLS, data);
    }
 
    return ret;
@@ -1393,7 +1794,7 @@ int32_t max77658_pm_get_CHG_DTLS(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_STAT_CHG_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 4) & 0b0001111;
+      ret = MAX77658_PM_FIELD_GET(STAT_CHG_B, CHG_DTLS, data);
    }
 
    return ret;
@@ -1418,7 +1819,7 @@ int32_t max77658_pm_get_CHGIN_DTLS(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_STAT_CHG_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 2) & 0b0000011;
+      ret = MAX77658_PM_FIELD_GET(STAT_CHG_B, CHGIN_DTLS, data);
    }
 
    return ret;
@@ -1441,7 +1842,7 @@ int32_t max77658_pm_get_CHG(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_STAT_CHG_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 1) & 0b0000001;
+      ret = MAX77658_PM_FIELD_GET(STAT_CHG_B, CHG, data);
    }
 
    return ret;
@@ -1466,7 +1867,7 @@ int32_t max77658_pm_get_TIME_SUS(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_STAT_CHG_B, &data);
    if(ret > -1)
    {
-      ret = data & 0b0000001;
+      ret = MAX77658_PM_FIELD_GET(STAT_CHG_B, TIME_SUS, data);
    }
 
    return ret;
@@ -1511,7 +1912,7 @@ int32_t max77658_pm_get_THM_HOT(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_A, &data);
    if(ret > -1)
    {
-      ret = (data >> 6) & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_A, THM_HOT, data);
    }
 
    return ret;
@@ -1535,7 +1936,7 @@ int32_t max77658_pm_get_THM_WARM(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_A, &data);
    if(ret > -1)
    {
-      ret = (data >> 4) & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_A, THM_WARM, data);
    }
 
    return ret;
@@ -1559,7 +1960,7 @@ int32_t max77658_pm_get_THM_COOL(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_A, &data);
    if(ret > -1)
    {
-      ret = (data >> 2) & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_A, THM_COOL, data);
    }
 
    return ret;
@@ -1583,7 +1984,7 @@ int32_t max77658_pm_get_THM_COLD(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_A, &data);
    if(ret > -1)
    {
-      ret = data & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_A, THM_COLD, data);
    }
 
    return ret;
@@ -1611,7 +2012,7 @@ int32_t max77658_pm_get_VCHGIN_MIN(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 5) & 0xb00000111;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_B, VCHGIN_MIN, data);
    }
 
    return ret;
@@ -1637,7 +2038,7 @@ int32_t max77658_pm_get_ICHGIN_LIM(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 2) & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_B, ICHGIN_LIM, data);
    }
 
    return ret;
@@ -1659,7 +2060,7 @@ int32_t max77658_pm_get_I_PQ(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 2) & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_B, I_PQ, data);
    }
 
    return ret;
@@ -1682,7 +2083,7 @@ int32_t max77658_pm_get_CHG_EN(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_B, &data);
    if(ret > -1)
    {
-      ret = data & 0xb00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_B, CHG_EN, data);
    }
 
    return ret;
@@ -1710,7 +2111,7 @@ int32_t max77658_pm_get_CHG_PQ(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_C, &data);
    if(ret > -1)
    {
-      ret = (data >> 5) & 0xb00000111;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_C, CHG_PQ, data);
    }
 
    return ret;
@@ -1735,7 +2136,7 @@ int32_t max77658_pm_get_I_TERM(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_C, &data);
    if(ret > -1)
    {
-      ret = (data >> 3) & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_C, I_TERM, data);
    }
 
    return ret;
@@ -1763,7 +2164,7 @@ int32_t max77658_pm_get_T_TOPOFF(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_C, &data);
    if(ret > -1)
    {
-      ret = data & 0xb00000111;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_C, T_TOPOFF, data);
    }
 
    return ret;
@@ -1788,7 +2189,7 @@ int32_t max77658_pm_get_TJ_REG(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_D, &data);
    if(ret > -1)
    {
-      ret = (data >> 5) & 0xb00000111;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_D, TJ_REG, data);
    }
 
    return ret;
@@ -1810,7 +2211,7 @@ int32_t max77658_pm_get_VSYS_REG(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_D, &data);
    if(ret > -1)
    {
-      ret = data & 0xb00011111;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_D, VSYS_REG, data);
    }
 
    return ret;
@@ -1832,7 +2233,7 @@ int32_t max77658_pm_get_CHG_CC(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_E, &data);
    if(ret > -1)
    {
-      ret = (data >> 2) & 0xb00111111;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_E, CHG_CC, data);
    }
 
    return ret;
@@ -1856,7 +2257,7 @@ int32_t max77658_pm_get_T_FAST_CHG(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_E, &data);
    if(ret > -1)
    {
-      ret = data & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_E, T_FAST_CHG, data);
    }
 
    return ret;
@@ -1880,7 +2281,7 @@ int32_t max77658_pm_get_CHG_CC_JEITA(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_F, &data);
    if(ret > -1)
    {
-      ret = (data >> 2) & 0xb00111111;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_F, CHG_CC_JEITA, data);
    }
 
    return ret;
@@ -1902,7 +2303,7 @@ int32_t max77658_pm_get_CHG_CV(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_G, &data);
    if(ret > -1)
    {
-      ret = (data >> 2) & 0xb00111111;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_G, CHG_CV, data);
    }
 
    return ret;
@@ -1925,7 +2326,7 @@ int32_t max77658_pm_get_USBS(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_G, &data);
    if(ret > -1)
    {
-      ret = (data >> 1) & 0xb00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_G, USBS, data);
    }
 
    return ret;
@@ -1946,7 +2347,7 @@ int32_t max77658_pm_get_FUS_M(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_G, &data);
    if(ret > -1)
    {
-      ret = data & 0xb00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_G, FUS_M, data);
    }
 
    return ret;
@@ -1969,7 +2370,7 @@ int32_t max77658_pm_get_CHG_CV_JEITA(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_H, &data);
    if(ret > -1)
    {
-      ret = (data >> 2) & 0xb00111111;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_H, CHG_CV_JEITA, data);
    }
 
    return ret;
@@ -1993,7 +2394,7 @@ int32_t max77658_pm_get_SYS_BAT_PRT(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_H, &data);
    if(ret > -1)
    {
-      ret = (data >> 1) & 0xb00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_H, SYS_BAT_PRT, data);
    }
 
    return ret;
@@ -2013,7 +2414,7 @@ int32_t max77658_pm_get_CHR_TH_EN(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_H, &data);
    if(ret > -1)
    {
-      ret = data & 0xb00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_H, CHR_TH_EN, data);
    }
 
    return ret;
@@ -2044,7 +2445,7 @@ int32_t max77658_pm_get_IMON_DISCHG_SCALE(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_I, &data);
    if(ret > -1)
    {
-      ret = (data >> 4) & 0xb00001111;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_I, IMON_DISCHG_SCALE, data);
    }
 
    return ret;
@@ -2075,7 +2476,7 @@ int32_t max77658_pm_get_MUX_SEL(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_I, &data);
    if(ret > -1)
    {
-      ret = data & 0xb00001111;
+      ret = MAX77658_PM_FIELD_GET(CNFG_CHG_I, MUX_SEL, data);
    }
 
    return ret;
@@ -2097,7 +2498,7 @@ int32_t max77658_pm_get_DIS_LPM(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB_TOP, &data);
    if(ret > -1)
    {
-      ret = (data >> 7) & 0xb00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB_TOP, DIS_LPM, data);
    }
 
    return ret;
@@ -2119,7 +2520,7 @@ int32_t max77658_pm_get_IPK_1P5A(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB_TOP, &data);
    if(ret > -1)
    {
-      ret = (data >> 6) & 0xb00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB_TOP, IPK_1P5A, data);
    }
 
    return ret;
@@ -2143,7 +2544,7 @@ int32_t max77658_pm_get_DRV_SBB(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB_TOP, &data);
    if(ret > -1)
    {
-      ret = data & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB_TOP, DRV_SBB, data);
    }
 
    return ret;
@@ -2164,7 +2565,7 @@ int32_t max77658_pm_get_TV_SBB0(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB0_A, &data);
    if(ret > -1)
    {
-      ret = data;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB0_A, TV_SBB0, data);
    }
 
    return ret;
@@ -2188,7 +2589,7 @@ int32_t max77658_pm_get_OP_MODE(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB0_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 6) & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB0_B, OP_MODE, data);
    }
 
    return ret;
@@ -2212,7 +2613,7 @@ int32_t max77658_pm_get_IP_SBB0(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB0_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 4) & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB0_B, IP_SBB0, data);
    }
 
    return ret;
@@ -2237,7 +2638,7 @@ int32_t max77658_pm_get_ADE_SBB0(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB0_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 3) & 0xb00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB0_B, ADE_SBB0, data);
    }
 
    return ret;
@@ -2266,7 +2667,7 @@ int32_t max77658_pm_get_EN_SBB0(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB0_B, &data);
    if(ret > -1)
    {
-      ret = data & 0xb00000111;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB0_B, EN_SBB0, data);
    }
 
    return ret;
@@ -2287,7 +2688,7 @@ int32_t max77658_pm_get_TV_SBB1(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB1_A, &data);
    if(ret > -1)
    {
-      ret = data;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB1_A, TV_SBB1, data);
    }
 
    return ret;
@@ -2311,7 +2712,7 @@ int32_t max77658_pm_get_OP_MODE_1(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB1_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 6) & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB1_B, OP_MODE, data);
    }
 
    return ret;
@@ -2335,7 +2736,7 @@ int32_t max77658_pm_get_IP_SBB1(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB1_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 4) & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB1_B, IP_SBB1, data);
    }
 
    return ret;
@@ -2360,7 +2761,7 @@ int32_t max77658_pm_get_ADE_SBB1(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB1_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 3) & 0xb00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB1_B, ADE_SBB1, data);
    }
 
    return ret;
@@ -2389,7 +2790,7 @@ int32_t max77658_pm_get_EN_SBB1(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB1_B, &data);
    if(ret > -1)
    {
-      ret = data & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB1_B, EN_SBB1, data);
    }
 
    return ret;
@@ -2410,7 +2811,7 @@ int32_t max77658_pm_get_TV_SBB2(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB2_A, &data);
    if(ret > -1)
    {
-      ret = data;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB2_A, TV_SBB2, data);
    }
 
    return ret;
@@ -2434,7 +2835,7 @@ int32_t max77658_pm_get_OP_MODE_2(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB2_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 6) & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB2_B, OP_MODE, data);
    }
 
    return ret;
@@ -2458,7 +2859,7 @@ int32_t max77658_pm_get_IP_SBB2(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB2_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 4) & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB2_B, IP_SBB2, data);
    }
 
    return ret;
@@ -2480,7 +2881,7 @@ int32_t max77658_pm_get_ADE_SBB2(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB2_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 3) & 0xb00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB2_B, ADE_SBB2, data);
    }
 
    return ret;
@@ -2509,7 +2910,7 @@ int32_t max77658_pm_get_EN_SBB2(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB2_B, &data);
    if(ret > -1)
    {
-      ret = data & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_SBB2_B, EN_SBB2, data);
    }
 
    return ret;
@@ -2553,7 +2954,7 @@ int32_t max77658_pm_get_TV_OFS_LDO0(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO0_A, &data);
    if(ret > -1)
    {
-      ret = (data >> 7) & 0xb00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_LDO0_A, TV_OFS_LDO0, data);
    }
 
    return ret;
@@ -2575,7 +2976,7 @@ int32_t max77658_pm_get_TV_LDO0(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO0_A, &data);
    if(ret > -1)
    {
-      ret = data & 0xb01111111;
+      ret = MAX77658_PM_FIELD_GET(CNFG_LDO0_A, TV_LDO0, data);
    }
 
    return ret;
@@ -2597,7 +2998,7 @@ int32_t max77658_pm_get_LDO0_MD(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO0_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 4) & 0xb00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_LDO0_B, LDO0_MD, data);
    }
 
    return ret;
@@ -2619,7 +3020,7 @@ int32_t max77658_pm_get_ADE_LDO0(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO0_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 3) & 0xb00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_LDO0_B, ADE_LDO0, data);
    }
 
    return ret;
@@ -2648,7 +3049,7 @@ int32_t max77658_pm_get_EN_LDO0(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO0_B, &data);
    if(ret > -1)
    {
-      ret = data & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_LDO0_B, EN_LDO0, data);
    }
 
    return ret;
@@ -2671,7 +3072,7 @@ int32_t max77658_pm_get_TV_OFS_LDO1(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO1_A, &data);
    if(ret > -1)
    {
-      ret = (data > 6) & 0xb00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_LDO1_A, TV_OFS_LDO1, data);
    }
 
    return ret;
@@ -2693,7 +3094,7 @@ int32_t max77658_pm_get_TV_LDO1(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO1_A, &data);
    if(ret > -1)
    {
-      ret = data & 0xb01111111;
+      ret = MAX77658_PM_FIELD_GET(CNFG_LDO1_A, TV_LDO1, data);
    }
 
    return ret;
@@ -2715,7 +3116,7 @@ int32_t max77658_pm_get_LDO1_MD(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO1_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 4) & 0xb00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_LDO1_B, LDO1_MD, data);
    }
 
    return ret;
@@ -2737,7 +3138,7 @@ int32_t max77658_pm_get_ADE_LDO1(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO1_B, &data);
    if(ret > -1)
    {
-      ret = (data >> 3) & 0xb00000001;
+      ret = MAX77658_PM_FIELD_GET(CNFG_LDO1_B, ADE_LDO1, data);
    }
 
    return ret;
@@ -2766,7 +3167,7 @@ int32_t max77658_pm_get_EN_LDO1(max77658_pm_t *ctx)
    ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO1_B, &data);
    if(ret > -1)
    {
-      ret = data & 0xb00000011;
+      ret = MAX77658_PM_FIELD_GET(CNFG_LDO1_B, EN_LDO1, data);
    }
 
    return ret;
@@ -2786,11 +3187,8 @@ int32_t max77658_pm_get_EN_LDO1(max77658_pm_t *ctx)
 int32_t max77658_pm_set_INTM_GLBL0(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t write_data[1];
 
-   write_data[0] = target_val;
-   ret = max77658_pm_write_reg(ctx, MAX77658_INTM_GLBL0, write_data);
-   ret = (max77658_pm_get_INTM_GLBL0(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_INTM_GLBL0, 0b11111111, target_val);
 
    return ret;
 }
@@ -2805,11 +3203,8 @@ int32_t max77658_pm_set_INTM_GLBL0(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_INTM_GLBL1(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t write_data[1];
 
-   write_data[0] = target_val;
-   ret = max77658_pm_write_reg(ctx, MAX77658_INTM_GLBL1, write_data);
-   ret = (max77658_pm_get_INTM_GLBL1(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_INTM_GLBL1, 0b11111111, target_val);
 
    return ret;
 }
@@ -2826,13 +3221,8 @@ int32_t max77658_pm_set_INTM_GLBL1(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_PU_DIS(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GLBL, &curr_data);
-   write_data[0] = (curr_data & 0b01111111) | ((target_val & 0b00000001) << 7);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GLBL, write_data);
-   ret = (max77658_pm_get_PU_DIS(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GLBL, MAX77658_CNFG_GLBL_PU_DIS_MASK, MAX77658_PM_FIELD_PREP(CNFG_GLBL, PU_DIS, target_val));
 
    return ret;
 }
@@ -2849,13 +3239,8 @@ int32_t max77658_pm_set_PU_DIS(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_T_MRST(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GLBL, &curr_data);
-   write_data[0] = (curr_data & 0b10111111) | ((target_val & 0b00000001) << 6);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GLBL, write_data);
-   ret = (max77658_pm_get_T_MRST(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GLBL, MAX77658_CNFG_GLBL_T_MRST_MASK, MAX77658_PM_FIELD_PREP(CNFG_GLBL, T_MRST, target_val));
 
    return ret;
 }
@@ -2872,13 +3257,8 @@ int32_t max77658_pm_set_T_MRST(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_SBIA_LPM(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data = 0xFF;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GLBL, &curr_data);
-   write_data[0]  = (curr_data & 0b11011111) | ((target_val & 0b00000001) << 5);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GLBL, write_data);
-   ret = (max77658_pm_get_SBIA_LPM(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GLBL, MAX77658_CNFG_GLBL_SBIA_LPM_MASK, MAX77658_PM_FIELD_PREP(CNFG_GLBL, SBIA_LPM, target_val));
 
    return ret;
 }
@@ -2897,13 +3277,8 @@ int32_t max77658_pm_set_SBIA_LPM(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_nEN_MODE(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GLBL, &curr_data);
-   write_data[0] = (curr_data & 0b11100111) | ((target_val & 0b00000011) << 3);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GLBL, write_data);
-   ret = (max77658_pm_get_nEN_MODE(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GLBL, MAX77658_CNFG_GLBL_nEN_MODE_MASK, MAX77658_PM_FIELD_PREP(CNFG_GLBL, nEN_MODE, target_val));
 
    return ret;
 }
@@ -2919,13 +3294,8 @@ int32_t max77658_pm_set_nEN_MODE(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_DBEN_nEN(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GLBL, &curr_data);
-   write_data[0] = (curr_data & 0b11111011) | ((target_val & 0b00000001) << 2);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GLBL, write_data);
-   ret = (max77658_pm_get_DBEN_nEN(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GLBL, MAX77658_CNFG_GLBL_DBEN_nEN_MASK, MAX77658_PM_FIELD_PREP(CNFG_GLBL, DBEN_nEN, target_val));
 
    return ret;
 }
@@ -2940,13 +3310,8 @@ int32_t max77658_pm_set_DBEN_nEN(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_SFT_CTRL(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GLBL, &curr_data);
-   write_data[0] = (curr_data & 0b11111100) | ((target_val & 0b00000011) << 0);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GLBL, write_data);
-   ret = (max77658_pm_get_SFT_CTRL(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GLBL, MAX77658_CNFG_GLBL_SFT_CTRL_MASK, MAX77658_PM_FIELD_PREP(CNFG_GLBL, SFT_CTRL, target_val));
 
    return ret;
 }
@@ -2962,13 +3327,8 @@ int32_t max77658_pm_set_SFT_CTRL(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_SBB_F_SHUTDN(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO0, &curr_data);
-   write_data[0] = (curr_data & 0b01111111) | ((target_val & 0b00000001) << 7);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GPIO0, write_data);
-   ret = (max77658_pm_get_SBB_F_SHUTDN(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GPIO0, MAX77658_CNFG_GPIO0_SBB_F_SHUTDN_MASK, MAX77658_PM_FIELD_PREP(CNFG_GPIO0, SBB_F_SHUTDN, target_val));
 
    return ret;
 }
@@ -2984,13 +3344,8 @@ int32_t max77658_pm_set_SBB_F_SHUTDN(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_ALT_GPIO0(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO0, &curr_data);
-   write_data[0] = (curr_data & 0b11011111) | ((target_val & 0b00000001) << 5);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GPIO0, write_data);
-   ret = (max77658_pm_get_ALT_GPIO0(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GPIO0, MAX77658_CNFG_GPIO0_ALT_GPIO_MASK, MAX77658_PM_FIELD_PREP(CNFG_GPIO0, ALT_GPIO, target_val));
 
    return ret;
 }
@@ -3006,13 +3361,8 @@ int32_t max77658_pm_set_ALT_GPIO0(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_DBEN_GPI_0(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO0, &curr_data);
-   write_data[0] = (curr_data & 0b11101111) | ((target_val & 0b00000001) << 4);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GPIO0, write_data);
-   ret = (max77658_pm_get_DBEN_GPI_0(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GPIO0, MAX77658_CNFG_GPIO0_DBEN_GPI_MASK, MAX77658_PM_FIELD_PREP(CNFG_GPIO0, DBEN_GPI, target_val));
 
    return ret;
 }
@@ -3030,13 +3380,8 @@ int32_t max77658_pm_set_DBEN_GPI_0(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_DO_0(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO0, &curr_data);
-   write_data[0] = (curr_data & 0b11110111) | ((target_val & 0b00000001) << 3);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GPIO0, write_data);
-   ret = (max77658_pm_get_DO_0(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GPIO0, MAX77658_CNFG_GPIO0_DO_MASK, MAX77658_PM_FIELD_PREP(CNFG_GPIO0, DO, target_val));
 
    return ret;
 }
@@ -3053,13 +3398,8 @@ int32_t max77658_pm_set_DO_0(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_DRV_0(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO0, &curr_data);
-   write_data[0] = (curr_data & 0b11111011) | ((target_val & 0b00000001) << 2);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GPIO0, write_data);
-   ret = (max77658_pm_get_DRV_0(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GPIO0, MAX77658_CNFG_GPIO0_DRV_MASK, MAX77658_PM_FIELD_PREP(CNFG_GPIO0, DRV, target_val));
 
    return ret;
 }
@@ -3075,13 +3415,8 @@ int32_t max77658_pm_set_DRV_0(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_DIR_0(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO0, &curr_data);
-   write_data[0] = (curr_data & 0b11111110) | ((target_val & 0b00000001) << 0);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GPIO0, write_data);
-   ret = (max77658_pm_get_DIR_0(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GPIO0, MAX77658_CNFG_GPIO0_DIR_MASK, MAX77658_PM_FIELD_PREP(CNFG_GPIO0, DIR, target_val));
 
    return ret;
 }
@@ -3098,13 +3433,8 @@ int32_t max77658_pm_set_DIR_0(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_ALT_GPIO1(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO1, &curr_data);
-   write_data[0] = (curr_data & 0b11011111) | ((target_val & 0b00000001) << 5);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GPIO1, write_data);
-   ret = (max77658_pm_get_ALT_GPIO1(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GPIO1, MAX77658_CNFG_GPIO1_ALT_GPIO_MASK, MAX77658_PM_FIELD_PREP(CNFG_GPIO1, ALT_GPIO, target_val));
 
    return ret;
 }
@@ -3120,13 +3450,8 @@ int32_t max77658_pm_set_ALT_GPIO1(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_DBEN_GPI_1(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO1, &curr_data);
-   write_data[0] = (curr_data & 0b11101111) | ((target_val & 0b00000001) << 4);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GPIO1, write_data);
-   ret = (max77658_pm_get_DBEN_GPI_1(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GPIO1, MAX77658_CNFG_GPIO1_DBEN_GPI_MASK, MAX77658_PM_FIELD_PREP(CNFG_GPIO1, DBEN_GPI, target_val));
 
    return ret;
 }
@@ -3144,13 +3469,8 @@ int32_t max77658_pm_set_DBEN_GPI_1(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_DO_1(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO1, &curr_data);
-   write_data[0] = (curr_data & 0b11110111) | ((target_val & 0b00000001) << 3);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GPIO1, write_data);
-   ret = (max77658_pm_get_DO_1(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GPIO1, MAX77658_CNFG_GPIO1_DO_MASK, MAX77658_PM_FIELD_PREP(CNFG_GPIO1, DO, target_val));
 
    return ret;
 }
@@ -3167,14 +3487,9 @@ int32_t max77658_pm_set_DO_1(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_DRV_1(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO1, &curr_data);
-   write_data[0] = (curr_data & 0b11111011) | ((target_val & 0b00000001) << 2);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GPIO1, write_data);
-   ret = (max77658_pm_get_DRV_1(ctx) == target_val)?SUCCESS:ERROR;
-   
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GPIO1, MAX77658_CNFG_GPIO1_DRV_MASK, MAX77658_PM_FIELD_PREP(CNFG_GPIO1, DRV, target_val));
+
    return ret;
 }
 
@@ -3189,13 +3504,8 @@ int32_t max77658_pm_set_DRV_1(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_DIR_1(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO1, &curr_data);
-   write_data[0] = (curr_data & 0b11111110) | ((target_val & 0b00000001) << 0);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GPIO1, write_data);
-   ret = (max77658_pm_get_DIR_1(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GPIO1, MAX77658_CNFG_GPIO1_DIR_MASK, MAX77658_PM_FIELD_PREP(CNFG_GPIO1, DIR, target_val));
 
    return ret;
 }
@@ -3211,13 +3521,8 @@ int32_t max77658_pm_set_DIR_1(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_ALT_GPIO2(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO2, &curr_data);
-   write_data[0] = (curr_data & 0b11011111) | ((target_val & 0b00000001) << 5);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GPIO2, write_data);
-   ret = (max77658_pm_get_ALT_GPIO2(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GPIO2, MAX77658_CNFG_GPIO2_ALT_GPIO_MASK, MAX77658_PM_FIELD_PREP(CNFG_GPIO2, ALT_GPIO, target_val));
 
    return ret;
 }
@@ -3233,13 +3538,8 @@ int32_t max77658_pm_set_ALT_GPIO2(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_DBEN_GPI_2(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO2, &curr_data);
-   write_data[0] = (curr_data & 0b11101111) | ((target_val & 0b00000001) << 4);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GPIO2, write_data);
-   ret = (max77658_pm_get_DBEN_GPI_2(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GPIO2, MAX77658_CNFG_GPIO2_DBEN_GPI_MASK, MAX77658_PM_FIELD_PREP(CNFG_GPIO2, DBEN_GPI, target_val));
 
    return ret;
 }
@@ -3257,13 +3557,8 @@ int32_t max77658_pm_set_DBEN_GPI_2(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_DO_2(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO2, &curr_data);
-   write_data[0] = (curr_data & 0b11110111) | ((target_val & 0b00000001) << 3);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GPIO2, write_data);
-   ret = (max77658_pm_get_DO_2(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GPIO2, MAX77658_CNFG_GPIO2_DO_MASK, MAX77658_PM_FIELD_PREP(CNFG_GPIO2, DO, target_val));
 
    return ret;
 }
@@ -3280,13 +3575,8 @@ int32_t max77658_pm_set_DO_2(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_DRV_2(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO2, &curr_data);
-   write_data[0] = (curr_data & 0b11111011) | ((target_val & 0b00000001) << 2);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GPIO2, write_data);
-   ret = (max77658_pm_get_DRV_2(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GPIO2, MAX77658_CNFG_GPIO2_DRV_MASK, MAX77658_PM_FIELD_PREP(CNFG_GPIO2, DRV, target_val));
 
    return ret;
 }
@@ -3302,13 +3592,8 @@ int32_t max77658_pm_set_DRV_2(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_DIR_2(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_GPIO2, &curr_data);
-   write_data[0] = (curr_data & 0b11111110) | ((target_val & 0b00000001) << 0);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_GPIO2, write_data);
-   ret = (max77658_pm_get_DIR_2(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_GPIO2, MAX77658_CNFG_GPIO2_DIR_MASK, MAX77658_PM_FIELD_PREP(CNFG_GPIO2, DIR, target_val));
 
    return ret;
 }
@@ -3326,13 +3611,8 @@ int32_t max77658_pm_set_DIR_2(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_WDT_PER(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_WDT, &curr_data);
-   write_data[0] = (curr_data & 0b11001111) | ((target_val & 0b00000011) << 4);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_WDT, write_data);
-   ret = (max77658_pm_get_WDT_PER(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_WDT, MAX77658_CNFG_WDT_WDT_PER_MASK, MAX77658_PM_FIELD_PREP(CNFG_WDT, WDT_PER, target_val));
 
    return ret;
 }
@@ -3348,13 +3628,8 @@ int32_t max77658_pm_set_WDT_PER(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_WDT_MODE(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_WDT, &curr_data);
-   write_data[0] = (curr_data & 0b11110111) | ((target_val & 0b00000001) << 3);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_WDT, write_data);
-   ret = (max77658_pm_get_WDT_MODE(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_WDT, MAX77658_CNFG_WDT_WDT_MODE_MASK, MAX77658_PM_FIELD_PREP(CNFG_WDT, WDT_MODE, target_val));
 
    return ret;
 }
@@ -3370,13 +3645,8 @@ int32_t max77658_pm_set_WDT_MODE(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_WDT_CLR(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_WDT, &curr_data);
-   write_data[0] = (curr_data & 0b11111011) | ((target_val & 0b00000001) << 2);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_WDT, write_data);
-   ret = (max77658_pm_get_WDT_CLR(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_WDT, MAX77658_CNFG_WDT_WDT_CLR_MASK, MAX77658_PM_FIELD_PREP(CNFG_WDT, WDT_CLR, target_val));
 
    return ret;
 }
@@ -3392,13 +3662,8 @@ int32_t max77658_pm_set_WDT_CLR(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_WDT_EN(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_WDT, &curr_data);
-   write_data[0] = (curr_data & 0b11111101) | ((target_val & 0b00000001) << 1);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_WDT, write_data);
-   ret = (max77658_pm_get_WDT_EN(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_WDT, MAX77658_CNFG_WDT_WDT_EN_MASK, MAX77658_PM_FIELD_PREP(CNFG_WDT, WDT_EN, target_val));
 
    return ret;
 }
@@ -3418,11 +3683,9 @@ int32_t max77658_pm_set_WDT_EN(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_INT_M_CHG(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t write_data[1];
 
-   write_data[0] = target_val;
-   ret = max77658_pm_write_reg(ctx, MAX77658_INT_M_CHG, write_data);
-   ret = (max77658_pm_get_INT_M_CHG(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_INT_M_CHG, 0b11111111, target_val);
+
    return ret;
 }
 
@@ -3439,13 +3702,8 @@ int32_t max77658_pm_set_INT_M_CHG(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_THM_HOT(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_A, &curr_data);
-   write_data[0] = (curr_data & 0b00111111) | ((target_val & 0b00000011) << 6);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_A, write_data);
-   ret = (max77658_pm_get_THM_HOT(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_A, MAX77658_CNFG_CHG_A_THM_HOT_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_A, THM_HOT, target_val));
 
    return ret;
 }
@@ -3463,13 +3721,8 @@ int32_t max77658_pm_set_THM_HOT(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_THM_WARM(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_A, &curr_data);
-   write_data[0] = (curr_data & 0b11001111) | ((target_val & 0b00000011) << 4);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_A, write_data);
-   ret = (max77658_pm_get_THM_WARM(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_A, MAX77658_CNFG_CHG_A_THM_WARM_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_A, THM_WARM, target_val));
 
    return ret;
 }
@@ -3487,13 +3740,8 @@ int32_t max77658_pm_set_THM_WARM(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_THM_COOL(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_A, &curr_data);
-   write_data[0] = (curr_data & 0b11110011) | ((target_val & 0b00000011) << 2);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_A, write_data);
-   ret = (max77658_pm_get_THM_COOL(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_A, MAX77658_CNFG_CHG_A_THM_COOL_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_A, THM_COOL, target_val));
 
    return ret;
 }
@@ -3511,13 +3759,8 @@ int32_t max77658_pm_set_THM_COOL(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_THM_COLD(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_A, &curr_data);
-   write_data[0] = (curr_data & 0b11111100) | (target_val & 0b00000011);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_A, write_data);
-   ret = (max77658_pm_get_THM_COLD(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_A, MAX77658_CNFG_CHG_A_THM_COLD_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_A, THM_COLD, target_val));
 
    return ret;
 }
@@ -3539,13 +3782,8 @@ int32_t max77658_pm_set_THM_COLD(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_VCHGIN_MIN(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_B, &curr_data);
-   write_data[0] = (curr_data & 0b00011111) | ((target_val & 0b00000111) << 5);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_B, write_data);
-   ret = (max77658_pm_get_VCHGIN_MIN(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_B, MAX77658_CNFG_CHG_B_VCHGIN_MIN_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_B, VCHGIN_MIN, target_val));
 
    return ret;
 }
@@ -3565,13 +3803,8 @@ int32_t max77658_pm_set_VCHGIN_MIN(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_ICHGIN_LIM(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_B, &curr_data);
-   write_data[0] = (curr_data & 0b11100011) | ((target_val & 0b00000111) << 2);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_B, write_data);
-   ret = (max77658_pm_get_ICHGIN_LIM(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_B, MAX77658_CNFG_CHG_B_ICHGIN_LIM_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_B, ICHGIN_LIM, target_val));
 
    return ret;
 }
@@ -3587,13 +3820,8 @@ int32_t max77658_pm_set_ICHGIN_LIM(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_I_PQ(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_B, &curr_data);
-   write_data[0] = (curr_data & 0b11111101) | ((target_val & 0b00000001) << 1);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_B, write_data);
-   ret = (max77658_pm_get_I_PQ(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_B, MAX77658_CNFG_CHG_B_I_PQ_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_B, I_PQ, target_val));
 
    return ret;
 }
@@ -3610,13 +3838,8 @@ int32_t max77658_pm_set_I_PQ(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_CHG_EN(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_B, &curr_data);
-   write_data[0] = (curr_data & 0b11111110) | (target_val & 0b00000001);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_B, write_data);
-   ret = (max77658_pm_get_CHG_EN(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_B, MAX77658_CNFG_CHG_B_CHG_EN_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_B, CHG_EN, target_val));
 
    return ret;
 }
@@ -3638,13 +3861,8 @@ int32_t max77658_pm_set_CHG_EN(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_CHG_PQ(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_C, &curr_data);
-   write_data[0] = (curr_data & 0b00011111) | ((target_val & 0b00000111) << 5);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_C, write_data);
-   ret = (max77658_pm_get_CHG_PQ(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_C, MAX77658_CNFG_CHG_C_CHG_PQ_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_C, CHG_PQ, target_val));
 
    return ret;
 }
@@ -3663,13 +3881,8 @@ int32_t max77658_pm_set_CHG_PQ(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_I_TERM(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_C, &curr_data);
-   write_data[0] = (curr_data & 0b11100111) | ((target_val & 0b00000011) << 3);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_C, write_data);
-   ret = (max77658_pm_get_I_TERM(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_C, MAX77658_CNFG_CHG_C_I_TERM_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_C, I_TERM, target_val));
 
    return ret;
 }
@@ -3691,13 +3904,8 @@ int32_t max77658_pm_set_I_TERM(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_T_TOPOFF(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_C, &curr_data);
-   write_data[0] = (curr_data & 0b11111000) | (target_val & 0b00000111);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_C, write_data);
-   ret = (max77658_pm_get_T_TOPOFF(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_C, MAX77658_CNFG_CHG_C_T_TOPOFF_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_C, T_TOPOFF, target_val));
 
    return ret;
 }
@@ -3716,13 +3924,8 @@ int32_t max77658_pm_set_T_TOPOFF(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_TJ_REG(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_D, &curr_data);
-   write_data[0] = (curr_data & 0b00011111) | ((target_val & 0b00000111) << 5);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_D, write_data);
-   ret = (max77658_pm_get_TJ_REG(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_D, MAX77658_CNFG_CHG_D_TJ_REG_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_D, TJ_REG, target_val));
 
    return ret;
 }
@@ -3738,13 +3941,8 @@ int32_t max77658_pm_set_TJ_REG(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_VSYS_REG(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_D, &curr_data);
-   write_data[0] = (curr_data & 0b11110000) | (target_val & 0b00001111);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_D, write_data);
-   ret = (max77658_pm_get_VSYS_REG(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_D, MAX77658_CNFG_CHG_D_VSYS_REG_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_D, VSYS_REG, target_val));
 
    return ret;
 }
@@ -3760,13 +3958,8 @@ int32_t max77658_pm_set_VSYS_REG(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_CHG_CC(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_E, &curr_data);
-   write_data[0] = (curr_data & 0b00000011) | ((target_val & 0b00111111) << 2);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_E, write_data);
-   ret = (max77658_pm_get_CHG_CC(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_E, MAX77658_CNFG_CHG_E_CHG_CC_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_E, CHG_CC, target_val));
 
    return ret;
 }
@@ -3784,13 +3977,8 @@ int32_t max77658_pm_set_CHG_CC(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_T_FAST_CHG(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_E, &curr_data);
-   write_data[0] = (curr_data & 0b11111100) | (target_val & 0b00000011);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_E, write_data);
-   ret = (max77658_pm_get_T_FAST_CHG(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_E, MAX77658_CNFG_CHG_E_T_FAST_CHG_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_E, T_FAST_CHG, target_val));
 
    return ret;
 }
@@ -3808,13 +3996,8 @@ int32_t max77658_pm_set_T_FAST_CHG(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_CHG_CC_JEITA(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_F, &curr_data);
-   write_data[0] = (curr_data & 0b00000011) | ((target_val & 0b00111111) << 2);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_F, write_data);
-   ret = (max77658_pm_get_CHG_CC_JEITA(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_F, MAX77658_CNFG_CHG_F_CHG_CC_JEITA_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_F, CHG_CC_JEITA, target_val));
 
    return ret;
 }
@@ -3830,13 +4013,8 @@ int32_t max77658_pm_set_CHG_CC_JEITA(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_CHG_CV(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_G, &curr_data);
-   write_data[0] = (curr_data & 0b00000011) | ((target_val & 0b00111111) << 2);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_G, write_data);
-   ret = (max77658_pm_get_CHG_CV(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_G, MAX77658_CNFG_CHG_G_CHG_CV_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_G, CHG_CV, target_val));
 
    return ret;
 }
@@ -3853,13 +4031,8 @@ int32_t max77658_pm_set_CHG_CV(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_USBS(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_G, &curr_data);
-   write_data[0] = (curr_data & 0b11111101) | ((target_val & 0b00000001) << 1);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_G, write_data);
-   ret = (max77658_pm_get_USBS(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_G, MAX77658_CNFG_CHG_G_USBS_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_G, USBS, target_val));
 
    return ret;
 }
@@ -3874,13 +4047,8 @@ int32_t max77658_pm_set_USBS(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_FUS_M(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_G, &curr_data);
-   write_data[0] = (curr_data & 0b11111110) | (target_val & 0b00000001);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_G, write_data);
-   ret = (max77658_pm_get_FUS_M(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_G, MAX77658_CNFG_CHG_G_FUS_M_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_G, FUS_M, target_val));
 
    return ret;
 }
@@ -3897,13 +4065,8 @@ int32_t max77658_pm_set_FUS_M(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_CHG_CV_JEITA(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_H, &curr_data);
-   write_data[0] = (curr_data & 0b00000011) | ((target_val & 0b00111111) << 2);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_H, write_data);
-   ret = (max77658_pm_get_CHG_CV_JEITA(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_H, MAX77658_CNFG_CHG_H_CHG_CV_JEITA_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_H, CHG_CV_JEITA, target_val));
 
    return ret;
 }
@@ -3921,13 +4084,8 @@ int32_t max77658_pm_set_CHG_CV_JEITA(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_SYS_BAT_PRT(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_H, &curr_data);
-   write_data[0] = (curr_data & 0b11111101) | ((target_val & 0b00000001) << 1);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_H, write_data);
-   ret = (max77658_pm_get_SYS_BAT_PRT(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_H, MAX77658_CNFG_CHG_H_SYS_BAT_PRT_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_H, SYS_BAT_PRT, target_val));
 
    return ret;
 }
@@ -3941,13 +4099,8 @@ int32_t max77658_pm_set_SYS_BAT_PRT(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_CHR_TH_EN(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_H, &curr_data);
-   write_data[0] = (curr_data & 0b11111110) | (target_val & 0b00000001);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_H, write_data);
-   ret = (max77658_pm_get_CHR_TH_EN(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_H, MAX77658_CNFG_CHG_H_CHR_TH_EN_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_H, CHR_TH_EN, target_val));
 
    return ret;
 }
@@ -3972,13 +4125,8 @@ int32_t max77658_pm_set_CHR_TH_EN(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_IMON_DISCHG_SCALE(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_I, &curr_data);
-   write_data[0] = (curr_data & 0b00001111) | ((target_val & 0b00001111) << 4);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_I, write_data);
-   ret = (max77658_pm_get_IMON_DISCHG_SCALE(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_I, MAX77658_CNFG_CHG_I_IMON_DISCHG_SCALE_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_I, IMON_DISCHG_SCALE, target_val));
 
    return ret;
 }
@@ -4003,13 +4151,8 @@ int32_t max77658_pm_set_IMON_DISCHG_SCALE(max77658_pm_t *ctx, uint8_t target_val
 int32_t max77658_pm_set_MUX_SEL(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_CHG_I, &curr_data);
-   write_data[0] = (curr_data & 0b11110000) | (target_val & 0b00001111);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_CHG_I, write_data);
-   ret = (max77658_pm_get_MUX_SEL(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_CHG_I, MAX77658_CNFG_CHG_I_MUX_SEL_MASK, MAX77658_PM_FIELD_PREP(CNFG_CHG_I, MUX_SEL, target_val));
 
    return ret;
 }
@@ -4025,13 +4168,8 @@ int32_t max77658_pm_set_MUX_SEL(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_DIS_LPM(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB_TOP, &curr_data);
-   write_data[0] = (curr_data & 0b01111111) | ((target_val & 0b00000001) << 7);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB_TOP, write_data);
-   ret = (max77658_pm_get_DIS_LPM(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB_TOP, MAX77658_CNFG_SBB_TOP_DIS_LPM_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB_TOP, DIS_LPM, target_val));
 
    return ret;
 }
@@ -4047,13 +4185,8 @@ int32_t max77658_pm_set_DIS_LPM(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_IPK_1P5A(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB_TOP, &curr_data);
-   write_data[0] = (curr_data & 0b10111111) | ((target_val & 0b00000001) << 6);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB_TOP, write_data);
-   ret = (max77658_pm_get_IPK_1P5A(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB_TOP, MAX77658_CNFG_SBB_TOP_IPK_1P5A_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB_TOP, IPK_1P5A, target_val));
 
    return ret;
 }
@@ -4071,13 +4204,8 @@ int32_t max77658_pm_set_IPK_1P5A(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_DRV_SBB(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB_TOP, &curr_data);
-   write_data[0] = (curr_data & 0b11111100) | (target_val & 0b00000011);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB_TOP, write_data);
-   ret = (max77658_pm_get_DRV_SBB(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB_TOP, MAX77658_CNFG_SBB_TOP_DRV_SBB_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB_TOP, DRV_SBB, target_val));
 
    return ret;
 }
@@ -4092,11 +4220,8 @@ int32_t max77658_pm_set_DRV_SBB(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_TV_SBB0(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t write_data[1];
 
-   write_data[0] = target_val;
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB0_A, write_data);
-   ret = (max77658_pm_get_TV_SBB0(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB0_A, MAX77658_CNFG_SBB0_A_TV_SBB0_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB0_A, TV_SBB0, target_val));
 
    return ret;
 }
@@ -4114,13 +4239,8 @@ int32_t max77658_pm_set_TV_SBB0(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_OP_MODE(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB0_B, &curr_data);
-   write_data[0] = (curr_data & 0b00111111) | ((target_val & 0b00000011) << 6);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB0_B, write_data);
-   ret = (max77658_pm_get_OP_MODE(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB0_B, MAX77658_CNFG_SBB0_B_OP_MODE_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB0_B, OP_MODE, target_val));
 
    return ret;
 }
@@ -4138,13 +4258,8 @@ int32_t max77658_pm_set_OP_MODE(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_IP_SBB0(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB0_B, &curr_data);
-   write_data[0] = (curr_data & 0b11001111) | ((target_val & 0b00000011) << 4);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB0_B, write_data);
-   ret = (max77658_pm_get_IP_SBB0(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB0_B, MAX77658_CNFG_SBB0_B_IP_SBB0_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB0_B, IP_SBB0, target_val));
 
    return ret;
 }
@@ -4163,13 +4278,8 @@ int32_t max77658_pm_set_IP_SBB0(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_ADE_SBB0(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB0_B, &curr_data);
-   write_data[0] = (curr_data & 0b11110111) | ((target_val & 0b00000001) << 3);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB0_B, write_data);
-   ret = (max77658_pm_get_ADE_SBB0(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB0_B, MAX77658_CNFG_SBB0_B_ADE_SBB0_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB0_B, ADE_SBB0, target_val));
 
    return ret;
 }
@@ -4192,13 +4302,8 @@ int32_t max77658_pm_set_ADE_SBB0(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_EN_SBB0(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB0_B, &curr_data);
-   write_data[0] = (curr_data & 0b11111000) | (target_val & 0b00000111);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB0_B, write_data);
-   ret = (max77658_pm_get_EN_SBB0(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB0_B, MAX77658_CNFG_SBB0_B_EN_SBB0_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB0_B, EN_SBB0, target_val));
 
    return ret;
 }
@@ -4213,11 +4318,8 @@ int32_t max77658_pm_set_EN_SBB0(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_TV_SBB1(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t write_data[1];
 
-   write_data[0] = target_val;
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB1_A, write_data);
-   ret = (max77658_pm_get_TV_SBB1(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB1_A, MAX77658_CNFG_SBB1_A_TV_SBB1_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB1_A, TV_SBB1, target_val));
 
    return ret;
 }
@@ -4235,13 +4337,8 @@ int32_t max77658_pm_set_TV_SBB1(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_OP_MODE_1(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB1_B, &curr_data);
-   write_data[0] = (curr_data & 0b00111111) | ((target_val & 0b00000011) << 6);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB1_B, write_data);
-   ret = (max77658_pm_get_OP_MODE_1(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB1_B, MAX77658_CNFG_SBB1_B_OP_MODE_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB1_B, OP_MODE, target_val));
 
    return ret;
 }
@@ -4259,13 +4356,8 @@ int32_t max77658_pm_set_OP_MODE_1(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_IP_SBB1(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB1_B, &curr_data);
-   write_data[0] = (curr_data & 0b11001111) | ((target_val & 0b00000011) << 4);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB1_B, write_data);
-   ret = (max77658_pm_get_IP_SBB1(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB1_B, MAX77658_CNFG_SBB1_B_IP_SBB1_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB1_B, IP_SBB1, target_val));
 
    return ret;
 }
@@ -4284,13 +4376,8 @@ int32_t max77658_pm_set_IP_SBB1(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_ADE_SBB1(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB1_B, &curr_data);
-   write_data[0] = (curr_data & 0b11110111) | ((target_val & 0b00000001) << 3);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB1_B, write_data);
-   ret = (max77658_pm_get_ADE_SBB1(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB1_B, MAX77658_CNFG_SBB1_B_ADE_SBB1_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB1_B, ADE_SBB1, target_val));
 
    return ret;
 }
@@ -4313,13 +4400,8 @@ int32_t max77658_pm_set_ADE_SBB1(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_EN_SBB1(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB1_B, &curr_data);
-   write_data[0] = (curr_data & 0b11111000) | (target_val & 0b00000111);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB1_B, write_data);
-   ret = (max77658_pm_get_EN_SBB1(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB1_B, MAX77658_CNFG_SBB1_B_EN_SBB1_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB1_B, EN_SBB1, target_val));
 
    return ret;
 }
@@ -4334,11 +4416,8 @@ int32_t max77658_pm_set_EN_SBB1(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_TV_SBB2(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t write_data[1];
 
-   write_data[0] = target_val;
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB2_A, write_data);
-   ret = (max77658_pm_get_TV_SBB2(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB2_A, MAX77658_CNFG_SBB2_A_TV_SBB2_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB2_A, TV_SBB2, target_val));
 
    return ret;
 }
@@ -4356,13 +4435,8 @@ int32_t max77658_pm_set_TV_SBB2(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_OP_MODE_2(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB2_B, &curr_data);
-   write_data[0] = (curr_data & 0b00111111) | ((target_val & 0b00000011) << 6);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB2_B, write_data);
-   ret = (max77658_pm_get_OP_MODE_2(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB2_B, MAX77658_CNFG_SBB2_B_OP_MODE_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB2_B, OP_MODE, target_val));
 
    return ret;
 }
@@ -4380,13 +4454,8 @@ int32_t max77658_pm_set_OP_MODE_2(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_IP_SBB2(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB2_B, &curr_data);
-   write_data[0] = (curr_data & 0b11001111) | ((target_val & 0b00000011) << 4);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB2_B, write_data);
-   ret = (max77658_pm_get_IP_SBB2(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB2_B, MAX77658_CNFG_SBB2_B_IP_SBB2_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB2_B, IP_SBB2, target_val));
 
    return ret;
 }
@@ -4402,13 +4471,8 @@ int32_t max77658_pm_set_IP_SBB2(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_ADE_SBB2(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB2_B, &curr_data);
-   write_data[0] = (curr_data & 0b11110111) | ((target_val & 0b00000001) << 3);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB2_B, write_data);
-   ret = (max77658_pm_get_ADE_SBB2(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB2_B, MAX77658_CNFG_SBB2_B_ADE_SBB2_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB2_B, ADE_SBB2, target_val));
 
    return ret;
 }
@@ -4431,13 +4495,8 @@ int32_t max77658_pm_set_ADE_SBB2(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_EN_SBB2(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_SBB2_B, &curr_data);
-   write_data[0] = (curr_data & 0b11111000) | (target_val & 0b00000111);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_SBB2_B, write_data);
-   ret = (max77658_pm_get_EN_SBB2(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_SBB2_B, MAX77658_CNFG_SBB2_B_EN_SBB2_MASK, MAX77658_PM_FIELD_PREP(CNFG_SBB2_B, EN_SBB2, target_val));
 
    return ret;
 }
@@ -4452,11 +4511,8 @@ int32_t max77658_pm_set_EN_SBB2(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_TV_SBB0_DVS(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t write_data[1];
 
-   write_data[0] = target_val;
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_DVS_SBB0_A, write_data);
-   ret = (max77658_pm_get_TV_SBB0_DVS(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_DVS_SBB0_A, MAX77658_CNFG_DVS_SBB0_A_TV_SBB0_DVS_MASK, MAX77658_PM_FIELD_PREP(CNFG_DVS_SBB0_A, TV_SBB0_DVS, target_val));
 
    return ret;
 }
@@ -4473,13 +4529,8 @@ int32_t max77658_pm_set_TV_SBB0_DVS(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_TV_OFS_LDO0(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO0_A, &curr_data);
-   write_data[0] = (curr_data & 0b01111111) | ((target_val & 0b00000001) << 7);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_LDO0_A, write_data);
-   ret = (max77658_pm_get_TV_OFS_LDO0(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_LDO0_A, MAX77658_CNFG_LDO0_A_TV_OFS_LDO0_MASK, MAX77658_PM_FIELD_PREP(CNFG_LDO0_A, TV_OFS_LDO0, target_val));
 
    return ret;
 }
@@ -4495,13 +4546,8 @@ int32_t max77658_pm_set_TV_OFS_LDO0(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_TV_LDO0(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO0_A, &curr_data);
-   write_data[0] = (curr_data & 0b10000000) | (target_val & 0b01111111);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_LDO0_A, write_data);
-   ret = (max77658_pm_get_TV_LDO0(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_LDO0_A, MAX77658_CNFG_LDO0_A_TV_LDO0_MASK, MAX77658_PM_FIELD_PREP(CNFG_LDO0_A, TV_LDO0, target_val));
 
    return ret;
 }
@@ -4517,13 +4563,8 @@ int32_t max77658_pm_set_TV_LDO0(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_LDO0_MD(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO0_B, &curr_data);
-   write_data[0] = (curr_data & 0b11101111) | ((target_val & 0b00000001) << 4);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_LDO0_B, write_data);
-   ret = (max77658_pm_get_LDO0_MD(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_LDO0_B, MAX77658_CNFG_LDO0_B_LDO0_MD_MASK, MAX77658_PM_FIELD_PREP(CNFG_LDO0_B, LDO0_MD, target_val));
 
    return ret;
 }
@@ -4539,13 +4580,8 @@ int32_t max77658_pm_set_LDO0_MD(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_ADE_LDO0(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO0_B, &curr_data);
-   write_data[0] = (curr_data & 0b11110111) | ((target_val & 0b00000001) << 3);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_LDO0_B, write_data);
-   ret = (max77658_pm_get_ADE_LDO0(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_LDO0_B, MAX77658_CNFG_LDO0_B_ADE_LDO0_MASK, MAX77658_PM_FIELD_PREP(CNFG_LDO0_B, ADE_LDO0, target_val));
 
    return ret;
 }
@@ -4568,13 +4604,8 @@ int32_t max77658_pm_set_ADE_LDO0(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_EN_LDO0(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO0_B, &curr_data);
-   write_data[0] = (curr_data & 0b11111000) | (target_val & 0b00000111);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_LDO0_B, write_data);
-   ret = (max77658_pm_get_EN_LDO0(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_LDO0_B, MAX77658_CNFG_LDO0_B_EN_LDO0_MASK, MAX77658_PM_FIELD_PREP(CNFG_LDO0_B, EN_LDO0, target_val));
 
    return ret;
 }
@@ -4591,13 +4622,8 @@ int32_t max77658_pm_set_EN_LDO0(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_TV_OFS_LDO1(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO1_A, &curr_data);
-   write_data[0] = (curr_data & 0b01111111) | ((target_val & 0b00000001) << 7);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_LDO1_A, write_data);
-   ret = (max77658_pm_get_TV_OFS_LDO1(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_LDO1_A, MAX77658_CNFG_LDO1_A_TV_OFS_LDO1_MASK, MAX77658_PM_FIELD_PREP(CNFG_LDO1_A, TV_OFS_LDO1, target_val));
 
    return ret;
 }
@@ -4613,13 +4639,8 @@ int32_t max77658_pm_set_TV_OFS_LDO1(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_TV_LDO1(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO1_A, &curr_data);
-   write_data[0] = (curr_data & 0b00000001) | (target_val & 0b01111111);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_LDO1_A, write_data);
-   ret = (max77658_pm_get_TV_LDO1(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_LDO1_A, MAX77658_CNFG_LDO1_A_TV_LDO1_MASK, MAX77658_PM_FIELD_PREP(CNFG_LDO1_A, TV_LDO1, target_val));
 
    return ret;
 }
@@ -4635,13 +4656,8 @@ int32_t max77658_pm_set_TV_LDO1(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_LDO1_MD(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO1_A, &curr_data);
-   write_data[0] = (curr_data & 0b11101111) | ((target_val & 0b00000001) << 4);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_LDO1_A, write_data);
-   ret = (max77658_pm_get_LDO1_MD(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_LDO1_B, MAX77658_CNFG_LDO1_B_LDO1_MD_MASK, MAX77658_PM_FIELD_PREP(CNFG_LDO1_B, LDO1_MD, target_val));
 
    return ret;
 }
@@ -4657,13 +4673,8 @@ int32_t max77658_pm_set_LDO1_MD(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_ADE_LDO1(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO1_A, &curr_data);
-   write_data[0] = (curr_data & 0b11110111) | ((target_val & 0b00000001) << 3);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_LDO1_A, write_data);
-   ret = (max77658_pm_get_ADE_LDO1(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_LDO1_B, MAX77658_CNFG_LDO1_B_ADE_LDO1_MASK, MAX77658_PM_FIELD_PREP(CNFG_LDO1_B, ADE_LDO1, target_val));
 
    return ret;
 }
@@ -4686,13 +4697,291 @@ int32_t max77658_pm_set_ADE_LDO1(max77658_pm_t *ctx, uint8_t target_val)
 int32_t max77658_pm_set_EN_LDO1(max77658_pm_t *ctx, uint8_t target_val)
 {
    int32_t ret;
-   uint8_t curr_data;
-   uint8_t write_data[1];
 
-   ret = max77658_pm_read_reg(ctx, MAX77658_CNFG_LDO1_A, &curr_data);
-   write_data[0] = (curr_data & 0b11111000) | (target_val & 0b00000111);
-   ret = max77658_pm_write_reg(ctx, MAX77658_CNFG_LDO1_A, write_data);
-   ret = (max77658_pm_get_EN_LDO1(ctx) == target_val)?SUCCESS:ERROR;
+   ret = max77658_pm_update_reg(ctx, MAX77658_CNFG_LDO1_B, MAX77658_CNFG_LDO1_B_EN_LDO1_MASK, MAX77658_PM_FIELD_PREP(CNFG_LDO1_B, EN_LDO1, target_val));
 
    return ret;
 }
+
+/* Private function definitions ---------------------------------------- */
+/**
+  * @brief  Bits of a field that can be compared after a write
+  *
+  * @param  reg   register address.
+  * @param  mask  bits owned by the field.
+  * @retval       mask without the self-clearing bits of the register
+  *
+  */
+static uint8_t m_max77658_pm_verify_mask(uint8_t reg, uint8_t mask)
+{
+   if(reg >= MAX77658_PM_REG_SPAN)
+   {
+      return mask;
+   }
+
+   return mask & ~max77658_pm_reg_self_clear[reg];
+}
+
+/**
+  * @brief  Read-modify-write-verify a register. The read is skipped when the
+  *         whole register is overwritten, the verify follows ctx->verify_mode.
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  * @param  reg   register address to update.
+  * @param  mask  bits of the register to update.
+  * @param  value new bits, already shifted into position.
+  * @retval       -1: I2C error or read-back mismatch, 0: Success
+  *
+  */
+static int32_t m_max77658_pm_apply_reg(max77658_pm_t *ctx, uint8_t reg, uint8_t mask, uint8_t value)
+{
+   int32_t ret;
+   uint8_t curr_data = 0x00;
+   uint8_t write_data[1];
+   uint8_t verify_mask;
+
+   if(mask != 0b11111111 && !m_max77658_pm_cache_get(ctx, reg, &curr_data))
+   {
+      ret = ctx->read_reg(ctx->device_address, reg, &curr_data, 1);
+      if(ret != SUCCESS)
+      {
+         m_max77658_pm_set_error(ctx, MAX77658_PM_ERR_BUS, MAX77658_PM_STEP_READ, reg, mask, value, ret);
+         return ERROR;
+      }
+   }
+
+   write_data[0] = (curr_data & ~mask) | (value & mask);
+   ret = ctx->write_reg(ctx->device_address, reg, write_data, 1);
+   if(ret != SUCCESS)
+   {
+      m_max77658_pm_set_error(ctx, MAX77658_PM_ERR_BUS, MAX77658_PM_STEP_WRITE, reg, mask, value, ret);
+      m_max77658_pm_cache_drop(ctx, reg);
+      return ERROR;
+   }
+   m_max77658_pm_cache_put(ctx, reg, write_data[0]);
+
+   verify_mask = m_max77658_pm_verify_mask(reg, mask);
+   if(verify_mask == 0 || ctx->verify_mode == MAX77658_PM_VERIFY_OFF)
+   {
+      return SUCCESS;
+   }
+
+   //Deferred checks fall back to an immediate read-back when the queue is full
+   if(ctx->verify_mode == MAX77658_PM_VERIFY_DEFERRED &&
+      m_max77658_pm_verify_queue(ctx, reg, mask, write_data[0]) == SUCCESS)
+   {
+      return SUCCESS;
+   }
+
+   ret = ctx->read_reg(ctx->device_address, reg, &curr_data, 1);
+   if(ret != SUCCESS)
+   {
+      m_max77658_pm_set_error(ctx, MAX77658_PM_ERR_BUS, MAX77658_PM_STEP_VERIFY, reg, mask, value, ret);
+      return ERROR;
+   }
+
+   if((curr_data & verify_mask) != (write_data[0] & verify_mask))
+   {
+      m_max77658_pm_set_error(ctx, MAX77658_PM_ERR_MISMATCH, MAX77658_PM_STEP_VERIFY, reg, mask, value, SUCCESS);
+      m_max77658_pm_cache_drop(ctx, reg);
+      return ERROR;
+   }
+   m_max77658_pm_cache_put(ctx, reg, curr_data);
+
+   return SUCCESS;
+}
+
+/**
+  * @brief  Merge a field update into the transaction entry of its register
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  * @param  reg   register address to update.
+  * @param  mask  bits of the register to update.
+  * @param  value new bits, already shifted into position.
+  * @retval       -1: Transaction full, 0: Success
+  *
+  */
+static int32_t m_max77658_pm_txn_stage(max77658_pm_t *ctx, uint8_t reg, uint8_t mask, uint8_t value)
+{
+   max77658_pm_txn_entry_t *entry = NULL;
+
+   for(uint8_t i = 0; i < ctx->txn.count; i++)
+   {
+      if(ctx->txn.entry[i].reg == reg)
+      {
+         entry = &ctx->txn.entry[i];
+         break;
+      }
+   }
+
+   if(entry == NULL)
+   {
+      if(ctx->txn.count >= MAX77658_PM_TXN_MAX_REGS)
+      {
+         ESP_LOGE(TAG, "m_max77658_pm_txn_stage() no room for reg 0x%02X", reg);
+         m_max77658_pm_set_error(ctx, MAX77658_PM_ERR_TXN_FULL, MAX77658_PM_STEP_NONE, reg, mask, value, SUCCESS);
+         return ERROR;
+      }
+      entry = &ctx->txn.entry[ctx->txn.count++];
+      entry->reg = reg;
+      entry->mask = 0;
+      entry->value = 0;
+   }
+
+   entry->value = (entry->value & ~mask) | (value & mask);
+   entry->mask |= mask;
+
+   return SUCCESS;
+}
+
+/**
+  * @brief  Queue the deferred verify of a written register, merging the
+  *         written bits into its entry. The queue is sorted by address.
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  * @param  reg   register address written.
+  * @param  mask  bits of the register written.
+  * @param  value whole register value written.
+  * @retval       -1: Queue full, 0: Success
+  *
+  */
+static int32_t m_max77658_pm_verify_queue(max77658_pm_t *ctx, uint8_t reg, uint8_t mask, uint8_t value)
+{
+   max77658_pm_txn_entry_t *entry = ctx->verify.entry;
+   uint8_t pos = 0;
+
+   while(pos < ctx->verify.count && entry[pos].reg < reg)
+   {
+      pos++;
+   }
+
+   if(pos == ctx->verify.count || entry[pos].reg != reg)
+   {
+      if(ctx->verify.count >= MAX77658_PM_VERIFY_MAX_REGS)
+      {
+         return ERROR;
+      }
+      for(uint8_t i = ctx->verify.count; i > pos; i--)
+      {
+         entry[i] = entry[i - 1];
+      }
+      ctx->verify.count++;
+      entry[pos].reg = reg;
+      entry[pos].mask = 0;
+   }
+
+   entry[pos].value = value;
+   entry[pos].mask |= mask;
+
+   return SUCCESS;
+}
+
+/**
+  * @brief  Burst planner: can a burst from start, currently ending at last,
+  *         grow up to next? Bursts stay short, skip at most
+  *         MAX77658_PM_VERIFY_MAX_GAP unused addresses and never read a
+  *         clear-on-read register nobody asked for.
+  *
+  * @param  start first register of the burst.
+  * @param  last  last register of the burst.
+  * @param  next  register to add, next > last.
+  * @retval       1: next can be added, 0: start a new burst
+  *
+  */
+static uint8_t m_max77658_pm_burst_can_extend(uint8_t start, uint8_t last, uint8_t next)
+{
+   if(next - last > MAX77658_PM_VERIFY_MAX_GAP + 1 || next - start >= MAX77658_PM_VERIFY_MAX_BURST)
+   {
+      return 0;
+   }
+
+   for(uint8_t reg = last + 1; reg < next; reg++)
+   {
+      if(max77658_pm_reg_clear_on_read(reg))
+      {
+         return 0;
+      }
+   }
+
+   return 1;
+}
+
+/**
+  * @brief  Look a register up in the shadow copy
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  * @param  reg   register address.
+  * @param  data  cached value.(ptr)
+  * @retval       1: Hit, 0: Miss (cache disabled, volatile or not loaded)
+  *
+  */
+static uint8_t m_max77658_pm_cache_get(max77658_pm_t *ctx, uint8_t reg, uint8_t *data)
+{
+   if(!ctx->cache.enabled || !max77658_pm_reg_cacheable(reg) ||
+      !(ctx->cache.valid[reg / 8] & (1 << (reg % 8))))
+   {
+      return 0;
+   }
+
+   *data = ctx->cache.value[reg];
+   return 1;
+}
+
+/**
+  * @brief  Store the value a register holds. Self-clearing bits read back
+  *         as 0 and are stored as such.
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  * @param  reg   register address.
+  * @param  data  value written to or read from the device.
+  *
+  */
+static void m_max77658_pm_cache_put(max77658_pm_t *ctx, uint8_t reg, uint8_t data)
+{
+   if(!ctx->cache.enabled || !max77658_pm_reg_cacheable(reg))
+   {
+      return;
+   }
+
+   ctx->cache.value[reg] = data & ~max77658_pm_reg_self_clear[reg];
+   ctx->cache.valid[reg / 8] |= 1 << (reg % 8);
+}
+
+/**
+  * @brief  Forget a register whose device value is unknown
+  *
+  * @param  ctx   communication interface handler.(ptr)
+  * @param  reg   register address.
+  *
+  */
+static void m_max77658_pm_cache_drop(max77658_pm_t *ctx, uint8_t reg)
+{
+   if(reg < MAX77658_PM_REG_SPAN)
+   {
+      ctx->cache.valid[reg / 8] &= ~(1 << (reg % 8));
+   }
+}
+
+/**
+  * @brief  Record an error in ctx->err
+  *
+  * @param  ctx         communication interface handler.(ptr)
+  * @param  code        error code.
+  * @param  step        access step that failed.
+  * @param  reg         register address.
+  * @param  mask        bits the update owned, 0 for a plain read.
+  * @param  value       value the update wanted to write.
+  * @param  bus_status  status returned by the interface.
+  *
+  */
+static void m_max77658_pm_set_error(max77658_pm_t *ctx, max77658_pm_err_code_t code, max77658_pm_step_t step,
+                                    uint8_t reg, uint8_t mask, uint8_t value, int32_t bus_status)
+{
+   ctx->err.code = code;
+   ctx->err.step = step;
+   ctx->err.reg = reg;
+   ctx->err.mask = mask;
+   ctx->err.value = value;
+   ctx->err.bus_status = bus_status;
+   ctx->err.count++;
+}
@@ -12,6 +12,7 @@
 /* Includes ----------------------------------------------------------- */
 #include <stdio.h>
 #include <stdint.h>
+#include "max77658_pm_regmap.h"
 
 /* Public defines ----------------------------------------------------- */
 // Project specific definitions *** adapt to your requirements! ***
@@ -24,6 +25,18 @@
 #ifndef MAX77658_PM_I2C_port
 #define MAX77658_PM_I2C_port 2     //I2C port of the host µC
 #endif
+#ifndef MAX77658_PM_TXN_MAX_REGS
+#define MAX77658_PM_TXN_MAX_REGS 8 //Distinct registers a transaction can accumulate
+#endif
+#ifndef MAX77658_PM_VERIFY_MAX_REGS
+#define MAX77658_PM_VERIFY_MAX_REGS 16 //Distinct registers waiting for a deferred verify
+#endif
+#ifndef MAX77658_PM_VERIFY_MAX_GAP
+#define MAX77658_PM_VERIFY_MAX_GAP 2   //Unused addresses a verify burst may read through
+#endif
+#ifndef MAX77658_PM_VERIFY_MAX_BURST
+#define MAX77658_PM_VERIFY_MAX_BURST 16 //Bytes read by one verify burst
+#endif
 
 /* Public enumerate/structure ----------------------------------------- */
 
@@ -38,11 +51,102 @@
 typedef int32_t (*pm_read_ptr)(uint8_t, uint8_t, uint8_t*, uint32_t);
 typedef int32_t (*pm_write_ptr)(uint8_t, uint8_t, uint8_t*, uint32_t);
 
+/**
+ * @brief  Register staged by a transaction
+ */
+typedef struct
+{
+   uint8_t reg;     //Register address
+   uint8_t mask;    //Bits updated inside the transaction
+   uint8_t value;   //New value of the updated bits
+} max77658_pm_txn_entry_t;
+
+/**
+ * @brief  Transaction scope, see max77658_pm_txn_begin()
+ */
+typedef struct
+{
+   uint8_t depth;   //Nesting level, 0 = no transaction open
+   uint8_t count;   //Number of used entries
+   max77658_pm_txn_entry_t entry[MAX77658_PM_TXN_MAX_REGS];
+} max77658_pm_txn_t;
+
+/**
+ * @brief  Read-back verification policy of the register updates
+ */
+typedef enum
+{
+   MAX77658_PM_VERIFY_IMMEDIATE = 0,  //Re-read each register right after it is written
+   MAX77658_PM_VERIFY_DEFERRED,       //Queue the check until max77658_pm_verify_sync()
+   MAX77658_PM_VERIFY_OFF,            //No read-back
+} max77658_pm_verify_mode_t;
+
+/**
+ * @brief  Registers written but not yet verified, see max77658_pm_verify_sync()
+ */
+typedef struct
+{
+   uint8_t count;   //Number of used entries
+   max77658_pm_txn_entry_t entry[MAX77658_PM_VERIFY_MAX_REGS];  //mask: written bits, value: expected register
+} max77658_pm_verify_t;
+
+/**
+ * @brief  Shadow copy of the non-volatile registers, see max77658_pm_cache_enable()
+ */
+typedef struct
+{
+   uint8_t enabled;
+   uint8_t valid[(MAX77658_PM_REG_SPAN + 7) / 8];  //One bit per register address
+   uint8_t value[MAX77658_PM_REG_SPAN];
+} max77658_pm_cache_t;
+
+/**
+ * @brief  Error codes recorded in max77658_pm_err_t
+ */
+typedef enum
+{
+   MAX77658_PM_ERR_NONE = 0,
+   MAX77658_PM_ERR_BUS,        //read_reg/write_reg interface returned non-0
+   MAX77658_PM_ERR_MISMATCH,   //Register read back differs from the written value
+   MAX77658_PM_ERR_TXN_FULL,   //No free transaction entry for the register
+   MAX77658_PM_ERR_TXN_STATE,  //Commit without an open transaction
+} max77658_pm_err_code_t;
+
+/**
+ * @brief  Access step the error occurred in
+ */
+typedef enum
+{
+   MAX77658_PM_STEP_NONE = 0,
+   MAX77658_PM_STEP_READ,
+   MAX77658_PM_STEP_WRITE,
+   MAX77658_PM_STEP_VERIFY,
+} max77658_pm_step_t;
+
+/**
+ * @brief  Last error of a max77658_pm_t, see max77658_pm_retry()
+ */
+typedef struct
+{
+   max77658_pm_err_code_t code;
+   max77658_pm_step_t     step;
+   uint8_t  reg;           //Failing register address
+   uint8_t  mask;          //Bits the failing update owned (0: plain read)
+   uint8_t  value;         //Value the failing update wanted to write
+   int32_t  bus_status;    //Status returned by the interface for MAX77658_PM_ERR_BUS
+   uint32_t count;         //Errors recorded since max77658_pm_clear_error()
+} max77658_pm_err_t;
+
 typedef struct
 {
    uint8_t device_address;
    pm_read_ptr   read_reg;
    pm_write_ptr  write_reg;
+   max77658_pm_verify_mode_t verify_mode;
+   max77658_pm_verify_t verify;
+   max77658_pm_cache_t cache;
+   max77658_pm_txn_t txn;
+   max77658_pm_err_t err;
 } max77658_pm_t;
 
 /**
@@ -56,11 +160,76 @@ void max77658_pm_base_line_init(max77658_pm_t *ctx);
  */
 int32_t max77658_pm_read_reg(max77658_pm_t *ctx, uint8_t reg, uint8_t *data);
 
+/**
+  * @brief  Read consecutive device registers with one bus transaction
+ */
+int32_t max77658_pm_read_burst(max77658_pm_t *ctx, uint8_t reg, uint8_t *data, uint32_t len);
+
 /**
   * @brief  Write generic device register
  */
 int32_t max77658_pm_write_reg(max77658_pm_t *ctx, uint8_t reg, uint8_t *data);
 
+/**
+  * @brief  Update a bit-field of a device register (read-modify-write-verify)
+ */
+int32_t max77658_pm_update_reg(max77658_pm_t *ctx, uint8_t reg, uint8_t mask, uint8_t value);
+
+/**
+  * @brief  Open a transaction: setters accumulate field updates per register in ctx
+ */
+void max77658_pm_txn_begin(max77658_pm_t *ctx);
+
+/**
+  * @brief  Close a transaction: write and verify each dirty register once
+ */
+int32_t max77658_pm_txn_commit(max77658_pm_t *ctx);
+
+/**
+  * @brief  Drop every update staged in the open transaction
+ */
+void max77658_pm_txn_abort(max77658_pm_t *ctx);
+
+/**
+  * @brief  Write and verify again the registers a failed commit left staged
+ */
+int32_t max77658_pm_txn_retry(max77658_pm_t *ctx);
+
+/**
+  * @brief  Replay only the register update recorded in ctx->err
+ */
+int32_t max77658_pm_retry(max77658_pm_t *ctx);
+
+/**
+  * @brief  Reset the error record of ctx
+ */
+void max77658_pm_clear_error(max77658_pm_t *ctx);
+
+/**
+  * @brief  Select when register updates are read back, deferred checks pending are verified first
+ */
+int32_t max77658_pm_set_verify_mode(max77658_pm_t *ctx, max77658_pm_verify_mode_t mode);
+
+/**
+  * @brief  Verify every register written in deferred mode with as few burst reads as possible
+ */
+int32_t max77658_pm_verify_sync(max77658_pm_t *ctx);
+
+/**
+  * @brief  Serve reads and read-modify-writes of non-volatile registers from a shadow copy
+ */
+void max77658_pm_cache_enable(max77658_pm_t *ctx, uint8_t enable);
+
+/**
+  * @brief  Drop every register of the shadow copy (e.g. after a PMIC reset)
+ */
+void max77658_pm_cache_invalidate(max77658_pm_t *ctx);
+
+/**
+  * @brief  Load every cacheable register with as few burst reads as possible
+ */
+int32_t max77658_pm_cache_fill(max77658_pm_t *ctx);
+
 uint8_t max77658_pm_get_bit(uint8_t input, uint8_t bit_order);
 
 /*****************Read Register***********************/
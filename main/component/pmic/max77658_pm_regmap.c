@@ -0,0 +1,54 @@
+/*
+ * max77658_pm_regmap.c
+ *
+ *  Register tables of the MAX77658 PM block and the compile-time checks of
+ *  max77658_pm_regmap.def.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "max77658_pm_regmap.h"
+#include "max77658_defines.h"
+
+/* Private macros ----------------------------------------------------- */
+#define M_TABLE_FLAGS(name, addr, reset, flags)     [addr] = MAX77658_PM_FLAGS_##name,
+#define M_TABLE_RESET(name, addr, reset, flags)     [addr] = MAX77658_PM_RESET_##name,
+#define M_TABLE_SC(name, addr, reset, flags)        [addr] = MAX77658_PM_SC_##name,
+#define M_TABLE_WRITABLE(name, addr, reset, flags)  [addr] = MAX77658_PM_WRITABLE_##name,
+
+/* A register is described once, inside the tables and at the address max77658_defines.h uses */
+#define M_CHECK_REG(name, addr, reset, flags) \
+   _Static_assert((addr) < MAX77658_PM_REG_SPAN, #name " outside MAX77658_PM_REG_SPAN"); \
+   _Static_assert((addr) == MAX77658_##name, #name " address differs from max77658_defines.h"); \
+   _Static_assert((reset) <= 0xFF, #name " reset value wider than 8 bits"); \
+   _Static_assert((0u MAX77658_PM_REGMAP_FIELDS(MAX77658_PM_REGMAP_SUM_USED, name)) == MAX77658_PM_USED_##name, \
+                  #name " has overlapping fields"); \
+   _Static_assert((MAX77658_PM_SC_##name & MAX77658_PM_WRITABLE_##name) == MAX77658_PM_SC_##name, \
+                  #name " self-clearing field is not writable");
+
+#define M_CHECK_FIELD(arg, reg, name, msb, lsb, flags) \
+   _Static_assert((msb) <= 7 && (lsb) <= (msb), #reg "." #name " bit range");
+
+/* Private function prototypes ---------------------------------------- */
+MAX77658_PM_REGMAP_REGS(M_CHECK_REG)
+MAX77658_PM_REGMAP_FIELDS(M_CHECK_FIELD, 0)
+
+/* Public variables --------------------------------------------------- */
+const uint8_t max77658_pm_reg_flags[MAX77658_PM_REG_SPAN] =
+{
+   MAX77658_PM_REGMAP_REGS(M_TABLE_FLAGS)
+};
+
+const uint8_t max77658_pm_reg_reset[MAX77658_PM_REG_SPAN] =
+{
+   MAX77658_PM_REGMAP_REGS(M_TABLE_RESET)
+};
+
+const uint8_t max77658_pm_reg_self_clear[MAX77658_PM_REG_SPAN] =
+{
+   MAX77658_PM_REGMAP_REGS(M_TABLE_SC)
+};
+
+const uint8_t max77658_pm_reg_writable[MAX77658_PM_REG_SPAN] =
+{
+   MAX77658_PM_REGMAP_REGS(M_TABLE_WRITABLE)
+};
@@ -0,0 +1,115 @@
+/*
+ * max77658_pm_regmap.h
+ *
+ *  Compile-time register map of the MAX77658 PM block, generated by the
+ *  preprocessor from max77658_pm_regmap.def.
+ */
+
+#ifndef MAIN_COMPONENT_MAX77658_PM_REGMAP_H_
+#define MAIN_COMPONENT_MAX77658_PM_REGMAP_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+
+/* Public defines ----------------------------------------------------- */
+/* Register flags */
+#define MAX77658_PM_RO      0x01  //Read-only register / bit-field
+#define MAX77658_PM_VOL     0x02  //Changes without a write, never cached
+#define MAX77658_PM_COR     0x04  //Clear-on-read, never part of a burst it was not asked for
+#define MAX77658_PM_OTP     0x08  //Reset value set by the OTP option
+#define MAX77658_PM_SC      0x10  //Self-clearing bit-field
+#define MAX77658_PM_DEFINED 0x80  //Address is described in the register map
+
+#define MAX77658_PM_REG_SPAN 0x50  //Address range covered by the tables below
+
+#include "max77658_pm_regmap.def"
+
+/* Public macros ------------------------------------------------------ */
+/* Mask of the bits msb..lsb of a register */
+#define MAX77658_PM_BITS(msb, lsb)  ((0xFFu >> (7 - (msb))) & (0xFFu << (lsb)) & 0xFFu)
+
+/* Extract / place a bit-field, e.g. MAX77658_PM_FIELD_GET(CNFG_GLBL, nEN_MODE, data) */
+#define MAX77658_PM_FIELD_GET(reg, field, data) \
+   (((data) & MAX77658_##reg##_##field##_MASK) >> MAX77658_##reg##_##field##_SHIFT)
+#define MAX77658_PM_FIELD_PREP(reg, field, val) \
+   (((val) << MAX77658_##reg##_##field##_SHIFT) & MAX77658_##reg##_##field##_MASK)
+
+/* Expansion helpers, fields are selected by comparing register addresses */
+#define MAX77658_PM_REGMAP_ADDR(name, addr, reset, flags) \
+   MAX77658_PM_ADDR_##name = (addr),
+#define MAX77658_PM_REGMAP_FIELD(arg, reg, name, msb, lsb, flags) \
+   MAX77658_##reg##_##name##_SHIFT = (lsb), \
+   MAX77658_##reg##_##name##_MASK = MAX77658_PM_BITS(msb, lsb),
+#define MAX77658_PM_REGMAP_IN(target, reg, mask) \
+   ((MAX77658_PM_ADDR_##target == MAX77658_PM_ADDR_##reg) ? (mask) : 0u)
+#define MAX77658_PM_REGMAP_OR_USED(target, reg, name, msb, lsb, flags) \
+   | MAX77658_PM_REGMAP_IN(target, reg, MAX77658_PM_BITS(msb, lsb))
+#define MAX77658_PM_REGMAP_OR_SC(target, reg, name, msb, lsb, flags) \
+   | MAX77658_PM_REGMAP_IN(target, reg, ((flags) & MAX77658_PM_SC) ? MAX77658_PM_BITS(msb, lsb) : 0u)
+#define MAX77658_PM_REGMAP_OR_RO(target, reg, name, msb, lsb, flags) \
+   | MAX77658_PM_REGMAP_IN(target, reg, ((flags) & MAX77658_PM_RO) ? MAX77658_PM_BITS(msb, lsb) : 0u)
+#define MAX77658_PM_REGMAP_SUM_USED(target, reg, name, msb, lsb, flags) \
+   + MAX77658_PM_REGMAP_IN(target, reg, MAX77658_PM_BITS(msb, lsb))
+#define MAX77658_PM_REGMAP_REG(name, addr, reset, flags) \
+   MAX77658_PM_RESET_##name = (reset), \
+   MAX77658_PM_FLAGS_##name = (flags) | MAX77658_PM_DEFINED, \
+   MAX77658_PM_USED_##name = (0u MAX77658_PM_REGMAP_FIELDS(MAX77658_PM_REGMAP_OR_USED, name)), \
+   MAX77658_PM_SC_##name = (0u MAX77658_PM_REGMAP_FIELDS(MAX77658_PM_REGMAP_OR_SC, name)), \
+   MAX77658_PM_WRITABLE_##name = ((flags) & MAX77658_PM_RO) ? 0u : \
+      (MAX77658_PM_USED_##name & ~(0u MAX77658_PM_REGMAP_FIELDS(MAX77658_PM_REGMAP_OR_RO, name)) & 0xFFu),
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief  Register addresses: MAX77658_PM_ADDR_<reg>
+ */
+enum
+{
+   MAX77658_PM_REGMAP_REGS(MAX77658_PM_REGMAP_ADDR)
+};
+
+/**
+ * @brief  Bit-fields: MAX77658_<reg>_<field>_MASK / _SHIFT
+ */
+enum
+{
+   MAX77658_PM_REGMAP_FIELDS(MAX77658_PM_REGMAP_FIELD, 0)
+};
+
+/**
+ * @brief  Per register: MAX77658_PM_RESET_<reg>, _FLAGS_<reg>, _USED_<reg>
+ *         (bits covered by fields), _SC_<reg> (self-clearing bits) and
+ *         _WRITABLE_<reg> (bits a write changes)
+ */
+enum
+{
+   MAX77658_PM_REGMAP_REGS(MAX77658_PM_REGMAP_REG)
+};
+
+/* Public variables --------------------------------------------------- */
+/* Tables indexed by register address, 0 for addresses not in the map */
+extern const uint8_t max77658_pm_reg_flags[MAX77658_PM_REG_SPAN];
+extern const uint8_t max77658_pm_reg_reset[MAX77658_PM_REG_SPAN];
+extern const uint8_t max77658_pm_reg_self_clear[MAX77658_PM_REG_SPAN];
+extern const uint8_t max77658_pm_reg_writable[MAX77658_PM_REG_SPAN];
+
+/* Public function prototypes ----------------------------------------- */
+/**
+  * @brief  Register can be served from a cache: described, not volatile
+ */
+static inline uint8_t max77658_pm_reg_cacheable(uint8_t reg)
+{
+   return reg < MAX77658_PM_REG_SPAN &&
+          (max77658_pm_reg_flags[reg] & (MAX77658_PM_DEFINED | MAX77658_PM_VOL)) == MAX77658_PM_DEFINED;
+}
+
+/**
+  * @brief  Reading the register clears it
+ */
+static inline uint8_t max77658_pm_reg_clear_on_read(uint8_t reg)
+{
+   return reg < MAX77658_PM_REG_SPAN && (max77658_pm_reg_flags[reg] & MAX77658_PM_COR);
+}
+
+
+#endif /* MAIN_COMPONENT_MAX77658_PM_REGMAP_H_ */
@@ -0,0 +1,309 @@
+/*
+ * max77658_pm_sim.c
+ *
+ *  Register-level simulator of the MAX77658 PM block, driven by the tables
+ *  generated from max77658_pm_regmap.def.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "max77658_pm_sim.h"
+
+/* Private defines ---------------------------------------------------- */
+#define M_TJ_REG_MC(code)   (60000 + 10000 * ((code) < 4 ? (code) : 4))  //TJ_REG code -> m°C
+#define M_CHG_DTLS_OFF      0x0
+#define M_CHG_DTLS_FAST_CC  0x2
+#define M_CHG_DTLS_FAST_CC_JEITA 0x3
+#define M_CHG_DTLS_TEMP     0xC
+#define M_THM_DTLS_COLD     0x1
+#define M_THM_DTLS_COOL     0x2
+#define M_THM_DTLS_WARM     0x3
+#define M_THM_DTLS_HOT      0x4
+#define M_THM_DTLS_NORMAL   0x5
+#define M_BATT_COLD_MC      0       //JEITA zone edges of the default thermistor thresholds
+#define M_BATT_COOL_MC      10000
+#define M_BATT_WARM_MC      45000
+#define M_BATT_HOT_MC       60000
+#define M_CHGIN_DTLS_OK     0x3
+
+/* Private enumerate/structure ---------------------------------------- */
+/* Private macros ----------------------------------------------------- */
+#define SUCCESS   0
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+static uint8_t m_regs[MAX77658_PM_REG_SPAN];
+static max77658_pm_sim_stats_t m_stats;
+static uint32_t m_fail_count;
+static int32_t m_fail_status;
+
+/* Private function prototypes ---------------------------------------- */
+static uint8_t m_max77658_pm_sim_fail(int32_t *status);
+
+/* Function definitions ----------------------------------------------- */
+
+/**
+  * @brief  Load the reset values of the register map and clear the statistics
+  *
+  */
+void max77658_pm_sim_reset(void)
+{
+   for(uint8_t reg = 0; reg < MAX77658_PM_REG_SPAN; reg++)
+   {
+      m_regs[reg] = max77658_pm_reg_reset[reg];
+   }
+   m_stats = (max77658_pm_sim_stats_t){0};
+   m_fail_count = 0;
+}
+
+/**
+  * @brief  Burst read. Addresses outside the register map read as 0,
+  *         clear-on-read registers are cleared after being read.
+  *
+  * @param  addr  device address (unused).
+  * @param  reg   first register address to read.
+  * @param  data  buffer for data read.(ptr)
+  * @param  len   number of consecutive register to read.
+  * @retval       injected failure status, 0: Success
+  *
+  */
+int32_t max77658_pm_sim_read_reg(uint8_t addr, uint8_t reg, uint8_t *data, uint32_t len)
+{
+   int32_t status;
+   uint32_t curr;
+
+   (void)addr;
+
+   if(m_max77658_pm_sim_fail(&status))
+   {
+      return status;
+   }
+
+   m_stats.read_txn++;
+   m_stats.read_bytes += len;
+
+   for(uint32_t i = 0; i < len; i++)
+   {
+      curr = reg + i;
+      if(curr >= MAX77658_PM_REG_SPAN)
+      {
+         data[i] = 0;
+         continue;
+      }
+      data[i] = m_regs[curr];
+      if(max77658_pm_reg_clear_on_read(curr))
+      {
+         m_regs[curr] = 0;
+      }
+   }
+
+   return SUCCESS;
+}
+
+/**
+  * @brief  Burst write. Read-only and reserved bits keep their value,
+  *         self-clearing bits act and read back as 0.
+  *
+  * @param  addr  device address (unused).
+  * @param  reg   first register address to write.
+  * @param  data  the buffer contains data to be written.(ptr)
+  * @param  len   number of consecutive register to write.
+  * @retval       injected failure status, 0: Success
+  *
+  */
+int32_t max77658_pm_sim_write_reg(uint8_t addr, uint8_t reg, uint8_t *data, uint32_t len)
+{
+   int32_t status;
+   uint32_t curr;
+   uint8_t writable;
+
+   (void)addr;
+
+   if(m_max77658_pm_sim_fail(&status))
+   {
+      return status;
+   }
+
+   m_stats.write_txn++;
+   m_stats.write_bytes += len;
+
+   for(uint32_t i = 0; i < len; i++)
+   {
+      curr = reg + i;
+      if(curr >= MAX77658_PM_REG_SPAN)
+      {
+         continue;
+      }
+      writable = max77658_pm_reg_writable[curr];
+      m_regs[curr] = (m_regs[curr] & ~writable) | (data[i] & writable);
+      m_regs[curr] &= ~max77658_pm_reg_self_clear[curr];
+   }
+
+   return SUCCESS;
+}
+
+/**
+  * @brief  Set a register from the hardware side, e.g. raise an interrupt flag
+  *
+  * @param  reg   register address.
+  * @param  value new content.
+  *
+  */
+void max77658_pm_sim_set(uint8_t reg, uint8_t value)
+{
+   if(reg < MAX77658_PM_REG_SPAN)
+   {
+      m_regs[reg] = value;
+   }
+}
+
+/**
+  * @brief  Register content without the side effects of a bus read
+  *
+  * @param  reg   register address.
+  * @retval       register content, 0 outside the register map
+  *
+  */
+uint8_t max77658_pm_sim_get(uint8_t reg)
+{
+   return reg < MAX77658_PM_REG_SPAN ? m_regs[reg] : 0;
+}
+
+/**
+  * @brief  Make the next count bus accesses fail
+  *
+  * @param  count   number of accesses to fail.
+  * @param  status  status returned by the failing accesses.
+  *
+  */
+void max77658_pm_sim_fail_next(uint32_t count, int32_t status)
+{
+   m_fail_count = count;
+   m_fail_status = status;
+}
+
+/**
+  * @brief  Advance the charger model. The charge current is CHG_CC (or
+  *         CHG_CC_JEITA in the cool / warm battery zones, none when cold or
+  *         hot), cut to
+  *         what ICHGIN_LIM leaves after the system load (ICHGIN_LIM_STAT),
+  *         and folded back to hold the die at TJ_REG once it gets there
+  *         (TJ_REG_STAT). The die follows the dissipation of the linear
+  *         charger, (VCHGIN - VBAT) * ICHG, with a first order lag, the
+  *         battery follows a share of the die rise with a slower one.
+  *
+  * @param  chg    model parameters and state.(ptr)
+  * @param  dt_ms  time step.
+  *
+  */
+void max77658_pm_sim_charger_step(max77658_pm_sim_charger_t *chg, uint32_t dt_ms)
+{
+   uint8_t stat_a = m_regs[MAX77658_PM_ADDR_STAT_CHG_A];
+   uint8_t ilim_code = MAX77658_PM_FIELD_GET(CNFG_CHG_B, ICHGIN_LIM, m_regs[MAX77658_PM_ADDR_CNFG_CHG_B]);
+   uint32_t ilim_ua = ilim_code <= 4 ? (5 - ilim_code) * 95000 : 95000;
+   uint32_t avail_ua = ilim_ua > chg->sys_ua ? ilim_ua - chg->sys_ua : 0;
+   uint32_t ichg_ua = (MAX77658_PM_FIELD_GET(CNFG_CHG_E, CHG_CC, m_regs[MAX77658_PM_ADDR_CNFG_CHG_E]) + 1) * 7500;
+   int32_t tj_reg_mc = M_TJ_REG_MC(MAX77658_PM_FIELD_GET(CNFG_CHG_D, TJ_REG, m_regs[MAX77658_PM_ADDR_CNFG_CHG_D]));
+   uint32_t drop_mv = chg->vchgin_mv > chg->vbat_mv ? chg->vchgin_mv - chg->vbat_mv : 0;
+   uint8_t enabled = MAX77658_PM_FIELD_GET(CNFG_CHG_B, CHG_EN, m_regs[MAX77658_PM_ADDR_CNFG_CHG_B]);
+   uint8_t zone = M_THM_DTLS_NORMAL;
+   uint8_t dtls = M_CHG_DTLS_FAST_CC;
+   uint8_t ilim_stat = 0;
+   uint8_t tj_stat = 0;
+   uint64_t fold_ua;
+   uint64_t p_mw;
+   int32_t target_mc;
+
+   if(chg->batt_mc < M_BATT_COLD_MC || chg->batt_mc >= M_BATT_HOT_MC)
+   {
+      zone = chg->batt_mc < M_BATT_COLD_MC ? M_THM_DTLS_COLD : M_THM_DTLS_HOT;
+      dtls = M_CHG_DTLS_TEMP;
+      ichg_ua = 0;
+   }
+   else if(chg->batt_mc < M_BATT_COOL_MC || chg->batt_mc >= M_BATT_WARM_MC)
+   {
+      zone = chg->batt_mc < M_BATT_COOL_MC ? M_THM_DTLS_COOL : M_THM_DTLS_WARM;
+      dtls = M_CHG_DTLS_FAST_CC_JEITA;
+      ichg_ua = (MAX77658_PM_FIELD_GET(CNFG_CHG_F, CHG_CC_JEITA, m_regs[MAX77658_PM_ADDR_CNFG_CHG_F]) + 1) * 7500;
+   }
+   if(!enabled)
+   {
+      dtls = M_CHG_DTLS_OFF;
+      ichg_ua = 0;
+   }
+   if(ichg_ua > avail_ua)
+   {
+      ichg_ua = avail_ua;
+      ilim_stat = 1;
+   }
+   if(chg->die_mc >= tj_reg_mc && drop_mv > 0 && chg->die_rth > 0)
+   {
+      //Current whose steady-state dissipation holds the die at TJ_REG
+      fold_ua = tj_reg_mc > chg->ambient_mc ?
+                (uint64_t)(tj_reg_mc - chg->ambient_mc) * 1000000 / chg->die_rth / drop_mv : 0;
+      if(ichg_ua > fold_ua)
+      {
+         ichg_ua = fold_ua;
+         tj_stat = 1;
+      }
+   }
+
+   p_mw = (uint64_t)drop_mv * ichg_ua / 1000000;
+   target_mc = chg->ambient_mc + (int32_t)(p_mw * chg->die_rth);
+   chg->die_mc += (int32_t)((int64_t)(target_mc - chg->die_mc) * (dt_ms < chg->die_tau_ms ? dt_ms : chg->die_tau_ms) /
+                            (chg->die_tau_ms > 0 ? chg->die_tau_ms : 1));
+   target_mc = chg->ambient_mc + (int32_t)((int64_t)(chg->die_mc - chg->ambient_mc) * chg->batt_couple_pct / 100);
+   chg->batt_mc += (int32_t)((int64_t)(target_mc - chg->batt_mc) * (dt_ms < chg->batt_tau_ms ? dt_ms : chg->batt_tau_ms) /
+                             (chg->batt_tau_ms > 0 ? chg->batt_tau_ms : 1));
+   chg->ichg_ua = ichg_ua;
+   chg->charged_uas += (uint64_t)ichg_ua * dt_ms / 1000;
+
+   m_regs[MAX77658_PM_ADDR_STAT_CHG_A] = MAX77658_PM_FIELD_PREP(STAT_CHG_A, ICHGIN_LIM_STAT, ilim_stat) |
+                                         MAX77658_PM_FIELD_PREP(STAT_CHG_A, TJ_REG_STAT, tj_stat) |
+                                         MAX77658_PM_FIELD_PREP(STAT_CHG_A, THM_DTLS, zone);
+   m_regs[MAX77658_PM_ADDR_STAT_CHG_B] = MAX77658_PM_FIELD_PREP(STAT_CHG_B, CHG_DTLS, dtls) |
+                                         MAX77658_PM_FIELD_PREP(STAT_CHG_B, CHGIN_DTLS, M_CHGIN_DTLS_OK) |
+                                         MAX77658_PM_FIELD_PREP(STAT_CHG_B, CHG, ichg_ua > 0);
+
+   if(tj_stat != MAX77658_PM_FIELD_GET(STAT_CHG_A, TJ_REG_STAT, stat_a))
+   {
+      m_regs[MAX77658_PM_ADDR_INT_CHG] |= MAX77658_INT_CHG_TJ_REG_I_MASK;
+   }
+   if(ilim_stat != MAX77658_PM_FIELD_GET(STAT_CHG_A, ICHGIN_LIM_STAT, stat_a))
+   {
+      m_regs[MAX77658_PM_ADDR_INT_CHG] |= MAX77658_INT_CHG_CHGIN_CTRL_I_MASK;
+   }
+   if(zone != MAX77658_PM_FIELD_GET(STAT_CHG_A, THM_DTLS, stat_a))
+   {
+      m_regs[MAX77658_PM_ADDR_INT_CHG] |= MAX77658_INT_CHG_THM_I_MASK;
+   }
+}
+
+/**
+  * @brief  Bus traffic since the last max77658_pm_sim_reset()
+  *
+  * @retval       statistics.(ptr)
+  *
+  */
+const max77658_pm_sim_stats_t *max77658_pm_sim_stats(void)
+{
+   return &m_stats;
+}
+
+/* Private function definitions ---------------------------------------- */
+/**
+  * @brief  Consume one injected failure
+  *
+  * @param  status  status to return.(ptr)
+  * @retval         1: Access fails, 0: Access proceeds
+  *
+  */
+static uint8_t m_max77658_pm_sim_fail(int32_t *status)
+{
+   if(m_fail_count == 0)
+   {
+      return 0;
+   }
+
+   m_fail_count--;
+   *status = m_fail_status;
+   return 1;
+}
@@ -0,0 +1,93 @@
+/*
+ * max77658_pm_sim.h
+ *
+ *  Register-level simulator of the MAX77658 PM block. Its read/write
+ *  functions match pm_read_ptr/pm_write_ptr, so a max77658_pm_t can run
+ *  against it instead of the I2C bus. Built into the host tests in
+ *  test/host only, not into the firmware.
+ */
+
+#ifndef MAIN_COMPONENT_MAX77658_PM_SIM_H_
+#define MAIN_COMPONENT_MAX77658_PM_SIM_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include "max77658_pm_regmap.h"
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief  Bus traffic seen by the simulator since max77658_pm_sim_reset()
+ */
+typedef struct
+{
+   uint32_t read_txn;
+   uint32_t read_bytes;
+   uint32_t write_txn;
+   uint32_t write_bytes;
+} max77658_pm_sim_stats_t;
+
+/**
+ * @brief  Thermal model of the charger. Parameters are set by the caller,
+ *         the state fields are advanced by max77658_pm_sim_charger_step().
+ */
+typedef struct
+{
+   int32_t  ambient_mc;        //Enclosure temperature, m°C
+   uint32_t vchgin_mv;
+   uint32_t vbat_mv;
+   uint32_t sys_ua;            //System load supplied from CHGIN ahead of the charger
+   uint32_t die_rth;           //Die rise, m°C per mW of charger dissipation
+   uint32_t die_tau_ms;
+   uint32_t batt_couple_pct;   //Share of the die rise reaching the battery
+   uint32_t batt_tau_ms;
+   int32_t  die_mc;            //State: die temperature
+   int32_t  batt_mc;           //State: battery temperature
+   uint32_t ichg_ua;           //State: charge current of the last step
+   uint64_t charged_uas;       //State: charge delivered, uA*s
+} max77658_pm_sim_charger_t;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+  * @brief  Load the reset values of the register map and clear the statistics
+ */
+void max77658_pm_sim_reset(void);
+
+/**
+  * @brief  Burst read, clear-on-read registers are cleared once read
+ */
+int32_t max77658_pm_sim_read_reg(uint8_t addr, uint8_t reg, uint8_t *data, uint32_t len);
+
+/**
+  * @brief  Burst write, only writable bits change and self-clearing bits read back as 0
+ */
+int32_t max77658_pm_sim_write_reg(uint8_t addr, uint8_t reg, uint8_t *data, uint32_t len);
+
+/**
+  * @brief  Hardware side of a register: set status/interrupt bits as the device would
+ */
+void max77658_pm_sim_set(uint8_t reg, uint8_t value);
+
+/**
+  * @brief  Register content without the side effects of a bus read
+ */
+uint8_t max77658_pm_sim_get(uint8_t reg);
+
+/**
+  * @brief  Make the next count bus accesses fail with status
+ */
+void max77658_pm_sim_fail_next(uint32_t count, int32_t status);
+
+/**
+  * @brief  Advance the charger model by dt_ms from CHG_EN / CHG_CC / ICHGIN_LIM / TJ_REG
+  *         and update STAT_CHG_A, STAT_CHG_B and INT_CHG as the charger would
+ */
+void max77658_pm_sim_charger_step(max77658_pm_sim_charger_t *chg, uint32_t dt_ms);
+
+/**
+  * @brief  Bus traffic since the last max77658_pm_sim_reset()
+ */
+const max77658_pm_sim_stats_t *max77658_pm_sim_stats(void);
+
+
+#endif /* MAIN_COMPONENT_MAX77658_PM_SIM_H_ */
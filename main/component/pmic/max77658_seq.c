@@ -0,0 +1,324 @@
+/*
+ * max77658_seq.c
+ *
+ *  Rail power sequencing of the MAX77658.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "max77658_seq.h"
+#include <stddef.h>
+
+/* Private defines ---------------------------------------------------- */
+#define MAX77658_SEQ_EN_ON   0b110  //On irrespective of FPS
+
+/* Private enumerate/structure ---------------------------------------- */
+/* Private macros ----------------------------------------------------- */
+#define SUCCESS   0
+#define ERROR     -1
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+static int32_t (*const m_seq_set_en[MAX77658_RAIL_COUNT])(max77658_pm_t *ctx, uint8_t target_val) =
+{
+   [MAX77658_RAIL_SBB0] = max77658_pm_set_EN_SBB0,
+   [MAX77658_RAIL_SBB1] = max77658_pm_set_EN_SBB1,
+   [MAX77658_RAIL_SBB2] = max77658_pm_set_EN_SBB2,
+   [MAX77658_RAIL_LDO0] = max77658_pm_set_EN_LDO0,
+   [MAX77658_RAIL_LDO1] = max77658_pm_set_EN_LDO1,
+};
+
+/* Private function prototypes ---------------------------------------- */
+static uint32_t m_seq_release_ms(const max77658_seq_t *seq, const max77658_seq_node_t *node);
+
+/* Function definitions ----------------------------------------------- */
+
+/**
+  * @brief  Put the graph in dependency order and plan it. A rail goes in
+  *         the first FPS slot that starts after its dependencies' slots
+  *         plus their ramp and its delay, if it allows FPS, all of its
+  *         dependencies are in slots and that slot exists. The software
+  *         plan enables every rail as soon as its dependencies are up.
+  *
+  * @param  seq    sequencer.(ptr)
+  * @param  pm     PM interface.(ptr)
+  * @param  rails  board graph, kept by reference.(ptr)
+  * @param  count  number of rails.
+  * @retval        -1: Cycle, duplicate or unknown rail, 0: Planned
+  *
+  */
+int32_t max77658_seq_plan(max77658_seq_t *seq, max77658_pm_t *pm, const max77658_seq_rail_t *rails, uint8_t count)
+{
+   max77658_seq_node_t *node;
+   const max77658_seq_node_t *dep;
+   uint8_t present = 0;
+   uint8_t placed = 0;
+   uint8_t progress;
+   uint32_t fps_ms;
+   uint32_t slot;
+
+   *seq = (max77658_seq_t){0};
+   seq->pm = pm;
+
+   if(count > MAX77658_RAIL_COUNT)
+   {
+      return ERROR;
+   }
+   for(uint8_t i = 0; i < count; i++)
+   {
+      if(rails[i].rail >= MAX77658_RAIL_COUNT || (present & MAX77658_SEQ_RAIL(rails[i].rail)))
+      {
+         return ERROR;
+      }
+      present |= MAX77658_SEQ_RAIL(rails[i].rail);
+   }
+
+   //Kahn's order: a rail is placed once everything it waits for is placed
+   while(seq->count < count)
+   {
+      progress = 0;
+      for(uint8_t i = 0; i < count; i++)
+      {
+         if((placed & MAX77658_SEQ_RAIL(rails[i].rail)) || (rails[i].after & ~placed))
+         {
+            continue;
+         }
+
+         node = &seq->node[seq->count++];
+         node->cfg = &rails[i];
+         node->slot = rails[i].fps ? 0 : MAX77658_SEQ_SOFTWARE;
+         fps_ms = 0;
+
+         for(uint8_t j = 0; j + 1 < seq->count; j++)
+         {
+            dep = &seq->node[j];
+            if(!(rails[i].after & MAX77658_SEQ_RAIL(dep->cfg->rail)))
+            {
+               continue;
+            }
+            if(dep->plan_ms + dep->cfg->ramp_ms > node->plan_ms)
+            {
+               node->plan_ms = dep->plan_ms + dep->cfg->ramp_ms;
+            }
+            if(dep->slot == MAX77658_SEQ_SOFTWARE)
+            {
+               node->slot = MAX77658_SEQ_SOFTWARE;
+            }
+            else if((uint32_t)dep->slot * MAX77658_SEQ_FPS_SLOT_MS + dep->cfg->ramp_ms > fps_ms)
+            {
+               fps_ms = (uint32_t)dep->slot * MAX77658_SEQ_FPS_SLOT_MS + dep->cfg->ramp_ms;
+            }
+         }
+         node->plan_ms += rails[i].delay_ms;
+
+         if(node->slot != MAX77658_SEQ_SOFTWARE)
+         {
+            slot = (fps_ms + rails[i].delay_ms + MAX77658_SEQ_FPS_SLOT_MS - 1) / MAX77658_SEQ_FPS_SLOT_MS;
+            node->slot = slot < MAX77658_SEQ_FPS_SLOTS ? slot : MAX77658_SEQ_SOFTWARE;
+         }
+
+         placed |= MAX77658_SEQ_RAIL(rails[i].rail);
+         progress = 1;
+      }
+
+      if(!progress)
+      {
+         //Waits on a rail outside the graph, or a cycle
+         seq->count = 0;
+         return ERROR;
+      }
+   }
+
+   return SUCCESS;
+}
+
+/**
+  * @brief  Set the probe of the rails
+  *
+  * @param  seq    sequencer.(ptr)
+  * @param  ready  probe, NULL to take a rail as up ramp_ms after its enable.
+  * @param  arg    argument of ready.(ptr)
+  *
+  */
+void max77658_seq_set_ready(max77658_seq_t *seq, max77658_seq_ready_ptr ready, void *arg)
+{
+   seq->ready = ready;
+   seq->ready_arg = arg;
+}
+
+/**
+  * @brief  Start the bring-up, the planned times count from now_ms
+  *
+  * @param  seq     sequencer.(ptr)
+  * @param  now_ms  current time.
+  *
+  */
+void max77658_seq_start(max77658_seq_t *seq, uint32_t now_ms)
+{
+   for(uint8_t i = 0; i < seq->count; i++)
+   {
+      seq->node[i].enabled = 0;
+   }
+   seq->up = 0;
+   seq->start_ms = now_ms;
+   seq->started = 1;
+}
+
+/**
+  * @brief  One pass in dependency order: write EN_* of every rail whose
+  *         dependencies are up and whose delay has passed, and mark the
+  *         enabled rails that are up. An FPS rail gets its slot number,
+  *         which turns it on at once while the sequencer is in its on
+  *         state and keeps it in the hardware sequence of the next
+  *         power-up; a software rail is forced on. A rail that comes up
+  *         in a pass releases the rails after it in the same pass.
+  *
+  * @param  seq     sequencer.(ptr)
+  * @param  now_ms  current time.
+  * @retval         -1: I2C error, otherwise MAX77658_SEQ_RAIL() of the rails newly up
+  *
+  */
+int32_t max77658_seq_step(max77658_seq_t *seq, uint32_t now_ms)
+{
+   max77658_seq_node_t *node;
+   uint8_t bit;
+   uint8_t up = 0;
+   uint8_t en;
+
+   if(!seq->started)
+   {
+      return 0;
+   }
+
+   for(uint8_t i = 0; i < seq->count; i++)
+   {
+      node = &seq->node[i];
+      bit = MAX77658_SEQ_RAIL(node->cfg->rail);
+
+      if(!node->enabled)
+      {
+         if((node->cfg->after & ~seq->up) || (int32_t)(now_ms - m_seq_release_ms(seq, node)) < 0)
+         {
+            continue;
+         }
+
+         en = node->slot != MAX77658_SEQ_SOFTWARE ? node->slot : MAX77658_SEQ_EN_ON;
+         if(m_seq_set_en[node->cfg->rail](seq->pm, en) != SUCCESS && max77658_pm_retry(seq->pm) != SUCCESS)
+         {
+            return ERROR;
+         }
+         node->enabled = 1;
+         node->en_ms = now_ms;
+      }
+
+      if(!(seq->up & bit))
+      {
+         if(seq->ready != NULL ? !seq->ready(seq->ready_arg, node->cfg->rail) :
+                                 now_ms - node->en_ms < node->cfg->ramp_ms)
+         {
+            continue;
+         }
+         node->up_ms = now_ms;
+         seq->up |= bit;
+         up |= bit;
+      }
+   }
+
+   return up;
+}
+
+/**
+  * @brief  Earliest time something can change: a delay that runs out, a
+  *         ramp_ms that passes or the next probe of a ramping rail
+  *
+  * @param  seq     sequencer.(ptr)
+  * @param  now_ms  current time.
+  * @retval         time in ms, MAX77658_SEQ_NO_WAKE once every rail is up
+  *
+  */
+uint32_t max77658_seq_due(const max77658_seq_t *seq, uint32_t now_ms)
+{
+   const max77658_seq_node_t *node;
+   uint32_t due = MAX77658_SEQ_NO_WAKE;
+   uint32_t t;
+
+   if(!seq->started)
+   {
+      return MAX77658_SEQ_NO_WAKE;
+   }
+
+   for(uint8_t i = 0; i < seq->count; i++)
+   {
+      node = &seq->node[i];
+      if(seq->up & MAX77658_SEQ_RAIL(node->cfg->rail))
+      {
+         continue;
+      }
+
+      if(node->enabled)
+      {
+         t = seq->ready != NULL ? now_ms + MAX77658_SEQ_POLL_MS : node->en_ms + node->cfg->ramp_ms;
+      }
+      else if(!(node->cfg->after & ~seq->up))
+      {
+         t = m_seq_release_ms(seq, node);
+      }
+      else
+      {
+         continue;
+      }
+
+      if(due == MAX77658_SEQ_NO_WAKE || (int32_t)(t - due) < 0)
+      {
+         due = t;
+      }
+   }
+
+   return due;
+}
+
+/**
+  * @brief  Node of a rail
+  *
+  * @param  seq   sequencer.(ptr)
+  * @param  rail  regulator output.
+  * @retval       node, NULL if the rail is not in the graph.(ptr)
+  *
+  */
+const max77658_seq_node_t *max77658_seq_node(const max77658_seq_t *seq, max77658_rail_t rail)
+{
+   for(uint8_t i = 0; i < seq->count; i++)
+   {
+      if(seq->node[i].cfg->rail == rail)
+      {
+         return &seq->node[i];
+      }
+   }
+
+   return NULL;
+}
+
+/* Private function definitions ---------------------------------------- */
+/**
+  * @brief  Time a rail may be enabled: its delay after the last of its
+  *         dependencies came up, or after the start
+  *
+  * @param  seq   sequencer.(ptr)
+  * @param  node  rail whose dependencies are all up.(ptr)
+  * @retval       time in ms
+  *
+  */
+static uint32_t m_seq_release_ms(const max77658_seq_t *seq, const max77658_seq_node_t *node)
+{
+   uint32_t last = seq->start_ms;
+
+   for(uint8_t i = 0; i < seq->count; i++)
+   {
+      if((node->cfg->after & MAX77658_SEQ_RAIL(seq->node[i].cfg->rail)) &&
+         (int32_t)(seq->node[i].up_ms - last) > 0)
+      {
+         last = seq->node[i].up_ms;
+      }
+   }
+
+   return last + node->cfg->delay_ms;
+}
@@ -0,0 +1,109 @@
+/*
+ * max77658_seq.h
+ *
+ *  Rail power sequencing of the MAX77658. The board describes its rails as
+ *  a dependency graph (each rail waits for a set of rails to be up, then a
+ *  delay). The plan places every rail it can in a flexible power sequencer
+ *  (FPS) slot, so the PMIC brings it up on its own at the next power-up
+ *  before the firmware runs, and sequences the rest from software at the
+ *  earliest time the graph allows. Bring-up records when each rail was
+ *  enabled and when it was up, the difference is the measured ramp time.
+ */
+
+#ifndef MAIN_COMPONENT_MAX77658_SEQ_H_
+#define MAIN_COMPONENT_MAX77658_SEQ_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include "max77658_pm.h"
+#include "max77658_dvs.h"
+
+/* Public defines ----------------------------------------------------- */
+#define MAX77658_SEQ_FPS_SLOTS     4
+#define MAX77658_SEQ_FPS_SLOT_MS   3            //FPS slot spacing, 2.56ms rounded up
+#define MAX77658_SEQ_SOFTWARE      0xFF         //max77658_seq_node_t.slot of a software sequenced rail
+#define MAX77658_SEQ_POLL_MS       1            //Ready probe interval while a rail ramps
+#define MAX77658_SEQ_NO_WAKE       UINT32_MAX   //Bring-up done or not started
+
+#define MAX77658_SEQ_RAIL(rail)    (1U << (rail))  //Bit of a rail in max77658_seq_rail_t.after
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief  Board probe of a rail, e.g. an ADC reading or a sensor answering. 1: Up
+ */
+typedef uint8_t (*max77658_seq_ready_ptr)(void *arg, max77658_rail_t rail);
+
+/**
+ * @brief  One rail of the board graph
+ */
+typedef struct
+{
+   max77658_rail_t rail;
+   uint8_t  after;             //MAX77658_SEQ_RAIL() of the rails that must be up first
+   uint16_t delay_ms;          //After the last of them is up
+   uint16_t ramp_ms;           //Soft-start time, up after this without a ready probe
+   uint8_t  fps;               //1: May be placed in an FPS slot, 0: Keep it on irrespective of FPS
+} max77658_seq_rail_t;
+
+/**
+ * @brief  Planned and measured timing of one rail
+ */
+typedef struct
+{
+   const max77658_seq_rail_t *cfg;
+   uint8_t  slot;              //FPS slot, MAX77658_SEQ_SOFTWARE
+   uint32_t plan_ms;           //Planned enable time from the start
+   uint8_t  enabled;
+   uint32_t en_ms;             //Enable written
+   uint32_t up_ms;             //Up, measured ramp time is up_ms - en_ms
+} max77658_seq_node_t;
+
+/**
+ * @brief  Sequencer state, nodes are kept in dependency order
+ */
+typedef struct
+{
+   max77658_pm_t *pm;
+   uint8_t count;
+   max77658_seq_node_t node[MAX77658_RAIL_COUNT];
+   max77658_seq_ready_ptr ready;
+   void *ready_arg;
+   uint8_t  up;                //MAX77658_SEQ_RAIL() of the rails up
+   uint32_t start_ms;
+   uint8_t  started;
+} max77658_seq_t;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+  * @brief  Order the graph and plan FPS slots and enable times. -1 on a cycle or an unknown rail
+ */
+int32_t max77658_seq_plan(max77658_seq_t *seq, max77658_pm_t *pm, const max77658_seq_rail_t *rails, uint8_t count);
+
+/**
+  * @brief  Probe used to detect a rail up, NULL to rely on ramp_ms
+ */
+void max77658_seq_set_ready(max77658_seq_t *seq, max77658_seq_ready_ptr ready, void *arg);
+
+/**
+  * @brief  Start the bring-up, rails without dependencies are enabled by the first step
+ */
+void max77658_seq_start(max77658_seq_t *seq, uint32_t now_ms);
+
+/**
+  * @brief  Enable the rails that are due and detect the ones up. -1: I2C error, else MAX77658_SEQ_RAIL() of the rails newly up
+ */
+int32_t max77658_seq_step(max77658_seq_t *seq, uint32_t now_ms);
+
+/**
+  * @brief  Time of the next step, MAX77658_SEQ_NO_WAKE once every rail is up
+ */
+uint32_t max77658_seq_due(const max77658_seq_t *seq, uint32_t now_ms);
+
+/**
+  * @brief  Node of a rail, NULL if the rail is not in the graph
+ */
+const max77658_seq_node_t *max77658_seq_node(const max77658_seq_t *seq, max77658_rail_t rail);
+
+
+#endif /* MAIN_COMPONENT_MAX77658_SEQ_H_ */
@@ -0,0 +1,198 @@
+/*
+ * telemetry.c
+ *
+ *  Binary telemetry records with COBS framing and CRC-16.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include <stddef.h>
+#include "telemetry.h"
+
+/* Private defines ---------------------------------------------------- */
+#define TELEMETRY_HEADER   2   //type, seq
+#define TELEMETRY_CRC      2
+#define TELEMETRY_RAW_MAX  (TELEMETRY_HEADER + TELEMETRY_MAX_PAYLOAD + TELEMETRY_CRC)
+#define TELEMETRY_FRAME_MAX (TELEMETRY_RAW_MAX + TELEMETRY_RAW_MAX / 254 + 3)  //COBS overhead + delimiters
+
+/* Private enumerate/structure ---------------------------------------- */
+/* Private macros ----------------------------------------------------- */
+#define SUCCESS   0
+#define ERROR     -1
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+static telemetry_write_ptr m_write;
+static uint8_t m_seq;
+
+/* Nibble table of CRC-16/CCITT-FALSE */
+static const uint16_t m_crc_table[16] =
+{
+   0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+   0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+/* Private function prototypes ---------------------------------------- */
+/* Function definitions ----------------------------------------------- */
+
+/**
+  * @brief  Select the byte sink of the stream
+  *
+  * @param  write  sink, NULL drops every record.
+  *
+  */
+void telemetry_init(telemetry_write_ptr write)
+{
+   m_write = write;
+   m_seq = 0;
+}
+
+/**
+  * @brief  Start a record
+  *
+  * @param  rec   record.(ptr)
+  * @param  type  record type tag.
+  *
+  */
+void telemetry_begin(telemetry_record_t *rec, telemetry_type_t type)
+{
+   rec->type = type;
+   rec->len = 0;
+}
+
+/**
+  * @brief  Append a byte to a record
+  *
+  * @param  rec    record.(ptr)
+  * @param  value  field value.
+  *
+  */
+void telemetry_put_u8(telemetry_record_t *rec, uint8_t value)
+{
+   if(rec->len < TELEMETRY_MAX_PAYLOAD)
+   {
+      rec->payload[rec->len++] = value;
+   }
+}
+
+/**
+  * @brief  Append a little-endian 16-bit field to a record
+  *
+  * @param  rec    record.(ptr)
+  * @param  value  field value.
+  *
+  */
+void telemetry_put_u16(telemetry_record_t *rec, uint16_t value)
+{
+   telemetry_put_u8(rec, value & 0xFF);
+   telemetry_put_u8(rec, value >> 8);
+}
+
+/**
+  * @brief  Append a little-endian 32-bit field to a record
+  *
+  * @param  rec    record.(ptr)
+  * @param  value  field value.
+  *
+  */
+void telemetry_put_u32(telemetry_record_t *rec, uint32_t value)
+{
+   telemetry_put_u16(rec, value & 0xFFFF);
+   telemetry_put_u16(rec, value >> 16);
+}
+
+/**
+  * @brief  Frame a record (type, sequence, payload, CRC), COBS encode it
+  *         and hand it to the sink between two 0x00 delimiters. The leading
+  *         one resynchronises the decoder after log text on the same UART.
+  *
+  * @param  rec   record.(ptr)
+  * @retval       -1: No sink or sink error, 0: Success
+  *
+  */
+int32_t telemetry_send(telemetry_record_t *rec)
+{
+   uint8_t raw[TELEMETRY_RAW_MAX];
+   uint8_t frame[TELEMETRY_FRAME_MAX];
+   uint32_t len = 0;
+   uint16_t crc;
+
+   if(m_write == NULL)
+   {
+      return ERROR;
+   }
+
+   raw[len++] = rec->type;
+   raw[len++] = m_seq++;
+   for(uint8_t i = 0; i < rec->len; i++)
+   {
+      raw[len++] = rec->payload[i];
+   }
+   crc = telemetry_crc16(raw, len);
+   raw[len++] = crc & 0xFF;
+   raw[len++] = crc >> 8;
+
+   frame[0] = 0x00;
+   len = telemetry_cobs_encode(raw, len, &frame[1]) + 1;
+   frame[len++] = 0x00;
+
+   return m_write(frame, len) == 0 ? SUCCESS : ERROR;
+}
+
+/**
+  * @brief  CRC-16/CCITT-FALSE, one table lookup per nibble
+  *
+  * @param  data  bytes to protect.(ptr)
+  * @param  len   number of bytes.
+  * @retval       CRC
+  *
+  */
+uint16_t telemetry_crc16(const uint8_t *data, uint32_t len)
+{
+   uint16_t crc = 0xFFFF;
+
+   for(uint32_t i = 0; i < len; i++)
+   {
+      crc = (crc << 4) ^ m_crc_table[(crc >> 12) ^ (data[i] >> 4)];
+      crc = (crc << 4) ^ m_crc_table[(crc >> 12) ^ (data[i] & 0x0F)];
+   }
+
+   return crc;
+}
+
+/**
+  * @brief  Consistent Overhead Byte Stuffing: removes every 0x00 from the
+  *         data so 0x00 can delimit frames.
+  *
+  * @param  src   bytes to encode.(ptr)
+  * @param  len   number of bytes.
+  * @param  dst   encoded bytes, room for len + len / 254 + 1.(ptr)
+  * @retval       encoded length
+  *
+  */
+uint32_t telemetry_cobs_encode(const uint8_t *src, uint32_t len, uint8_t *dst)
+{
+   uint32_t code_pos = 0;
+   uint32_t out = 1;
+   uint8_t code = 1;
+
+   for(uint32_t i = 0; i < len; i++)
+   {
+      if(src[i] == 0x00)
+      {
+         dst[code_pos] = code;
+         code_pos = out++;
+         code = 1;
+         continue;
+      }
+
+      dst[out++] = src[i];
+      if(++code == 0xFF)
+      {
+         dst[code_pos] = code;
+         code_pos = out++;
+         code = 1;
+      }
+   }
+   dst[code_pos] = code;
+
+   return out;
+}
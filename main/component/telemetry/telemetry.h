@@ -0,0 +1,90 @@
+/*
+ * telemetry.h
+ *
+ *  Binary telemetry records: [type][seq][payload][crc16], COBS encoded and
+ *  framed by 0x00 on both sides. All multi-byte fields are little-endian.
+ *  tools/telemetry_decode.py turns a captured stream back into CSV.
+ */
+
+#ifndef MAIN_COMPONENT_TELEMETRY_H_
+#define MAIN_COMPONENT_TELEMETRY_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+
+/* Public defines ----------------------------------------------------- */
+#define TELEMETRY_MAX_PAYLOAD 48  //Largest record payload in bytes
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief  Record type tags, keep tools/telemetry_decode.py in sync
+ */
+typedef enum
+{
+   TELEMETRY_BATTERY = 0x01,  //u32 t_ms, i32 avg_vcell_uv, i32 avg_current_ua, i32 current_ua,
+                              //i32 rep_cap_mah, i16 rep_soc, i32 power_uw, i32 energy_out_uwh, i32 energy_in_uwh
+   TELEMETRY_BUTTON  = 0x02,  //u32 t_ms, u8 event (button_gesture_event_t: 1 single, 2 double, 3 triple, 4 long)
+   TELEMETRY_RAIL    = 0x03,  //u32 t_ms, u8 rail (0 SBB0, 1 SBB1, 2 SBB2, 3 LDO0, 4 LDO1), u16 mv
+   TELEMETRY_STATS   = 0x04,  //u32 t_ms, u32 wakes, u32 kicked_wakes (PMIC supervisor)
+   TELEMETRY_ALERT   = 0x05,  //u32 t_ms, u16 status (MAX17055 STATUS alert bits)
+   TELEMETRY_HEALTH  = 0x06,  //u32 t_ms, u8 client (PMIC watchdog client id), u8 missed
+   TELEMETRY_CHARGER = 0x07,  //u32 t_ms, u8 state, u8 jeita, u8 zone, u8 chgin, u8 flags (max77658_chg_status_t)
+   TELEMETRY_CHARGE  = 0x08,  //u32 t_ms, u8 reason (MAX77658_CHG_CTRL_*), u8 CHG_CC code, u8 ICHGIN_LIM level, i8 temp_c
+   TELEMETRY_RAIL_UP = 0x09,  //u32 t_ms, u8 rail, u8 FPS slot (0xFF software), u16 enable ms after the start, u16 ramp ms
+   TELEMETRY_POWER_MODE = 0x0A, //u32 t_ms, u8 mode (0 normal, 1 save, 2 low), i32 avg_current_ua, u32 switches
+   TELEMETRY_DUMP    = 0x0B,  //u16 offset, u16 image size, u8[] image bytes (max77658_dump.h), reassembled by tools/regdump.py
+   TELEMETRY_BOOT    = 0x0C,  //u32 boot start ms, u8 stage, u16 start ms after the boot start, u16 duration ms, i8 status,
+                              //u8 flags (1 critical path, 2 skipped), one record per pmic_boot stage
+} telemetry_type_t;
+
+/**
+ * @brief  Byte sink of the stream, returns 0 on success
+ */
+typedef int (*telemetry_write_ptr)(const uint8_t *, uint32_t);
+
+/**
+ * @brief  Record being built, see telemetry_begin()
+ */
+typedef struct
+{
+   uint8_t type;
+   uint8_t len;
+   uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+} telemetry_record_t;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+  * @brief  Select the byte sink of the stream
+ */
+void telemetry_init(telemetry_write_ptr write);
+
+/**
+  * @brief  Start a record
+ */
+void telemetry_begin(telemetry_record_t *rec, telemetry_type_t type);
+
+/**
+  * @brief  Append little-endian fields to a record, silently truncated at TELEMETRY_MAX_PAYLOAD
+ */
+void telemetry_put_u8(telemetry_record_t *rec, uint8_t value);
+void telemetry_put_u16(telemetry_record_t *rec, uint16_t value);
+void telemetry_put_u32(telemetry_record_t *rec, uint32_t value);
+
+/**
+  * @brief  Frame a record and hand it to the sink
+ */
+int32_t telemetry_send(telemetry_record_t *rec);
+
+/**
+  * @brief  CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+ */
+uint16_t telemetry_crc16(const uint8_t *data, uint32_t len);
+
+/**
+  * @brief  COBS encode len bytes of src into dst (room for len + len / 254 + 1), returns encoded length
+ */
+uint32_t telemetry_cobs_encode(const uint8_t *src, uint32_t len, uint8_t *dst);
+
+
+#endif /* MAIN_COMPONENT_TELEMETRY_H_ */
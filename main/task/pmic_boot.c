@@ -0,0 +1,232 @@
+/*
+ * pmic_boot.c
+ *
+ *  Boot orchestrator of the PMIC task.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "pmic_boot.h"
+#include <esp_log.h>
+#include "esp_timer.h"
+
+/* Private defines ---------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------- */
+/* Private macros ----------------------------------------------------- */
+#define SUCCESS   0
+#define ERROR     -1
+
+#define M_NOW_MS()   ((uint32_t)(esp_timer_get_time() / 1000))
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+/* Private function prototypes ---------------------------------------- */
+static void m_pmic_boot_finish(pmic_boot_t *boot, uint8_t id, int32_t status);
+static void m_pmic_boot_critical(pmic_boot_t *boot);
+
+/* Function definitions ----------------------------------------------- */
+
+/**
+  * @brief  Load the stage graph. Dependencies must point to earlier
+  *         stages, so the graph has no cycle and one pass in table order
+  *         starts every stage that is ready.
+  *
+  * @param  boot   orchestrator.(ptr)
+  * @param  cfg    stage table, kept by reference.(ptr)
+  * @param  count  stages in cfg.
+  * @param  arg    argument of the run functions.(ptr)
+  * @retval        0: Success, -1: Too many stages or a dependency on a later stage
+  *
+  */
+int32_t pmic_boot_init(pmic_boot_t *boot, const pmic_boot_stage_cfg_t *cfg, uint8_t count, void *arg)
+{
+   *boot = (pmic_boot_t){ .cfg = cfg, .arg = arg, .start_ms = M_NOW_MS() };
+
+   if(count > PMIC_BOOT_MAX_STAGES)
+   {
+      return ERROR;
+   }
+   for(uint8_t i = 0; i < count; i++)
+   {
+      if(cfg[i].after >> i)
+      {
+         return ERROR;
+      }
+   }
+
+   boot->count = count;
+
+   return SUCCESS;
+}
+
+/**
+  * @brief  Leave stages out of this boot, e.g. the PM stages of a fuel gauge
+  *         only board. They count as done at the boot start.
+  *
+  * @param  boot    orchestrator.(ptr)
+  * @param  stages  PMIC_BOOT_STAGE() of the stages.
+  *
+  */
+void pmic_boot_skip(pmic_boot_t *boot, uint8_t stages)
+{
+   for(uint8_t i = 0; i < boot->count; i++)
+   {
+      if((stages & PMIC_BOOT_STAGE(i)) && boot->node[i].state == PMIC_BOOT_WAITING)
+      {
+         boot->node[i] = (pmic_boot_node_t){ .state = PMIC_BOOT_SKIPPED, .start_ms = boot->start_ms, .end_ms = boot->start_ms };
+         boot->done |= PMIC_BOOT_STAGE(i);
+      }
+   }
+}
+
+/**
+  * @brief  Start every waiting stage whose dependencies are done. A stage
+  *         that finishes inside its run function releases its dependents
+  *         in the same pass.
+  *
+  * @param  boot  orchestrator.(ptr)
+  * @retval       PMIC_BOOT_PENDING, 0: Every stage is done
+  *
+  */
+int32_t pmic_boot_step(pmic_boot_t *boot)
+{
+   const pmic_boot_stage_cfg_t *cfg;
+   pmic_boot_node_t *node;
+   int32_t ret;
+
+   for(uint8_t i = 0; i < boot->count; i++)
+   {
+      cfg = &boot->cfg[i];
+      node = &boot->node[i];
+      if(node->state != PMIC_BOOT_WAITING || (cfg->after & ~boot->done))
+      {
+         continue;
+      }
+
+      node->state = PMIC_BOOT_RUNNING;
+      node->start_ms = M_NOW_MS();
+      ret = cfg->run(boot->arg, node->start_ms);
+      if(ret != PMIC_BOOT_PENDING && node->state == PMIC_BOOT_RUNNING)
+      {
+         m_pmic_boot_finish(boot, i, ret);
+      }
+   }
+
+   return boot->done == PMIC_BOOT_STAGE(boot->count) - 1 ? SUCCESS : PMIC_BOOT_PENDING;
+}
+
+/**
+  * @brief  End of a stage whose run function returned PMIC_BOOT_PENDING.
+  *         Its dependents start at the next pmic_boot_step().
+  *
+  * @param  boot    orchestrator.(ptr)
+  * @param  id      stage.
+  * @param  status  0: Success, else the error of the stage.
+  * @retval         0: Success, -1: The stage is not running
+  *
+  */
+int32_t pmic_boot_done(pmic_boot_t *boot, uint8_t id, int32_t status)
+{
+   if(id >= boot->count || boot->node[id].state != PMIC_BOOT_RUNNING)
+   {
+      return ERROR;
+   }
+
+   m_pmic_boot_finish(boot, id, status);
+
+   return SUCCESS;
+}
+
+/**
+  * @brief  Log one line per stage: start and end after the boot start,
+  *         duration and status. Stages of the critical path carry a '*'.
+  *
+  * @param  boot  orchestrator.(ptr)
+  * @param  tag   log tag of the caller.(ptr)
+  *
+  */
+void pmic_boot_dump(const pmic_boot_t *boot, const char *tag)
+{
+   const pmic_boot_node_t *node;
+
+   for(uint8_t i = 0; i < boot->count; i++)
+   {
+      node = &boot->node[i];
+      switch(node->state)
+      {
+         case PMIC_BOOT_SKIPPED:
+            ESP_LOGI(tag, "  %-10s skipped", boot->cfg[i].name);
+            break;
+         case PMIC_BOOT_DONE:
+            ESP_LOGI(tag, "%c %-10s %5u .. %5u ms  %5u ms  status %d", (boot->critical & PMIC_BOOT_STAGE(i)) ? '*' : ' ',
+                     boot->cfg[i].name, (unsigned)(node->start_ms - boot->start_ms), (unsigned)(node->end_ms - boot->start_ms),
+                     (unsigned)(node->end_ms - node->start_ms), (int)node->status);
+            break;
+         default:
+            ESP_LOGI(tag, "  %-10s %s", boot->cfg[i].name, node->state == PMIC_BOOT_RUNNING ? "running" : "waiting");
+            break;
+      }
+   }
+}
+
+/* Private function definitions ---------------------------------------- */
+/**
+  * @brief  Record the end of a stage, the critical path once it was the last
+  *
+  * @param  boot    orchestrator.(ptr)
+  * @param  id      stage.
+  * @param  status  result of the stage.
+  *
+  */
+static void m_pmic_boot_finish(pmic_boot_t *boot, uint8_t id, int32_t status)
+{
+   boot->node[id].state = PMIC_BOOT_DONE;
+   boot->node[id].status = status;
+   boot->node[id].end_ms = M_NOW_MS();
+   boot->done |= PMIC_BOOT_STAGE(id);
+
+   if(boot->done == PMIC_BOOT_STAGE(boot->count) - 1)
+   {
+      m_pmic_boot_critical(boot);
+   }
+}
+
+/**
+  * @brief  Walk back from the stage that finished last: every stage waited
+  *         for the dependency that finished last, that one is the next link.
+  *         Skipped stages never hold anything up.
+  *
+  * @param  boot  orchestrator.(ptr)
+  *
+  */
+static void m_pmic_boot_critical(pmic_boot_t *boot)
+{
+   int8_t id = -1;
+   int8_t dep;
+   uint8_t after;
+
+   for(uint8_t i = 0; i < boot->count; i++)
+   {
+      if(boot->node[i].state == PMIC_BOOT_DONE &&
+         (id < 0 || (int32_t)(boot->node[i].end_ms - boot->node[id].end_ms) >= 0))
+      {
+         id = i;
+      }
+   }
+
+   boot->critical = 0;
+   while(id >= 0)
+   {
+      boot->critical |= PMIC_BOOT_STAGE(id);
+      after = boot->cfg[id].after;
+      dep = -1;
+      for(uint8_t i = 0; i < id; i++)
+      {
+         if((after & PMIC_BOOT_STAGE(i)) && boot->node[i].state == PMIC_BOOT_DONE &&
+            (dep < 0 || (int32_t)(boot->node[i].end_ms - boot->node[dep].end_ms) >= 0))
+         {
+            dep = i;
+         }
+      }
+      id = dep;
+   }
+}
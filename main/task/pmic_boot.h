@@ -0,0 +1,106 @@
+/*
+ * pmic_boot.h
+ *
+ *  Boot orchestrator of the PMIC task. Bring-up is a graph of stages, each
+ *  one starts as soon as the stages it depends on are done, so independent
+ *  chains (PM rails, fuel gauge model) overlap instead of running one after
+ *  the other. A stage either finishes inside its run function or starts
+ *  work that the supervisor jobs continue and reports the end with
+ *  pmic_boot_done(). Every stage records its start and end on the
+ *  esp_timer clock, the critical path is the chain of stages that held up
+ *  the last one to finish.
+ */
+
+#ifndef MAIN_TASK_PMIC_BOOT_H_
+#define MAIN_TASK_PMIC_BOOT_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+
+/* Public defines ----------------------------------------------------- */
+#define PMIC_BOOT_MAX_STAGES  8
+#define PMIC_BOOT_PENDING     1             //Run result: the stage ends with pmic_boot_done()
+
+#define PMIC_BOOT_STAGE(id)   (1U << (id))  //Bit of a stage in pmic_boot_stage_cfg_t.after
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief  Stage body. PMIC_BOOT_PENDING, or the status of a stage done at once (0: Success)
+ */
+typedef int32_t (*pmic_boot_run_ptr)(void *arg, uint32_t now_ms);
+
+/**
+ * @brief  One stage of the graph, a stage only depends on stages before it
+ */
+typedef struct
+{
+   const char *name;
+   uint8_t after;              //PMIC_BOOT_STAGE() of the stages that must be done first
+   pmic_boot_run_ptr run;
+} pmic_boot_stage_cfg_t;
+
+/**
+ * @brief  Stage states
+ */
+typedef enum
+{
+   PMIC_BOOT_WAITING = 0,
+   PMIC_BOOT_RUNNING,
+   PMIC_BOOT_DONE,
+   PMIC_BOOT_SKIPPED,          //Not part of this boot, counts as done
+} pmic_boot_state_t;
+
+/**
+ * @brief  Measured timing of one stage
+ */
+typedef struct
+{
+   uint8_t  state;             //pmic_boot_state_t
+   int32_t  status;
+   uint32_t start_ms;
+   uint32_t end_ms;
+} pmic_boot_node_t;
+
+/**
+ * @brief  Orchestrator state
+ */
+typedef struct
+{
+   const pmic_boot_stage_cfg_t *cfg;
+   uint8_t count;
+   pmic_boot_node_t node[PMIC_BOOT_MAX_STAGES];
+   void *arg;                  //Argument of the run functions
+   uint8_t  done;              //PMIC_BOOT_STAGE() of the stages done or skipped
+   uint8_t  critical;          //PMIC_BOOT_STAGE() of the critical path, once every stage is done
+   uint32_t start_ms;          //pmic_boot_init()
+} pmic_boot_t;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+  * @brief  Load the graph, nothing runs yet. -1 if a stage depends on itself or a later stage
+ */
+int32_t pmic_boot_init(pmic_boot_t *boot, const pmic_boot_stage_cfg_t *cfg, uint8_t count, void *arg);
+
+/**
+  * @brief  Leave the PMIC_BOOT_STAGE() stages out of this boot, their dependents do not wait for them
+ */
+void pmic_boot_skip(pmic_boot_t *boot, uint8_t stages);
+
+/**
+  * @brief  Run every stage whose dependencies are done. PMIC_BOOT_PENDING, or 0 once every stage is done
+ */
+int32_t pmic_boot_step(pmic_boot_t *boot);
+
+/**
+  * @brief  End of a pending stage. -1 if the stage is not running
+ */
+int32_t pmic_boot_done(pmic_boot_t *boot, uint8_t id, int32_t status);
+
+/**
+  * @brief  Log the timeline, critical path stages are marked with '*'
+ */
+void pmic_boot_dump(const pmic_boot_t *boot, const char *tag);
+
+
+#endif /* MAIN_TASK_PMIC_BOOT_H_ */
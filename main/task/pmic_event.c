@@ -0,0 +1,154 @@
+/*
+ * pmic_event.c
+ *
+ *  Publish / subscribe of PMIC state changes.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "pmic_event.h"
+#include <stddef.h>
+#include <esp_log.h>
+
+/* Private defines ---------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------- */
+/* Private macros ----------------------------------------------------- */
+#define SUCCESS   0
+#define ERROR     -1
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+static const char* TAG = "pmic EVENT";
+static portMUX_TYPE m_event_lock = portMUX_INITIALIZER_UNLOCKED;   //Serializes the subscribers
+
+/* Private function prototypes ---------------------------------------- */
+static uint8_t m_event_wanted(const pmic_event_sub_t *sub, const pmic_event_t *ev);
+
+/* Function definitions ----------------------------------------------- */
+
+/**
+  * @brief  Add a subscriber. The slot is filled before the count that
+  *         makes it visible to the publisher is raised.
+  *
+  * @param  bus        event bus.(ptr)
+  * @param  name       subscriber name, kept by reference.(ptr)
+  * @param  mask       PMIC_EVENT_MASK() of the wanted types.
+  * @param  soc_delta  smallest RepSOC change in % worth an event, 0 as 1.
+  * @param  depth      queue depth in events.
+  * @retval            subscriber id, -1: No room or no memory
+  *
+  */
+int32_t pmic_event_subscribe(pmic_event_bus_t *bus, const char *name, uint32_t mask, uint8_t soc_delta, uint8_t depth)
+{
+   QueueHandle_t queue = xQueueCreate(depth, sizeof(pmic_event_t));
+   int32_t id = ERROR;
+
+   if(queue == NULL)
+   {
+      ESP_LOGE(TAG, "pmic_event_subscribe() no queue for %s", name);
+      return ERROR;
+   }
+
+   portENTER_CRITICAL(&m_event_lock);
+   if(bus->count < PMIC_EVENT_MAX_SUBS)
+   {
+      id = bus->count;
+      bus->sub[id] = (pmic_event_sub_t){ .name = name, .queue = queue, .mask = mask,
+                                         .soc_delta = soc_delta ? soc_delta : 1, .soc_last = -1 };
+      __atomic_store_n(&bus->count, id + 1, __ATOMIC_RELEASE);
+   }
+   portEXIT_CRITICAL(&m_event_lock);
+
+   if(id == ERROR)
+   {
+      ESP_LOGE(TAG, "pmic_event_subscribe() no room for %s", name);
+      vQueueDelete(queue);
+   }
+
+   return id;
+}
+
+/**
+  * @brief  Queue the event to every subscriber that wants it. A full
+  *         queue drops the event for that subscriber only, the publisher
+  *         never waits.
+  *
+  * @param  bus  event bus.(ptr)
+  * @param  ev   event.(ptr)
+  *
+  */
+void pmic_event_publish(pmic_event_bus_t *bus, const pmic_event_t *ev)
+{
+   uint8_t count = __atomic_load_n(&bus->count, __ATOMIC_ACQUIRE);
+   pmic_event_sub_t *sub;
+
+   for(uint8_t i = 0; i < count; i++)
+   {
+      sub = &bus->sub[i];
+      if(!m_event_wanted(sub, ev))
+      {
+         continue;
+      }
+
+      if(xQueueSend(sub->queue, ev, 0) != pdPASS)
+      {
+         sub->dropped++;
+         continue;
+      }
+
+      sub->delivered++;
+      if(ev->type == PMIC_EVENT_SOC)
+      {
+         sub->soc_last = ev->data.soc_pct;
+      }
+   }
+}
+
+/**
+  * @brief  Wait for the next event of a subscriber
+  *
+  * @param  bus         event bus.(ptr)
+  * @param  id          subscriber id.
+  * @param  ev          received event.(ptr)
+  * @param  timeout_ms  longest wait, portMAX_DELAY waits forever.
+  * @retval             0: ev is valid, -1: Timeout or bad id
+  *
+  */
+int32_t pmic_event_receive(pmic_event_bus_t *bus, int32_t id, pmic_event_t *ev, uint32_t timeout_ms)
+{
+   if(id < 0 || id >= __atomic_load_n(&bus->count, __ATOMIC_ACQUIRE))
+   {
+      return ERROR;
+   }
+
+   return xQueueReceive(bus->sub[id].queue, ev,
+                        timeout_ms == portMAX_DELAY ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms)) == pdPASS ? SUCCESS : ERROR;
+}
+
+/* Private function definitions ---------------------------------------- */
+/**
+  * @brief  Event passes the filters of the subscriber: its type is in the
+  *         mask and a SOC event moved at least soc_delta from the last one
+  *         queued to it.
+  *
+  * @param  sub  subscriber.(ptr)
+  * @param  ev   event.(ptr)
+  * @retval      1: Queue it, 0: Filtered out
+  *
+  */
+static uint8_t m_event_wanted(const pmic_event_sub_t *sub, const pmic_event_t *ev)
+{
+   int16_t moved;
+
+   if(!(sub->mask & PMIC_EVENT_MASK(ev->type)))
+   {
+      return 0;
+   }
+   if(ev->type != PMIC_EVENT_SOC || sub->soc_last < 0)
+   {
+      return 1;
+   }
+
+   moved = ev->data.soc_pct - sub->soc_last;
+
+   return (moved < 0 ? -moved : moved) >= sub->soc_delta;
+}
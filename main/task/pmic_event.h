@@ -0,0 +1,100 @@
+/*
+ * pmic_event.h
+ *
+ *  Publish / subscribe of PMIC state changes. A subscriber has its own
+ *  bounded queue, a mask of the event types it wants and, for SOC events,
+ *  the smallest change it wants to hear of, so a consumer only wakes for
+ *  what it cares about. The PMIC task publishes without ever blocking: an
+ *  event that does not fit in a full queue is dropped and counted on that
+ *  subscriber. Subscribers register on m_pmic_event_bus_t (pmic_task.c)
+ *  from any task and wait with pmic_event_receive().
+ */
+
+#ifndef MAIN_TASK_PMIC_EVENT_H_
+#define MAIN_TASK_PMIC_EVENT_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "max77658_chg.h"
+
+/* Public defines ----------------------------------------------------- */
+#define PMIC_EVENT_MAX_SUBS    8
+
+#define PMIC_EVENT_MASK(type)  (1UL << (type))
+#define PMIC_EVENT_ALL         (PMIC_EVENT_MASK(PMIC_EVENT_COUNT) - 1)
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief  Event types, the member of pmic_event_t.data that is valid
+ */
+typedef enum
+{
+   PMIC_EVENT_SOC = 0,         //soc_pct: RepSOC moved
+   PMIC_EVENT_CHARGER,         //chg: charger status changed
+   PMIC_EVENT_BUTTON,          //gesture: nEN gesture, button_gesture_event_t
+   PMIC_EVENT_THERMAL,         //int_glbl0: TJAL1_R / TJAL2_R bits, die temperature alarm
+   PMIC_EVENT_RAIL_FAULT,      //int_glbl1: LDO0_F / LDO1_F / SBB_TO bits
+   PMIC_EVENT_COUNT,
+} pmic_event_type_t;
+
+/**
+ * @brief  One event, copied into the queue of every subscriber that wants it
+ */
+typedef struct
+{
+   uint8_t  type;              //pmic_event_type_t
+   uint32_t t_ms;
+   union
+   {
+      int16_t soc_pct;
+      max77658_chg_status_t chg;
+      uint8_t gesture;
+      uint8_t int_glbl0;
+      uint8_t int_glbl1;
+   } data;
+} pmic_event_t;
+
+/**
+ * @brief  Subscriber, the counters are written by the publisher only
+ */
+typedef struct
+{
+   const char *name;
+   QueueHandle_t queue;
+   uint32_t mask;              //PMIC_EVENT_MASK() of the wanted types
+   uint8_t  soc_delta;         //SOC events once RepSOC moved this many % from the last one queued
+   int16_t  soc_last;          //-1: None queued yet
+   uint32_t delivered;
+   uint32_t dropped;           //Queue full
+} pmic_event_sub_t;
+
+/**
+ * @brief  Event bus, a zeroed bus has no subscriber
+ */
+typedef struct
+{
+   pmic_event_sub_t sub[PMIC_EVENT_MAX_SUBS];
+   uint8_t count;
+} pmic_event_bus_t;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+  * @brief  Add a subscriber with a queue of depth events, from any task. Returns the id or -1
+ */
+int32_t pmic_event_subscribe(pmic_event_bus_t *bus, const char *name, uint32_t mask, uint8_t soc_delta, uint8_t depth);
+
+/**
+  * @brief  Queue ev to every subscriber that wants it, never blocks
+ */
+void pmic_event_publish(pmic_event_bus_t *bus, const pmic_event_t *ev);
+
+/**
+  * @brief  Wait up to timeout_ms for the next event of subscriber id. 0: ev is valid, -1: timeout
+ */
+int32_t pmic_event_receive(pmic_event_bus_t *bus, int32_t id, pmic_event_t *ev, uint32_t timeout_ms);
+
+
+#endif /* MAIN_TASK_PMIC_EVENT_H_ */
@@ -0,0 +1,80 @@
+/*
+ * pmic_state.c
+ *
+ *  Battery and charger state published by the PMIC task.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "pmic_state.h"
+#include <string.h>
+
+/* Private defines ---------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------- */
+/* Private macros ----------------------------------------------------- */
+#define M_SEQ_LOAD(state)         __atomic_load_n(&(state)->seq, __ATOMIC_ACQUIRE)
+#define M_SEQ_STORE(state, value) __atomic_store_n(&(state)->seq, (value), __ATOMIC_RELEASE)
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+/* Private function prototypes ---------------------------------------- */
+/* Function definitions ----------------------------------------------- */
+
+/**
+  * @brief  Publish a new state. The counter turns odd so readers move to
+  *         copy[1] while copy[0] is written, then even so they move back
+  *         while copy[1] is written. Every reader always has one copy that
+  *         is not being written.
+  *
+  * @param  state  published block.(ptr)
+  * @param  snap   new state.(ptr)
+  *
+  */
+void pmic_state_publish(pmic_state_t *state, const pmic_state_snapshot_t *snap)
+{
+   uint32_t seq = state->seq;
+
+   M_SEQ_STORE(state, seq + 1);
+   __atomic_thread_fence(__ATOMIC_SEQ_CST);
+   memcpy(&state->copy[0], snap, sizeof(*snap));
+
+   M_SEQ_STORE(state, seq + 2);
+   __atomic_thread_fence(__ATOMIC_SEQ_CST);
+   memcpy(&state->copy[1], snap, sizeof(*snap));
+}
+
+/**
+  * @brief  Copy the copy selected by the counter, again if a publish
+  *         moved the counter meanwhile. The copy is the generation
+  *         counter / 2 in both halves of a publish.
+  *
+  * @param  state  published block.(ptr)
+  * @param  snap   copy of the state.(ptr)
+  * @retval        generation of the copy, 0: Nothing published yet
+  *
+  */
+uint32_t pmic_state_read(const pmic_state_t *state, pmic_state_snapshot_t *snap)
+{
+   uint32_t seq;
+
+   do
+   {
+      seq = M_SEQ_LOAD(state);
+      memcpy(snap, &state->copy[seq & 1], sizeof(*snap));
+      __atomic_thread_fence(__ATOMIC_SEQ_CST);
+   } while(M_SEQ_LOAD(state) != seq);
+
+   return seq / 2;
+}
+
+/**
+  * @brief  Generation of the latest publish, a publish in progress still
+  *         counts as the one before it
+  *
+  * @param  state  published block.(ptr)
+  * @retval        generation, 0: Nothing published yet
+  *
+  */
+uint32_t pmic_state_generation(const pmic_state_t *state)
+{
+   return M_SEQ_LOAD(state) / 2;
+}
@@ -0,0 +1,67 @@
+/*
+ * pmic_state.h
+ *
+ *  Battery and charger state published by the PMIC task for other tasks.
+ *  The block holds two copies of the state and a sequence counter (a
+ *  seqlock latch): the PMIC task rewrites one copy while readers use the
+ *  other, a reader only retries when a publish overtook its copy. Readers
+ *  take no lock and cause no bus traffic, any number of them may read
+ *  while the PMIC task publishes. The generation counts the publishes, a
+ *  reader that saw generation g has new data once it changes.
+ */
+
+#ifndef MAIN_TASK_PMIC_STATE_H_
+#define MAIN_TASK_PMIC_STATE_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include "max77658_chg.h"
+
+/* Public defines ----------------------------------------------------- */
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief  State of the PMIC at one publish
+ */
+typedef struct
+{
+   uint32_t t_ms;              //Time of the fuel gauge sample
+   int32_t  avg_vcell_uv;
+   int32_t  avg_curr_ua;
+   int32_t  curr_ua;
+   int32_t  rep_cap_mah;
+   int16_t  soc_pct;
+   uint32_t power_uw;          //Battery power of the sample
+   uint8_t  chg_valid;         //chg holds a decoded read
+   max77658_chg_status_t chg;
+   uint16_t sbb0_mv;           //0: Not known yet
+   uint8_t  power_mode;        //max77658_lpm_mode_t
+} pmic_state_snapshot_t;
+
+/**
+ * @brief  Published state, a zeroed block is empty with generation 0
+ */
+typedef struct
+{
+   uint32_t seq;               //Even: readers use copy[0], odd: copy[1]. Generation = seq / 2
+   pmic_state_snapshot_t copy[2];
+} pmic_state_t;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+  * @brief  Publish a new state, one writer only (the PMIC task)
+ */
+void pmic_state_publish(pmic_state_t *state, const pmic_state_snapshot_t *snap);
+
+/**
+  * @brief  Copy a consistent state from any task, returns its generation (0: none published)
+ */
+uint32_t pmic_state_read(const pmic_state_t *state, pmic_state_snapshot_t *snap);
+
+/**
+  * @brief  Generation of the latest publish, for change detection without a copy
+ */
+uint32_t pmic_state_generation(const pmic_state_t *state);
+
+
+#endif /* MAIN_TASK_PMIC_STATE_H_ */
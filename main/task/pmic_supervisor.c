@@ -0,0 +1,285 @@
+/*
+ * pmic_supervisor.c
+ *
+ *  Deadline scheduler of the PMIC jobs.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "pmic_supervisor.h"
+#include <esp_log.h>
+#include "esp_timer.h"
+
+/* Private defines ---------------------------------------------------- */
+#define PMIC_SUPERVISOR_ALL_BITS  ((1u << PMIC_SUPERVISOR_MAX_JOBS) - 1)
+
+/* Private enumerate/structure ---------------------------------------- */
+/* Private macros ----------------------------------------------------- */
+#define SUCCESS   0
+#define ERROR     -1
+
+/* Timestamps may wrap, compare through the signed difference */
+#define M_REACHED(t, deadline)   ((int32_t)((t) - (deadline)) >= 0)
+#define M_NOW_MS()               ((uint32_t)(esp_timer_get_time() / 1000))
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+static const char* TAG = "pmic SUPERVISOR";
+
+/* Private function prototypes ---------------------------------------- */
+static TickType_t m_pmic_supervisor_ticks(uint32_t wait_ms);
+
+/* Function definitions ----------------------------------------------- */
+
+/**
+  * @brief  Create the event group of the supervisor
+  *
+  * @param  sup  supervisor.(ptr)
+  * @retval      -1: Event group not created, 0: Success
+  *
+  */
+int32_t pmic_supervisor_init(pmic_supervisor_t *sup)
+{
+   *sup = (pmic_supervisor_t){0};
+   sup->events = xEventGroupCreate();
+
+   return sup->events != NULL ? SUCCESS : ERROR;
+}
+
+/**
+  * @brief  Add a job
+  *
+  * @param  sup        supervisor.(ptr)
+  * @param  name       job name for the logs.(ptr)
+  * @param  run        job body.
+  * @param  arg        argument of run.(ptr)
+  * @param  period_ms  run period, 0 to run only when kicked.
+  * @retval            -1: Table full, otherwise job id
+  *
+  */
+int32_t pmic_supervisor_add(pmic_supervisor_t *sup, const char *name, pmic_supervisor_job_ptr run,
+                            void *arg, uint32_t period_ms)
+{
+   pmic_supervisor_job_t *job;
+
+   if(sup->count >= PMIC_SUPERVISOR_MAX_JOBS)
+   {
+      ESP_LOGE(TAG, "pmic_supervisor_add() no room for %s", name);
+      return ERROR;
+   }
+
+   job = &sup->job[sup->count++];
+   *job = (pmic_supervisor_job_t){ .name = name, .run = run, .arg = arg };
+   pmic_supervisor_set_period(sup, sup->count - 1, period_ms, M_NOW_MS());
+
+   return sup->count - 1;
+}
+
+/**
+  * @brief  Change the period of a job. The next run is period_ms after now_ms.
+  *
+  * @param  sup        supervisor.(ptr)
+  * @param  id         job id, ignored outside the table (a failed add).
+  * @param  period_ms  run period, 0 to run only when kicked.
+  * @param  now_ms     current time.
+  *
+  */
+void pmic_supervisor_set_period(pmic_supervisor_t *sup, int32_t id, uint32_t period_ms, uint32_t now_ms)
+{
+   pmic_supervisor_job_t *job;
+
+   if(id < 0 || id >= sup->count)
+   {
+      return;
+   }
+
+   job = &sup->job[id];
+   job->period_ms = period_ms;
+   job->armed = period_ms != 0;
+   job->due_ms = now_ms + period_ms;
+}
+
+/**
+  * @brief  Run a job at due_ms instead of its next period. Called from the
+  *         job body it replaces the deadline computed from the period.
+  *
+  * @param  sup     supervisor.(ptr)
+  * @param  id      job id, ignored outside the table.
+  * @param  due_ms  time of the next run.
+  *
+  */
+void pmic_supervisor_set_due(pmic_supervisor_t *sup, int32_t id, uint32_t due_ms)
+{
+   if(id < 0 || id >= sup->count)
+   {
+      return;
+   }
+
+   sup->job[id].due_ms = due_ms;
+   sup->job[id].armed = 1;
+}
+
+/**
+  * @brief  Set the function called after the jobs of every wake. It runs
+  *         while the CPU and bus are awake anyway, so work that may be done
+  *         early (like a watchdog clear) costs no wake of its own.
+  *
+  * @param  sup   supervisor.(ptr)
+  * @param  hook  called with arg and the wake time, NULL to remove.
+  * @param  arg   argument of hook.(ptr)
+  *
+  */
+void pmic_supervisor_set_hook(pmic_supervisor_t *sup, pmic_supervisor_job_ptr hook, void *arg)
+{
+   sup->hook = hook;
+   sup->hook_arg = arg;
+}
+
+/**
+  * @brief  Wake the supervisor and run a job now
+  *
+  * @param  sup  supervisor.(ptr)
+  * @param  id   job id, ignored outside the table.
+  *
+  */
+void pmic_supervisor_kick(pmic_supervisor_t *sup, int32_t id)
+{
+   if(id < 0 || id >= sup->count)
+   {
+      return;
+   }
+
+   xEventGroupSetBits(sup->events, 1u << id);
+}
+
+/**
+  * @brief  pmic_supervisor_kick() from an interrupt handler
+  *
+  * @param  sup    supervisor.(ptr)
+  * @param  id     job id, ignored outside the table.
+  * @param  woken  set when a context switch is needed.(ptr)
+  *
+  */
+void pmic_supervisor_kick_from_isr(pmic_supervisor_t *sup, int32_t id, BaseType_t *woken)
+{
+   if(id < 0 || id >= sup->count)
+   {
+      return;
+   }
+
+   xEventGroupSetBitsFromISR(sup->events, 1u << id, woken);
+}
+
+/**
+  * @brief  Time left until the earliest job deadline
+  *
+  * @param  sup     supervisor.(ptr)
+  * @param  now_ms  current time.
+  * @retval         ms to wait, 0 if a job is overdue, PMIC_SUPERVISOR_NO_WAKE if none is armed
+  *
+  */
+uint32_t pmic_supervisor_wait_ms(const pmic_supervisor_t *sup, uint32_t now_ms)
+{
+   uint32_t wait = PMIC_SUPERVISOR_NO_WAKE;
+   uint32_t left;
+
+   for(uint8_t i = 0; i < sup->count; i++)
+   {
+      if(!sup->job[i].armed)
+      {
+         continue;
+      }
+
+      left = M_REACHED(now_ms, sup->job[i].due_ms) ? 0 : sup->job[i].due_ms - now_ms;
+      if(left < wait)
+      {
+         wait = left;
+      }
+   }
+
+   return wait;
+}
+
+/**
+  * @brief  Block on the event group until the earliest deadline or a kick,
+  *         then run every kicked or overdue job once, then the hook. A job is rescheduled
+  *         one period after this wake before its body runs, so the body can
+  *         still override the deadline with pmic_supervisor_set_due().
+  *
+  * @param  sup  supervisor.(ptr)
+  *
+  */
+void pmic_supervisor_step(pmic_supervisor_t *sup)
+{
+   pmic_supervisor_job_t *job;
+   EventBits_t kicked;
+   uint32_t now;
+
+   kicked = xEventGroupWaitBits(sup->events, PMIC_SUPERVISOR_ALL_BITS, pdTRUE, pdFALSE,
+                                m_pmic_supervisor_ticks(pmic_supervisor_wait_ms(sup, M_NOW_MS())));
+   kicked &= PMIC_SUPERVISOR_ALL_BITS;
+
+   sup->wakes++;
+   if(kicked)
+   {
+      sup->kicked_wakes++;
+   }
+
+   now = M_NOW_MS();
+   for(uint8_t i = 0; i < sup->count; i++)
+   {
+      job = &sup->job[i];
+      if(!(kicked & (1u << i)) && !(job->armed && M_REACHED(now, job->due_ms)))
+      {
+         continue;
+      }
+
+      job->armed = job->period_ms != 0;
+      job->due_ms = now + job->period_ms;
+      job->runs++;
+      job->run(job->arg, now);
+   }
+
+   if(sup->hook != NULL)
+   {
+      sup->hook(sup->hook_arg, now);
+   }
+}
+
+/**
+  * @brief  Supervisor loop, never returns
+  *
+  * @param  sup  supervisor.(ptr)
+  *
+  */
+void pmic_supervisor_run(pmic_supervisor_t *sup)
+{
+   while(1)
+   {
+      pmic_supervisor_step(sup);
+   }
+}
+
+/* Private function definitions ---------------------------------------- */
+/**
+  * @brief  Convert a wait to ticks. The first tick of a wait is partial,
+  *         so one tick is added to never wake before the deadline (an
+  *         early wake would find nothing to do).
+  *
+  * @param  wait_ms  time to wait.
+  * @retval          ticks for xEventGroupWaitBits()
+  *
+  */
+static TickType_t m_pmic_supervisor_ticks(uint32_t wait_ms)
+{
+   if(wait_ms == PMIC_SUPERVISOR_NO_WAKE)
+   {
+      return portMAX_DELAY;
+   }
+
+   if(wait_ms == 0)
+   {
+      return 0;
+   }
+
+   return wait_ms / portTICK_PERIOD_MS + 1;
+}
@@ -0,0 +1,105 @@
+/*
+ * pmic_supervisor.h
+ *
+ *  Deadline scheduler of the PMIC jobs. The supervisor sleeps on one event
+ *  group until the earliest job deadline, or until another task / ISR kicks
+ *  a job, so an idle system wakes only when work is due.
+ */
+
+#ifndef MAIN_TASK_PMIC_SUPERVISOR_H_
+#define MAIN_TASK_PMIC_SUPERVISOR_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+
+/* Public defines ----------------------------------------------------- */
+#define PMIC_SUPERVISOR_MAX_JOBS  12          //One event group bit per job, 24 bits per group
+#define PMIC_SUPERVISOR_NO_WAKE   UINT32_MAX  //Nothing scheduled, wait for a kick
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief  Job body, now_ms is the time the supervisor woke up
+ */
+typedef void (*pmic_supervisor_job_ptr)(void *arg, uint32_t now_ms);
+
+/**
+ * @brief  Scheduled job
+ */
+typedef struct
+{
+   const char *name;
+   pmic_supervisor_job_ptr run;
+   void *arg;
+   uint32_t period_ms;     //0: runs only when kicked or rescheduled
+   uint32_t due_ms;
+   uint8_t  armed;         //due_ms is valid
+   uint32_t runs;
+} pmic_supervisor_job_t;
+
+/**
+ * @brief  Supervisor state
+ */
+typedef struct
+{
+   EventGroupHandle_t events;  //Bit n runs job n at once
+   uint8_t count;
+   pmic_supervisor_job_t job[PMIC_SUPERVISOR_MAX_JOBS];
+   pmic_supervisor_job_ptr hook;  //Runs after the jobs of every wake
+   void *hook_arg;
+   uint32_t wakes;             //Returns from the wait
+   uint32_t kicked_wakes;      //Wakes caused by a kick instead of a deadline
+} pmic_supervisor_t;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+  * @brief  Create the event group, no jobs
+ */
+int32_t pmic_supervisor_init(pmic_supervisor_t *sup);
+
+/**
+  * @brief  Add a job, first run after period_ms. Returns the job id or -1
+ */
+int32_t pmic_supervisor_add(pmic_supervisor_t *sup, const char *name, pmic_supervisor_job_ptr run,
+                            void *arg, uint32_t period_ms);
+
+/**
+  * @brief  Change the period of a job and reschedule it from now_ms
+ */
+void pmic_supervisor_set_period(pmic_supervisor_t *sup, int32_t id, uint32_t period_ms, uint32_t now_ms);
+
+/**
+  * @brief  Run a job at due_ms, e.g. from inside the job to override its period once
+ */
+void pmic_supervisor_set_due(pmic_supervisor_t *sup, int32_t id, uint32_t due_ms);
+
+/**
+  * @brief  Run hook after the jobs of every wake, e.g. to piggyback bus work on it
+ */
+void pmic_supervisor_set_hook(pmic_supervisor_t *sup, pmic_supervisor_job_ptr hook, void *arg);
+
+/**
+  * @brief  Wake the supervisor and run a job now
+ */
+void pmic_supervisor_kick(pmic_supervisor_t *sup, int32_t id);
+void pmic_supervisor_kick_from_isr(pmic_supervisor_t *sup, int32_t id, BaseType_t *woken);
+
+/**
+  * @brief  Milliseconds until the earliest deadline, PMIC_SUPERVISOR_NO_WAKE if none
+ */
+uint32_t pmic_supervisor_wait_ms(const pmic_supervisor_t *sup, uint32_t now_ms);
+
+/**
+  * @brief  Sleep until the next deadline or kick and run the due jobs
+ */
+void pmic_supervisor_step(pmic_supervisor_t *sup);
+
+/**
+  * @brief  pmic_supervisor_step() forever
+ */
+void pmic_supervisor_run(pmic_supervisor_t *sup);
+
+
+#endif /* MAIN_TASK_PMIC_SUPERVISOR_H_ */
@@ -9,33 +9,191 @@
 #include <stdio.h>
 #include <esp_log.h>
 #include "bsp.h"
+#include "bsp_mutex.h"
+#include "i2c_bus.h"
 #include "max77658_fg_types.h"
 #include "max77658_fg.h"
+#include "max77658_fg_async.h"
 #include "max77658_defines.h"
 #include "max77658_pm.h"
+#include "max77658_fg_energy.h"
+#include "max77658_chg.h"
+#include "max77658_chg_ctrl.h"
+#include "max77658_dvs.h"
+#include "max77658_seq.h"
+#include "max77658_lpm.h"
+#include "max77658_dump.h"
+#include "telemetry.h"
+#include "button_gesture.h"
+#include "pmic_supervisor.h"
+#include "pmic_wdt.h"
+#include "pmic_state.h"
+#include "pmic_event.h"
+#include "pmic_boot.h"
 #include "esp_sntp.h"
+#include "esp_timer.h"
 
 
 /* Private defines ---------------------------------------------------- */
+#define PMIC_ENERGY_RSENSE_MOHM   10        //Sense resistor of the fuel gauge
+#define PMIC_ENERGY_WINDOW_MS     3600000   //Hourly power statistics
+#define PMIC_NOW_MS()             ((uint32_t)(esp_timer_get_time() / 1000))
+#define PMIC_FG_STAGE_STATUS(r)   ((r) == MAX77658_FG_ASYNC_ERR_NO_POR ? 0 : (r))  //Warm boot keeps the model, not a failure
+#define PMIC_BUTTON_POLL_MS       20        //Interrupt poll period while a gesture is in progress
+#define PMIC_BUTTON_IDLE_MS       200       //Interrupt poll period between gestures, nIRQ is not wired to a GPIO
+#define PMIC_IRQ_REGS             5         //INT_GLBL0, INT_CHG, STAT_CHG_A, STAT_CHG_B, INT_GLBL1
+#define PMIC_BATTERY_PERIOD_MS    1000      //Battery telemetry cadence under load
+#define PMIC_BATTERY_IDLE_MS      5000      //Battery telemetry cadence at rest, below MAX77658_FG_ENERGY_MAX_GAP_MS
+#define PMIC_IDLE_CURRENT_UA      5000      //|AvgCurrent| below this is rest
+#define PMIC_ALERT_PERIOD_MS      30000     //FG alerts are latched, STATUS is read this often
+#define PMIC_ALERT_VMIN_MV        3300
+#define PMIC_ALERT_VMAX_MV        4300
+#define PMIC_ALERT_SMIN           5         //%
+#define PMIC_ALERT_SMAX           0xFF      //Disabled
+#define PMIC_STATS_PERIOD_MS      60000     //Supervisor wake counters
+#define PMIC_CHG_CTRL_PERIOD_MS   5000      //Charge current controller step, the gains assume this cadence
+#define PMIC_BATT_CAP_MAH         175       //DesignCap 0x015E at PMIC_ENERGY_RSENSE_MOHM
+#define PMIC_CHG_CC_MAX_UA        (PMIC_BATT_CAP_MAH * 500)   //0.5C charge ceiling
+#define PMIC_SBB0_RUN_MV          3300      //SBB0 under load
+#define PMIC_SBB0_IDLE_MV         3100      //SBB0 at rest, ESP32 supply range is 3.0V..3.6V
+#define PMIC_DVS_STEP_MV          50        //Largest SBB0 change per write while ramping down
+#define PMIC_DVS_SETTLE_MS        2         //Between ramp writes
+#define PMIC_DUMP_CHUNK           44        //Image bytes per TELEMETRY_DUMP record
+#define PMIC_WDT_PER              0b01      //tWD = 32s
+#define PMIC_WDT_MODE             1         //Power-reset on expiry
+#define PMIC_WDT_RETRY_MS         1000      //Deadline retry while a clear is withheld
 /* Private enumerate/structure ---------------------------------------- */
+/**
+ * @brief  Boot stages, in dependency order
+ */
+typedef enum
+{
+   BOOT_BUS = 0,
+   BOOT_FG_POR,
+   BOOT_PM_BASE,
+   BOOT_RAILS,
+   BOOT_PM_RUN,
+   BOOT_FG_MODEL,
+   BOOT_FG_READY,
+   BOOT_DUMP,
+   BOOT_STAGES,
+} boot_stage_t;
+
 /* Private macros ----------------------------------------------------- */
 /* Public variables --------------------------------------------------- */
 /* Private variables -------------------------------------------------- */
 static const char* TAG = "pmic TASK";
 static saved_FG_params_t saved_param;
 max77658_fg_t m_max77658_fg_t;
+static max77658_fg_async_t m_max77658_fg_async_t;
 max77658_pm_t m_max77658_pm_t;
+max77658_fg_energy_t m_max77658_fg_energy_t;
+button_gesture_t m_button_gesture_t;
+max77658_chg_t m_max77658_chg_t;
+max77658_chg_ctrl_t m_max77658_chg_ctrl_t;
+max77658_dvs_t m_max77658_dvs_t;
+max77658_seq_t m_max77658_seq_t;
+max77658_lpm_t m_max77658_lpm_t;
+pmic_supervisor_t m_pmic_supervisor_t;
+pmic_wdt_t m_pmic_wdt_t;
+pmic_state_t m_pmic_state_t;
+pmic_event_bus_t m_pmic_event_bus_t;
+static pmic_state_snapshot_t m_pmic_snapshot;   //Working copy, published to m_pmic_state_t
+static int32_t m_irq_job;
+static int32_t m_battery_job;
+static int32_t m_alert_job;
+static int32_t m_charge_job;
+static int32_t m_fg_job;
+static int32_t m_boot_job;
+static int32_t m_wdt_job;
+static int32_t m_dvs_job = -1;
+static int32_t m_seq_job;
+static uint8_t m_pmic_dump[MAX77658_DUMP_SIZE];
+static pmic_boot_t m_pmic_boot_t;
 
+/* Charge current controller, CHG_CC never above the battery rating */
+static const max77658_chg_ctrl_cfg_t m_pmic_chg_ctrl_cfg =
+{
+   .cc_min       = 0x03,                       //30mA
+   .cc_max       = MAX77658_CHG_CC_CODE(PMIC_CHG_CC_MAX_UA),
+   .ilim_max     = MAX77658_CHG_ILIM_MAX_LEVEL,
+   .jeita_pct    = 50,
+   .batt_max_c   = 44,
+   .batt_hyst_c  = 1,
+   .settle_steps = 6,
+   .batt_settle_steps = 60,
+   .probe_steps  = 120,
+   .track_pct    = 80,
+};
 
-uint8_t butLst;
+/* Board rails: SBB0 is forced on, it must stay up in the "On via Software" state too */
+static const max77658_seq_rail_t m_pmic_rails[] =
+{
+   { .rail = MAX77658_RAIL_SBB0, .after = 0, .delay_ms = 0, .ramp_ms = 2, .fps = 0 },
+};
 
-//GERRY MOD
-//enum { None, SingleClick, DoubleClick };
-enum { None, SingleClick, DoubleClick, YesSingle};
+//Battery Parameters Storage from the Fuel Gauge MAX17055
+static union max17055_u {
+     struct battery {
+     int8_t avg_soc_FG;     // in Battery Percent
+     float tte_FG;            // in seconds
+     float ttf_FG;           // in seconds
+     int avg_vcell_FG;       // in 78.125uV per bit
+     float avg_curr_FG;      // in uAmps
+     float curr_FG;          // in uAmps
+     int rep_cap;            // in mAh
+     int rep_SOC;            // in %
+    } battery;
+} max17055_u;
 
 /* Private function prototypes ---------------------------------------- */
+static void m_pmic_supervisor_start(uint8_t with_pm);
+static void m_pmic_boot_job(void *arg, uint32_t now_ms);
+static void m_pmic_boot_done(uint8_t id, int32_t status, uint32_t now_ms);
+static void m_pmic_boot_report(void);
+static int32_t m_pmic_boot_bus(void *arg, uint32_t now_ms);
+static int32_t m_pmic_boot_pm_base(void *arg, uint32_t now_ms);
+static int32_t m_pmic_boot_rails(void *arg, uint32_t now_ms);
+static int32_t m_pmic_boot_pm_run(void *arg, uint32_t now_ms);
+static int32_t m_pmic_boot_fg_por(void *arg, uint32_t now_ms);
+static int32_t m_pmic_boot_fg_model(void *arg, uint32_t now_ms);
+static int32_t m_pmic_boot_fg_ready(void *arg, uint32_t now_ms);
+static int32_t m_pmic_boot_dump(void *arg, uint32_t now_ms);
+static void m_pmic_fg_job(void *arg, uint32_t now_ms);
+static void m_pmic_irq_job(void *arg, uint32_t now_ms);
+static void m_pmic_battery_job(void *arg, uint32_t now_ms);
+static void m_pmic_alert_job(void *arg, uint32_t now_ms);
+static void m_pmic_wdt_job(void *arg, uint32_t now_ms);
+static void m_pmic_wake_hook(void *arg, uint32_t now_ms);
+static void m_pmic_wdt_health(void *arg, int32_t id, uint8_t missed, uint32_t now_ms);
+static void m_pmic_stats_job(void *arg, uint32_t now_ms);
+static void m_pmic_charge_job(void *arg, uint32_t now_ms);
+static void m_pmic_dvs_job(void *arg, uint32_t now_ms);
+static void m_pmic_seq_job(void *arg, uint32_t now_ms);
+static void m_pmic_seq_report(int32_t up, uint32_t t_ms);
+static void m_pmic_rail_report(max77658_rail_t rail, uint16_t mv, uint32_t t_ms);
+static void m_pmic_power_mode(int32_t avg_curr_ua, uint32_t t_ms);
+static void m_pmic_dump_report(uint8_t with_pm, uint32_t t_ms);
+static void m_pmic_button_report(button_gesture_event_t event, uint32_t t_ms);
+static void m_pmic_button_edges(uint8_t int_glbl0, uint32_t t_ms);
+static void m_pmic_charger_report(const max77658_chg_status_t *status, uint32_t t_ms);
+static void m_pmic_fault_events(uint8_t int_glbl0, uint8_t int_glbl1, uint32_t t_ms);
+
+/* Boot graph: the fuel gauge is read as soon as the bus is up, its model
+   load waits for the rails, so the DNR poll overlaps the PM bring-up */
+static const pmic_boot_stage_cfg_t m_pmic_boot_stages[BOOT_STAGES] =
+{
+   [BOOT_BUS]      = { "bus",      0,                                                            m_pmic_boot_bus },
+   [BOOT_FG_POR]   = { "fg_por",   PMIC_BOOT_STAGE(BOOT_BUS),                                    m_pmic_boot_fg_por },
+   [BOOT_PM_BASE]  = { "pm_base",  PMIC_BOOT_STAGE(BOOT_BUS),                                    m_pmic_boot_pm_base },
+   [BOOT_RAILS]    = { "rails",    PMIC_BOOT_STAGE(BOOT_PM_BASE),                                m_pmic_boot_rails },
+   [BOOT_PM_RUN]   = { "pm_run",   PMIC_BOOT_STAGE(BOOT_RAILS),                                  m_pmic_boot_pm_run },
+   [BOOT_FG_MODEL] = { "fg_model", PMIC_BOOT_STAGE(BOOT_FG_POR) | PMIC_BOOT_STAGE(BOOT_RAILS),   m_pmic_boot_fg_model },
+   [BOOT_FG_READY] = { "fg_ready", PMIC_BOOT_STAGE(BOOT_FG_MODEL) | PMIC_BOOT_STAGE(BOOT_PM_RUN), m_pmic_boot_fg_ready },
+   [BOOT_DUMP]     = { "dump",     PMIC_BOOT_STAGE(BOOT_FG_READY),                               m_pmic_boot_dump },
+};
+
 /* Function definitions ----------------------------------------------- */
-static int chkButton (uint8_t input);
 
 
 
@@ -43,30 +201,330 @@ void pmic_main_task()
 {
    ESP_LOGI(TAG, "pmic_main_task() Started.");
 
+   //Fuel gauge only: battery, alert and stats jobs
+   m_pmic_supervisor_start(0);
+}
+
+void pmic_task()
+{
+   ESP_LOGI(TAG, "pmic_task() Started.");
+
+   //One task, one wait: the boot stages and every periodic PMIC access are supervisor jobs
+   m_pmic_supervisor_start(1);
+}
+
+/* Private function definitions ---------------------------------------- */
+/**
+  * @brief  Register the jobs, unarmed until the boot stage that sets them
+  *         up, and run the supervisor, never returns
+  *
+  * @param  with_pm  1: Also bring up the PM, poll its interrupts and clear its watchdog.
+  *
+  */
+static void m_pmic_supervisor_start(uint8_t with_pm)
+{
+   if(pmic_supervisor_init(&m_pmic_supervisor_t) != 0)
+   {
+      ESP_LOGE(TAG, "m_pmic_supervisor_start() no event group");
+      return;
+   }
+
+   if(pmic_boot_init(&m_pmic_boot_t, m_pmic_boot_stages, BOOT_STAGES, (void *)(uintptr_t)with_pm) != 0)
+   {
+      ESP_LOGE(TAG, "m_pmic_supervisor_start() boot graph depends on a later stage");
+      return;
+   }
+   if(!with_pm)
+   {
+      pmic_boot_skip(&m_pmic_boot_t, PMIC_BOOT_STAGE(BOOT_PM_BASE) | PMIC_BOOT_STAGE(BOOT_RAILS) | PMIC_BOOT_STAGE(BOOT_PM_RUN));
+   }
+
+   m_boot_job = pmic_supervisor_add(&m_pmic_supervisor_t, "boot", m_pmic_boot_job, NULL, 0);
+   pmic_supervisor_set_due(&m_pmic_supervisor_t, m_boot_job, m_pmic_boot_t.start_ms);
+   m_fg_job = pmic_supervisor_add(&m_pmic_supervisor_t, "fg", m_pmic_fg_job, NULL, 0);
+   m_battery_job = pmic_supervisor_add(&m_pmic_supervisor_t, "battery", m_pmic_battery_job, NULL, 0);
+   m_alert_job = pmic_supervisor_add(&m_pmic_supervisor_t, "alert", m_pmic_alert_job, NULL, 0);
+   pmic_supervisor_add(&m_pmic_supervisor_t, "stats", m_pmic_stats_job, NULL, PMIC_STATS_PERIOD_MS);
+
+   if(with_pm)
+   {
+      m_irq_job = pmic_supervisor_add(&m_pmic_supervisor_t, "irq", m_pmic_irq_job, NULL, 0);
+      m_charge_job = pmic_supervisor_add(&m_pmic_supervisor_t, "charge", m_pmic_charge_job, NULL, 0);
+      m_dvs_job = pmic_supervisor_add(&m_pmic_supervisor_t, "dvs", m_pmic_dvs_job, NULL, 0);
+      m_seq_job = pmic_supervisor_add(&m_pmic_supervisor_t, "seq", m_pmic_seq_job, NULL, 0);
+   }
+
+   pmic_supervisor_run(&m_pmic_supervisor_t);
+}
+
+/**
+  * @brief  Start the boot stages that became ready, log the timeline once
+  *         the last one is done. Runs again whenever a pending stage ends.
+  *
+  * @param  arg     unused.
+  * @param  now_ms  wake time.
+  *
+  */
+static void m_pmic_boot_job(void *arg, uint32_t now_ms)
+{
+   if(pmic_boot_step(&m_pmic_boot_t) == PMIC_BOOT_PENDING)
+   {
+      return;
+   }
+
+   ESP_LOGI(TAG, "m_pmic_boot_job() boot done in %u ms, '*' is the critical path",
+            (unsigned)(now_ms - m_pmic_boot_t.start_ms));
+   pmic_boot_dump(&m_pmic_boot_t, TAG);
+   m_pmic_boot_report();
+}
+
+/**
+  * @brief  End a pending boot stage and run the boot job for its dependents
+  *
+  * @param  id      stage.
+  * @param  status  0: Success, else the error of the stage.
+  * @param  now_ms  current time.
+  *
+  */
+static void m_pmic_boot_done(uint8_t id, int32_t status, uint32_t now_ms)
+{
+   if(pmic_boot_done(&m_pmic_boot_t, id, status) == 0)
+   {
+      pmic_supervisor_set_due(&m_pmic_supervisor_t, m_boot_job, now_ms);
+   }
+}
+
+/**
+  * @brief  Send a TELEMETRY_BOOT record per stage
+  *
+  */
+static void m_pmic_boot_report(void)
+{
+   const pmic_boot_node_t *node;
+   telemetry_record_t rec;
+
+   for(uint8_t i = 0; i < m_pmic_boot_t.count; i++)
+   {
+      node = &m_pmic_boot_t.node[i];
+
+      telemetry_begin(&rec, TELEMETRY_BOOT);
+      telemetry_put_u32(&rec, m_pmic_boot_t.start_ms);
+      telemetry_put_u8(&rec, i);
+      telemetry_put_u16(&rec, node->start_ms - m_pmic_boot_t.start_ms);
+      telemetry_put_u16(&rec, node->end_ms - node->start_ms);
+      telemetry_put_u8(&rec, (uint8_t)(int8_t)node->status);
+      telemetry_put_u8(&rec, ((m_pmic_boot_t.critical & PMIC_BOOT_STAGE(i)) ? 1 : 0) |
+                             (node->state == PMIC_BOOT_SKIPPED ? 2 : 0));
+      telemetry_send(&rec);
+   }
+}
+
+/**
+  * @brief  Boot stage: I2C bus and telemetry UART
+  *
+  * @param  arg     unused.
+  * @param  now_ms  start time.
+  * @retval         0: Success
+  *
+  */
+static int32_t m_pmic_boot_bus(void *arg, uint32_t now_ms)
+{
    bsp_hw_init();
 
+   telemetry_init(bsp_uart_write);
+
+   return 0;
+}
+
+/**
+  * @brief  Boot stage: PM baseline and SBB0 configuration
+  *
+  * @param  arg     unused.
+  * @param  now_ms  start time.
+  * @retval         0: Success, -1: SBB0 configuration failed
+  *
+  */
+static int32_t m_pmic_boot_pm_base(void *arg, uint32_t now_ms)
+{
+   m_max77658_pm_t.device_address = 0x90;
+   m_max77658_pm_t.read_reg = bsp_i2c_read;
+   m_max77658_pm_t.write_reg = bsp_i2c_write;
+
+   //Keep a shadow copy of the configuration registers so read-modify-writes skip the read
+   max77658_pm_cache_enable(&m_max77658_pm_t, 1);
+
+   //Check the boot configuration with burst reads at the end instead of one read per write
+   max77658_pm_set_verify_mode(&m_max77658_pm_t, MAX77658_PM_VERIFY_DEFERRED);
+
+   //Baseline Initialization following rules printed in MAX77650 Programmres Guide Chapter 4 Page 5
+   max77658_pm_base_line_init(&m_max77658_pm_t);
+
+   //Stage the SBB0 fields and write CNFG_SBB0_A/CNFG_SBB0_B once each, the sequencer enables it
+   max77658_pm_txn_begin(&m_max77658_pm_t);
+
+   //Limit output of SBB0 to 333mA
+   max77658_pm_set_IP_SBB0(&m_max77658_pm_t, 0b11);
+   //Set output Voltage of SBB0 to the run point
+   max77658_pm_set_TV_SBB0(&m_max77658_pm_t, max77658_rail_mv_to_code(MAX77658_RAIL_SBB0, PMIC_SBB0_RUN_MV));
+   //Disable Active Discharge at SBB0 Output
+   max77658_pm_set_ADE_SBB0(&m_max77658_pm_t, 0b0);
+
+   if(max77658_pm_txn_commit(&m_max77658_pm_t) != 0 && max77658_pm_txn_retry(&m_max77658_pm_t) != 0)
+   {
+      ESP_LOGE(TAG, "m_pmic_boot_pm_base() SBB0 configuration failed: code %d, reg 0x%02X, step %d",
+               m_max77658_pm_t.err.code, m_max77658_pm_t.err.reg, m_max77658_pm_t.err.step);
+      return -1;
+   }
+
+   return 0;
+}
+
+/**
+  * @brief  Boot stage: rail bring-up. Rails without dependencies are
+  *         enabled here, the seq job brings up the rest and ends the stage.
+  *
+  * @param  arg     unused.
+  * @param  now_ms  start time.
+  * @retval         PMIC_BOOT_PENDING, 0: Every rail is up, -1: Bad rail graph
+  *
+  */
+static int32_t m_pmic_boot_rails(void *arg, uint32_t now_ms)
+{
+   if(max77658_seq_plan(&m_max77658_seq_t, &m_max77658_pm_t, m_pmic_rails, sizeof(m_pmic_rails) / sizeof(m_pmic_rails[0])) != 0)
+   {
+      ESP_LOGE(TAG, "m_pmic_boot_rails() rail graph has a cycle or an unknown rail");
+      return -1;
+   }
+   max77658_seq_start(&m_max77658_seq_t, now_ms);
+   m_pmic_seq_report(max77658_seq_step(&m_max77658_seq_t, now_ms), now_ms);
+
+   if(max77658_pm_set_verify_mode(&m_max77658_pm_t, MAX77658_PM_VERIFY_IMMEDIATE) != 0)
+   {
+      ESP_LOGE(TAG, "m_pmic_boot_rails() boot configuration verify failed: code %d, reg 0x%02X",
+               m_max77658_pm_t.err.code, m_max77658_pm_t.err.reg);
+   }
+
+   if(max77658_seq_due(&m_max77658_seq_t, now_ms) == MAX77658_SEQ_NO_WAKE)
+   {
+      return 0;
+   }
+   pmic_supervisor_set_due(&m_pmic_supervisor_t, m_seq_job, max77658_seq_due(&m_max77658_seq_t, now_ms));
+
+   return PMIC_BOOT_PENDING;
+}
+
+/**
+  * @brief  Boot stage: SBB0 DVS, charger, button and watchdog, then arm the
+  *         irq and charge jobs
+  *
+  * @param  arg     unused.
+  * @param  now_ms  start time.
+  * @retval         0: Success, -1: DVS setup failed
+  *
+  */
+static int32_t m_pmic_boot_pm_run(void *arg, uint32_t now_ms)
+{
+   int32_t ret = 0;
+
+   //SBB0 starts at the run point, the idle point waits in TV_SBB0_DVS (GPIO1 is not wired)
+   if(max77658_dvs_init(&m_max77658_dvs_t, &m_max77658_pm_t, PMIC_DVS_STEP_MV, PMIC_DVS_SETTLE_MS) != 0 ||
+      max77658_dvs_set_points(&m_max77658_dvs_t, PMIC_SBB0_RUN_MV, PMIC_SBB0_IDLE_MV, NULL) != 0)
+   {
+      ESP_LOGE(TAG, "m_pmic_boot_pm_run() SBB0 DVS setup failed");
+      ret = -1;
+   }
+   m_pmic_rail_report(MAX77658_RAIL_SBB0, max77658_rail_code_to_mv(MAX77658_RAIL_SBB0, m_max77658_dvs_t.code), now_ms);
+
+   uint8_t interrupt_REG0 = max77658_pm_get_INT_GLBL0(&m_max77658_pm_t);  //read global interrupt register to clear it
+   ESP_LOGI(TAG, "m_pmic_boot_pm_run() interrupt_REG0: %d", interrupt_REG0);
+
+   button_gesture_init(&m_button_gesture_t, NULL);
+   max77658_chg_init(&m_max77658_chg_t, &m_max77658_pm_t);
+   if(max77658_chg_ctrl_init(&m_max77658_chg_ctrl_t, &m_pmic_chg_ctrl_cfg, &m_max77658_pm_t) != 0)
+   {
+      ESP_LOGE(TAG, "m_pmic_boot_pm_run() CHG_CC read failed, charging at the floor");
+   }
+   max77658_lpm_init(&m_max77658_lpm_t, NULL);
+
+   pmic_supervisor_set_period(&m_pmic_supervisor_t, m_irq_job, PMIC_BUTTON_IDLE_MS, now_ms);
+   pmic_supervisor_set_period(&m_pmic_supervisor_t, m_charge_job, PMIC_CHG_CTRL_PERIOD_MS, now_ms);
+
+   //Watchdog clears ride on the wakes of the other jobs, the wdt job only runs at the deadline
+   if(pmic_wdt_init(&m_pmic_wdt_t, &m_max77658_pm_t, PMIC_WDT_PER, PMIC_WDT_MODE, now_ms) == 0)
+   {
+      pmic_wdt_set_health(&m_pmic_wdt_t, m_pmic_wdt_health, NULL);
+      m_wdt_job = pmic_supervisor_add(&m_pmic_supervisor_t, "wdt", m_pmic_wdt_job, NULL, 0);
+      pmic_supervisor_set_due(&m_pmic_supervisor_t, m_wdt_job, pmic_wdt_deadline(&m_pmic_wdt_t));
+      pmic_supervisor_set_hook(&m_pmic_supervisor_t, m_pmic_wake_hook, NULL);
+   }
+
+   return ret;
+}
+
+/**
+  * @brief  Boot stage: fuel gauge POR check and DNR poll. These only read
+  *         the gauge, the init is held before the model load and the fg job
+  *         ends the stage once it waits there or is done.
+  *
+  * @param  arg     unused.
+  * @param  now_ms  start time.
+  * @retval         PMIC_BOOT_PENDING
+  *
+  */
+static int32_t m_pmic_boot_fg_por(void *arg, uint32_t now_ms)
+{
    m_max77658_fg_t.device_address = 0x6C;
    m_max77658_fg_t.read_reg = bsp_i2c_read;
    m_max77658_fg_t.write_reg = bsp_i2c_write;
 
-   //Battery Parameters Storage from the Fuel Gauge MAX17055
-   union max17055_u {
-        struct battery {
-        int8_t avg_soc_FG;     // in Battery Percent
-        float tte_FG;            // in seconds
-        float ttf_FG;           // in seconds
-        int avg_vcell_FG;       // in 78.125uV per bit
-        float avg_curr_FG;      // in uAmps
-        float curr_FG;          // in uAmps
-        int rep_cap;            // in mAh
-        int rep_SOC;            // in %
-       } battery;
-   } max17055_u;
-
    //Saved Parameters
    //saved_param.cycles = 0; //This value is used for the save parameters function.
 
-   int status; // stores return value of the status of setting up the MAX17055
+   max77658_fg_async_init(&m_max77658_fg_async_t, &m_max77658_fg_t, now_ms);
+   max77658_fg_async_hold(&m_max77658_fg_async_t, 1, now_ms);
+
+   //The POR check is due now: run it at once, so the DNR poll overlaps the PM stages
+   m_pmic_fg_job(NULL, now_ms);
+
+   return PMIC_BOOT_PENDING;
+}
+
+/**
+  * @brief  Boot stage: release the fuel gauge model load. It writes the
+  *         gauge, so it waits for the rails.
+  *
+  * @param  arg     unused.
+  * @param  now_ms  start time.
+  * @retval         PMIC_BOOT_PENDING, else the init result if it ended before the load (0 without POR)
+  *
+  */
+static int32_t m_pmic_boot_fg_model(void *arg, uint32_t now_ms)
+{
+   if(m_max77658_fg_async_t.state == MAX77658_FG_ASYNC_DONE)
+   {
+      return PMIC_FG_STAGE_STATUS(m_max77658_fg_async_t.result);
+   }
+
+   max77658_fg_async_hold(&m_max77658_fg_async_t, 0, now_ms);
+   pmic_supervisor_set_due(&m_pmic_supervisor_t, m_fg_job, max77658_fg_async_due(&m_max77658_fg_async_t));
+
+   return PMIC_BOOT_PENDING;
+}
+
+/**
+  * @brief  Boot stage: fuel gauge init done. Save the parameters, energy
+  *         integrator and alert thresholds, then start the battery and
+  *         alert jobs. The battery job drives the DVS, so it waits for the
+  *         PM stages too.
+  *
+  * @param  arg     unused.
+  * @param  now_ms  start time.
+  * @retval         0: Success, -1: Alert thresholds not set
+  *
+  */
+static int32_t m_pmic_boot_fg_ready(void *arg, uint32_t now_ms)
+{
+   int32_t ret = 0;
    uint8_t array_addresses[7] = 
    {
       MODELCFG_REG,
@@ -78,10 +536,10 @@ void pmic_main_task()
       ICHGTERM_REG
    };
 
-   status = max77658_fg_init(&m_max77658_fg_t);
-   printf("Init FuelGauge Function Status= %X \r\n",status); // Status shoudl retun Zero if the are no issues with the initialization.
+   //Status is zero if there were no issues with the initialization
+   ESP_LOGI(TAG, "m_pmic_boot_fg_ready() FuelGauge init status: %X", (int)m_max77658_fg_async_t.result);
 
-   if(status == 0)
+   if(m_max77658_fg_async_t.result == 0)
    {
       max77658_fg_save_Params(&m_max77658_fg_t, saved_param);
    }
@@ -92,161 +550,660 @@ void pmic_main_task()
    for(int i = 0 ; i < 7 ; i++) 
    {
       regValue[i] = max77658_fg_get_regInfo(&m_max77658_fg_t, array_addresses[i]);
-      printf("%X", regValue[i]);
-      printf(" ");
    }
+   ESP_LOGI(TAG, "m_pmic_boot_fg_ready() ModelCfg %X DesignCap %X FullCapNom %X dPAcc %X dQAcc %X VEmpty %X IChgTerm %X",
+            regValue[0], regValue[1], regValue[2], regValue[3], regValue[4], regValue[5], regValue[6]);
 
-   bsp_delay_ms(2);
+   max77658_fg_energy_init(&m_max77658_fg_energy_t, PMIC_ENERGY_RSENSE_MOHM, PMIC_ENERGY_WINDOW_MS);
 
-   while(1)
+   if(max77658_fg_set_alerts(&m_max77658_fg_t, PMIC_ALERT_VMIN_MV, PMIC_ALERT_VMAX_MV,
+                             PMIC_ALERT_SMIN, PMIC_ALERT_SMAX) != 0)
    {
-      ESP_LOGI(TAG, "pmic_main_task() Looping.");
-
-      max17055_u.battery.avg_vcell_FG = max77658_fg_get_avgVcell(&m_max77658_fg_t);
-      max17055_u.battery.avg_curr_FG  = max77658_fg_get_AvgCurrent(&m_max77658_fg_t);
-      max17055_u.battery.curr_FG      = max77658_fg_get_Current(&m_max77658_fg_t);
-      max17055_u.battery.rep_cap      = max77658_fg_get_battCAP(&m_max77658_fg_t);
-      max17055_u.battery.rep_SOC      = max77658_fg_get_SOC(&m_max77658_fg_t);
+      ESP_LOGE(TAG, "m_pmic_boot_fg_ready() alert thresholds not set");
+      ret = -1;
+   }
 
-      //This code works with Arduino Serial Plotter to visualize data
-      ESP_LOGI(TAG, "pmic_main_task() Battery Information");
-      printf("---avg_vcell_FG:---%f V \n", (max17055_u.battery.avg_vcell_FG/1000000.0)); //V
-      printf("---avg_curr_FG:----%f uA \n", max17055_u.battery.avg_curr_FG);              //uA
-      printf("---curr_FG:--------%f uA \n", max17055_u.battery.curr_FG);                  //uA
-      printf("---rep_cap:--------%d mAh \n", max17055_u.battery.rep_cap);                  //mAh
-      printf("---rep_SOC:--------%d %% \n", max17055_u.battery.rep_SOC);                  //%
-      printf("\n");
+   pmic_supervisor_set_period(&m_pmic_supervisor_t, m_battery_job, PMIC_BATTERY_PERIOD_MS, now_ms);
+   pmic_supervisor_set_period(&m_pmic_supervisor_t, m_alert_job, PMIC_ALERT_PERIOD_MS, now_ms);
 
-      bsp_delay_ms(1000);
-   }
+   return ret;
 }
 
-static int32_t get_current_time() 
+/**
+  * @brief  Boot stage: register image after the boot configuration, a
+  *         triple press captures another one
+  *
+  * @param  arg     with_pm of m_pmic_supervisor_start().
+  * @param  now_ms  start time.
+  * @retval         0: Success
+  *
+  */
+static int32_t m_pmic_boot_dump(void *arg, uint32_t now_ms)
 {
-	struct timeval tv;
-	gettimeofday(&tv, NULL);
-	return (tv.tv_sec * 1000LL + (tv.tv_usec / 1000LL));
-}
+   m_pmic_dump_report((uint8_t)(uintptr_t)arg, now_ms);
 
+   return 0;
+}
 
-void pmic_task()
+/**
+  * @brief  Step the fuel gauge init. The DNR / Refresh polls and the write
+  *         verifies return here instead of sleeping, so the PM jobs keep
+  *         running until the gauge is ready. The fg_por stage ends once
+  *         the init waits for the model load, fg_model once it is done.
+  *
+  * @param  arg     unused.
+  * @param  now_ms  wake time.
+  *
+  */
+static void m_pmic_fg_job(void *arg, uint32_t now_ms)
 {
-   ESP_LOGI(TAG, "pmic_task() Started.");
+   int32_t status = max77658_fg_async_step(&m_max77658_fg_async_t, now_ms);
 
-   bsp_hw_init();
+   if(status == MAX77658_FG_ASYNC_BUSY)
+   {
+      if(max77658_fg_async_held(&m_max77658_fg_async_t))
+      {
+         m_pmic_boot_done(BOOT_FG_POR, 0, now_ms);
+         return;
+      }
+      pmic_supervisor_set_due(&m_pmic_supervisor_t, m_fg_job, max77658_fg_async_due(&m_max77658_fg_async_t));
+      return;
+   }
 
-   m_max77658_pm_t.device_address = 0x90;
-   m_max77658_pm_t.read_reg = bsp_i2c_read;
-   m_max77658_pm_t.write_reg = bsp_i2c_write;
+   ESP_LOGI(TAG, "m_pmic_fg_job() fuel gauge init done in %u steps", (unsigned)m_max77658_fg_async_t.steps);
+   //The -5 of a warm boot stays in the result for the save_Params decision
+   m_pmic_boot_done(BOOT_FG_POR, PMIC_FG_STAGE_STATUS(status), now_ms);
+   m_pmic_boot_done(BOOT_FG_MODEL, PMIC_FG_STAGE_STATUS(status), now_ms);
+}
 
-   //Baseline Initialization following rules printed in MAX77650 Programmres Guide Chapter 4 Page 5
-   max77658_pm_base_line_init(&m_max77658_pm_t);
+/**
+  * @brief  Read INT_GLBL0, INT_CHG, STAT_CHG_A, STAT_CHG_B and INT_GLBL1
+  *         with one burst, report button gestures, charger transitions,
+  *         thermal alarms and rail faults. Between gestures
+  *         the interrupts are read every PMIC_BUTTON_IDLE_MS, during a
+  *         gesture every PMIC_BUTTON_POLL_MS or at the gesture deadline.
+  *         Served in the urgent bus class. A triple press captures a
+  *         register image and logs the mutex and bus statistics.
+  *
+  * @param  arg     unused.
+  * @param  now_ms  wake time.
+  *
+  */
+static void m_pmic_irq_job(void *arg, uint32_t now_ms)
+{
+   uint8_t regs[PMIC_IRQ_REGS];
+   button_gesture_event_t event;
+   uint32_t wait;
+   i2c_bus_class_t cls = i2c_bus_set_class(I2C_BUS_URGENT);
 
-   //Limit output of SBB0 to 333mA
-   max77658_pm_set_IP_SBB0(&m_max77658_pm_t, 0b11);
-   //Set output Voltage of SBB0 to 3.3V
-   max77658_pm_set_TV_SBB0(&m_max77658_pm_t, 0b1110000);
-   //Disable Active Discharge at SBB0 Output
-   max77658_pm_set_ADE_SBB0(&m_max77658_pm_t, 0b0);
-   //Enable SBB0 is on irrespective of FPS whenever the on/off controller is in its "On via Software" or "On via On/Off Controller" states
-   max77658_pm_set_EN_SBB0(&m_max77658_pm_t, 0b110);
+   if(max77658_pm_read_burst(&m_max77658_pm_t, MAX77658_PM_ADDR_INT_GLBL0, regs, sizeof(regs)) == 0)
+   {
+      m_pmic_button_edges(regs[0], now_ms);
+      m_pmic_fault_events(regs[0], regs[4], now_ms);
 
-   float SBB0_value = max77658_pm_get_TV_SBB0(&m_max77658_pm_t) * 0.025 + 0.5;
-   printf("SBB0 Output voltage: %f V\n", SBB0_value);
+      //The status block is part of the same burst, decode it on every read and publish changes only
+      if(max77658_chg_process(&m_max77658_chg_t, &regs[1]) == 1)
+      {
+         m_pmic_charger_report(&m_max77658_chg_t.status, now_ms);
+      }
+   }
+   event = button_gesture_poll(&m_button_gesture_t, now_ms);
+   m_pmic_button_report(event, now_ms);
+   if(event == BUTTON_GESTURE_TRIPLE)
+   {
+      m_pmic_dump_report(1, now_ms);
+      mutex_dump(TAG);
+      i2c_bus_dump_stats(TAG);
+   }
+   i2c_bus_set_class(cls);
 
-   uint8_t interrupt_REG0 = max77658_pm_get_INT_GLBL0(&m_max77658_pm_t);  //read global interrupt register to clear it
-   ESP_LOGI(TAG, "pmic_main_task() interrupt_REG0: %d", interrupt_REG0);
+   wait = button_gesture_timeout(&m_button_gesture_t, now_ms);
+   if(wait != BUTTON_GESTURE_NO_TIMEOUT)
+   {
+      pmic_supervisor_set_due(&m_pmic_supervisor_t, m_irq_job,
+                              now_ms + (wait < PMIC_BUTTON_POLL_MS ? wait : PMIC_BUTTON_POLL_MS));
+   }
+}
 
+/**
+  * @brief  Sample the fuel gauge and send a TELEMETRY_BATTERY record. The
+  *         cadence drops to PMIC_BATTERY_IDLE_MS while the battery is at rest
+  *         and SBB0 follows to its idle point, load restores both. The same
+  *         sample drives the power mode governor and is published to
+  *         m_pmic_state_t.
+  *
+  * @param  arg     unused.
+  * @param  now_ms  wake time.
+  *
+  */
+static void m_pmic_battery_job(void *arg, uint32_t now_ms)
+{
+   telemetry_record_t rec;
+   pmic_event_t event;
+   uint32_t period;
+   i2c_bus_class_t cls = i2c_bus_set_class(I2C_BUS_BULK);
 
-   uint8_t is_nEN_rising = 0x00;
-   uint8_t is_nEN_falling = 0x00;
-   uint8_t global_0_status = 0x00;
+   ESP_LOGD(TAG, "m_pmic_battery_job() Looping.");
 
+   max17055_u.battery.avg_vcell_FG = max77658_fg_get_avgVcell(&m_max77658_fg_t);
+   max17055_u.battery.avg_curr_FG  = max77658_fg_get_AvgCurrent(&m_max77658_fg_t);
+   max17055_u.battery.curr_FG      = max77658_fg_get_Current(&m_max77658_fg_t);
+   max17055_u.battery.rep_cap      = max77658_fg_get_battCAP(&m_max77658_fg_t);
+   max17055_u.battery.rep_SOC      = max77658_fg_get_SOC(&m_max77658_fg_t);
+   max77658_fg_energy_sample(&m_max77658_fg_t, &m_max77658_fg_energy_t, now_ms);
+   i2c_bus_set_class(cls);
 
+   m_pmic_snapshot.t_ms         = now_ms;
+   m_pmic_snapshot.avg_vcell_uv = (int32_t)max17055_u.battery.avg_vcell_FG;
+   m_pmic_snapshot.avg_curr_ua  = (int32_t)max17055_u.battery.avg_curr_FG;
+   m_pmic_snapshot.curr_ua      = (int32_t)max17055_u.battery.curr_FG;
+   m_pmic_snapshot.rep_cap_mah  = (int32_t)max17055_u.battery.rep_cap;
+   m_pmic_snapshot.soc_pct      = (int16_t)max17055_u.battery.rep_SOC;
+   m_pmic_snapshot.power_uw     = m_max77658_fg_energy_t.last_uw;
 
-   while(1)
-   {
-      global_0_status = max77658_pm_get_INT_GLBL0(&m_max77658_pm_t);
-      is_nEN_rising = max77658_pm_get_bit(global_0_status, 3);  //nEN Rising Interrupt
+   //Subscribers filter on their own SOC step, unchanged samples reach none of them
+   event = (pmic_event_t){ .type = PMIC_EVENT_SOC, .t_ms = now_ms, .data.soc_pct = m_pmic_snapshot.soc_pct };
+   pmic_event_publish(&m_pmic_event_bus_t, &event);
 
-      //In both push-button mode and slide-switch mode, the on/off controller looks for a falling edge on the nEN input to initiate a power-up sequence
-      is_nEN_falling = max77658_pm_get_bit(global_0_status, 2);  //nEN Falling Interrupt
+   //Binary record instead of formatted floats, decode with tools/telemetry_decode.py
+   telemetry_begin(&rec, TELEMETRY_BATTERY);
+   telemetry_put_u32(&rec, now_ms);
+   telemetry_put_u32(&rec, (int32_t)max17055_u.battery.avg_vcell_FG);                         //uV
+   telemetry_put_u32(&rec, (int32_t)max17055_u.battery.avg_curr_FG);                          //uA
+   telemetry_put_u32(&rec, (int32_t)max17055_u.battery.curr_FG);                              //uA
+   telemetry_put_u32(&rec, (int32_t)max17055_u.battery.rep_cap);                              //mAh
+   telemetry_put_u16(&rec, (int16_t)max17055_u.battery.rep_SOC);                              //%
+   telemetry_put_u32(&rec, m_max77658_fg_energy_t.last_uw);                                   //uW
+   telemetry_put_u32(&rec, (int32_t)max77658_fg_energy_discharge_uwh(&m_max77658_fg_energy_t)); //uWh
+   telemetry_put_u32(&rec, (int32_t)max77658_fg_energy_charge_uwh(&m_max77658_fg_energy_t));    //uWh
+   telemetry_send(&rec);
 
-      // ESP_LOGI(TAG, "pmic_main_task() global_0_status: %d, nEn Rising: %d, Falling: %d", global_0_status, is_nEN_rising, is_nEN_falling);
+   if(m_dvs_job >= 0)
+   {
+      m_pmic_power_mode((int32_t)max17055_u.battery.avg_curr_FG, now_ms);
+   }
 
-      if(is_nEN_falling)
-      {
-         ESP_LOGI(TAG, "pmic_main_task() nEN falling detected %d", is_nEN_falling);
-      }
+   period = (max17055_u.battery.avg_curr_FG < PMIC_IDLE_CURRENT_UA &&
+             max17055_u.battery.avg_curr_FG > -PMIC_IDLE_CURRENT_UA) ? PMIC_BATTERY_IDLE_MS : PMIC_BATTERY_PERIOD_MS;
+   if(period != m_pmic_supervisor_t.job[m_battery_job].period_ms)
+   {
+      pmic_supervisor_set_period(&m_pmic_supervisor_t, m_battery_job, period, now_ms);
 
-      switch(chkButton(is_nEN_falling))
+      if(m_dvs_job >= 0)
       {
-         case SingleClick:
+         if(max77658_dvs_select(&m_max77658_dvs_t, period == PMIC_BATTERY_IDLE_MS, now_ms) != 0)
          {
-            printf("Press detected\n");
-            break;
+            ESP_LOGE(TAG, "m_pmic_battery_job() SBB0 operating point switch failed");
          }
-         case DoubleClick:
+         else if(!m_max77658_dvs_t.idle)
          {
-            printf("Double presses detected\n");
-            break;
+            m_pmic_rail_report(MAX77658_RAIL_SBB0, PMIC_SBB0_RUN_MV, now_ms);
          }
-         //GERRY MOD
-         case YesSingle:
+         if(max77658_dvs_due(&m_max77658_dvs_t) != MAX77658_DVS_NO_WAKE)
          {
-            printf("Single press detected\n");
-            break;
+            pmic_supervisor_set_due(&m_pmic_supervisor_t, m_dvs_job, max77658_dvs_due(&m_max77658_dvs_t));
          }
       }
    }
+
+   m_pmic_snapshot.power_mode = m_max77658_lpm_t.mode;
+   pmic_state_publish(&m_pmic_state_t, &m_pmic_snapshot);
+}
+
+/**
+  * @brief  Report the fuel gauge alerts latched since the last run
+  *
+  * @param  arg     unused.
+  * @param  now_ms  wake time.
+  *
+  */
+static void m_pmic_alert_job(void *arg, uint32_t now_ms)
+{
+   telemetry_record_t rec;
+   i2c_bus_class_t cls = i2c_bus_set_class(I2C_BUS_BULK);
+   int32_t alerts = max77658_fg_get_alerts(&m_max77658_fg_t);
+
+   i2c_bus_set_class(cls);
+   if(alerts <= 0)
+   {
+      return;
+   }
+
+   ESP_LOGW(TAG, "m_pmic_alert_job() fuel gauge alerts 0x%04X", (unsigned)alerts);
+
+   telemetry_begin(&rec, TELEMETRY_ALERT);
+   telemetry_put_u32(&rec, now_ms);
+   telemetry_put_u16(&rec, alerts);
+   telemetry_send(&rec);
 }
 
-// -----------------------------------------------------------------------------
-static int chkButton (uint8_t input)
+/**
+  * @brief  Watchdog deadline: no wake cleared it in time, clear it now. The
+  *         wake hook runs afterwards and reschedules this job.
+  *
+  * @param  arg     unused.
+  * @param  now_ms  wake time.
+  *
+  */
+static void m_pmic_wdt_job(void *arg, uint32_t now_ms)
 {
-   const  unsigned long ButTimeout  = 300;
-   static unsigned long msecLst;
-   unsigned long msec = get_current_time();
-   //GERRY MOD
-   const int debDuration = 30;
-   static unsigned long  debStartTime = 0;
+   i2c_bus_class_t cls = i2c_bus_set_class(I2C_BUS_URGENT);
 
-   if (msecLst && (msec - msecLst) > ButTimeout)
+   if(pmic_wdt_service(&m_pmic_wdt_t, now_ms) < 0)
    {
-      msecLst = 0;
-      //GERRY MOD
-      //return SingleClick;	
-      return YesSingle;
+      ESP_LOGE(TAG, "m_pmic_wdt_job() WDT_CLR failed");
    }
+   i2c_bus_set_class(cls);
+}
+
+/**
+  * @brief  Runs after the jobs of every supervisor wake: the watchdog is
+  *         cleared if its window is open. The wdt job is moved to the new
+  *         deadline, or retried shortly while a clear is withheld or failed.
+  *
+  * @param  arg     unused.
+  * @param  now_ms  wake time.
+  *
+  */
+static void m_pmic_wake_hook(void *arg, uint32_t now_ms)
+{
+   uint32_t deadline;
+   i2c_bus_class_t cls = i2c_bus_set_class(I2C_BUS_URGENT);
+
+   pmic_wdt_piggyback(&m_pmic_wdt_t, now_ms);
+   i2c_bus_set_class(cls);
 
-   uint8_t but = input;
-   if (butLst != but)
+   deadline = pmic_wdt_deadline(&m_pmic_wdt_t);
+   if((int32_t)(deadline - now_ms) <= 0)
    {
-      //GERRY MOD
-      if (get_current_time() - debStartTime < debDuration) {
-      return None;
+      deadline = now_ms + PMIC_WDT_RETRY_MS;
+   }
+   pmic_supervisor_set_due(&m_pmic_supervisor_t, m_wdt_job, deadline);
+}
+
+/**
+  * @brief  Send a watchdog client state change as a TELEMETRY_HEALTH record
+  *
+  * @param  arg     unused.
+  * @param  id      client id.
+  * @param  missed  1: check-in missed, watchdog clears withheld, 0: back on time.
+  * @param  now_ms  time of the check.
+  *
+  */
+static void m_pmic_wdt_health(void *arg, int32_t id, uint8_t missed, uint32_t now_ms)
+{
+   telemetry_record_t rec;
+
+   telemetry_begin(&rec, TELEMETRY_HEALTH);
+   telemetry_put_u32(&rec, now_ms);
+   telemetry_put_u8(&rec, id);
+   telemetry_put_u8(&rec, missed);
+   telemetry_send(&rec);
+}
+
+/**
+  * @brief  Send the supervisor wake counters as a TELEMETRY_STATS record
+  *
+  * @param  arg     unused.
+  * @param  now_ms  wake time.
+  *
+  */
+static void m_pmic_stats_job(void *arg, uint32_t now_ms)
+{
+   telemetry_record_t rec;
+
+   telemetry_begin(&rec, TELEMETRY_STATS);
+   telemetry_put_u32(&rec, now_ms);
+   telemetry_put_u32(&rec, m_pmic_supervisor_t.wakes);
+   telemetry_put_u32(&rec, m_pmic_supervisor_t.kicked_wakes);
+   telemetry_send(&rec);
+}
+
+/**
+  * @brief  Send a recognized gesture as a TELEMETRY_BUTTON record
+  *
+  * @param  event  gesture, BUTTON_GESTURE_NONE is ignored.
+  * @param  t_ms   time the gesture completed.
+  *
+  */
+static void m_pmic_button_report(button_gesture_event_t event, uint32_t t_ms)
+{
+   telemetry_record_t rec;
+
+   if(event == BUTTON_GESTURE_NONE)
+   {
+      return;
+   }
+
+   ESP_LOGD(TAG, "pmic_task() button gesture %d", event);
+
+   telemetry_begin(&rec, TELEMETRY_BUTTON);
+   telemetry_put_u32(&rec, t_ms);
+   telemetry_put_u8(&rec, event);
+   telemetry_send(&rec);
+
+   pmic_event_publish(&m_pmic_event_bus_t, &(pmic_event_t){ .type = PMIC_EVENT_BUTTON, .t_ms = t_ms, .data.gesture = event });
+}
+
+/**
+  * @brief  Feed the nEN edges latched in INT_GLBL0 to the gesture recognizer.
+  *         nEN is active low: falling is a press, rising a release. When both
+  *         latched since the last poll, the debounced level (STAT_EN) tells
+  *         which came last.
+  *
+  * @param  int_glbl0  INT_GLBL0 value.
+  * @param  t_ms       time the register was read.
+  *
+  */
+static void m_pmic_button_edges(uint8_t int_glbl0, uint32_t t_ms)
+{
+   uint8_t falling = MAX77658_PM_FIELD_GET(INT_GLBL0, nEN_F, int_glbl0);
+   uint8_t rising = MAX77658_PM_FIELD_GET(INT_GLBL0, nEN_R, int_glbl0);
+
+   if(falling && rising)
+   {
+      if(max77658_pm_get_STAT_EN(&m_max77658_pm_t) == 1)
+      {
+         m_pmic_button_report(button_gesture_edge(&m_button_gesture_t, 0, t_ms), t_ms);
+         m_pmic_button_report(button_gesture_edge(&m_button_gesture_t, 1, t_ms), t_ms);
+      }
+      else
+      {
+         m_pmic_button_report(button_gesture_edge(&m_button_gesture_t, 1, t_ms), t_ms);
+         m_pmic_button_report(button_gesture_edge(&m_button_gesture_t, 0, t_ms), t_ms);
       }
-      debStartTime = get_current_time();
+   }
+   else if(falling || rising)
+   {
+      m_pmic_button_report(button_gesture_edge(&m_button_gesture_t, falling, t_ms), t_ms);
+   }
+}
 
-      butLst = but;
+/**
+  * @brief  Step the charge current controller on the charger status of the
+  *         irq job and the fuel gauge readings, write CHG_CC / ICHGIN_LIM
+  *         on a change and send it as a TELEMETRY_CHARGE record. The fuel
+  *         gauge temperature is only read while charging, AvgCurrent comes
+  *         from the last battery job.
+  *
+  * @param  arg     unused.
+  * @param  now_ms  wake time.
+  *
+  */
+static void m_pmic_charge_job(void *arg, uint32_t now_ms)
+{
+   max77658_chg_ctrl_in_t in;
+   telemetry_record_t rec;
+   uint8_t reason;
 
-      if (0x01 == but)
-      {   // press
-         if (msecLst)
-         { // 2nd press
-            msecLst = 0;
-            return DoubleClick;
-         }
-         else
-         {
-            msecLst = 0 == msec ? 1 : msec;
-            //GERRY MOD
-            return SingleClick; //SINGLE?
-         }
+   if(!m_max77658_chg_t.valid || m_max77658_chg_t.status.state == MAX77658_CHG_NO_INPUT)
+   {
+      return;
+   }
+
+   in.status = m_max77658_chg_t.status;
+   in.avg_curr_ua = (int32_t)max17055_u.battery.avg_curr_FG;
+   in.temp_c = 0;
+   if(in.status.state == MAX77658_CHG_FAST_CC || in.status.state == MAX77658_CHG_FAST_CV ||
+      in.status.state == MAX77658_CHG_TOP_OFF)
+   {
+      in.temp_c = max77658_fg_get_temperature(&m_max77658_fg_t);
+   }
+
+   reason = max77658_chg_ctrl_step(&m_max77658_chg_ctrl_t, &in);
+   if(max77658_chg_ctrl_apply(&m_max77658_chg_ctrl_t, &m_max77658_pm_t) != 0)
+   {
+      ESP_LOGE(TAG, "m_pmic_charge_job() CHG_CC / ICHGIN_LIM write failed");
+      return;
+   }
+   if(reason == MAX77658_CHG_CTRL_HOLD)
+   {
+      return;
+   }
+
+   telemetry_begin(&rec, TELEMETRY_CHARGE);
+   telemetry_put_u32(&rec, now_ms);
+   telemetry_put_u8(&rec, reason);
+   telemetry_put_u8(&rec, m_max77658_chg_ctrl_t.cc);
+   telemetry_put_u8(&rec, m_max77658_chg_ctrl_t.ilim);
+   telemetry_put_u8(&rec, (int8_t)in.temp_c);
+   telemetry_send(&rec);
+}
+
+/**
+  * @brief  Send a charger transition as a TELEMETRY_CHARGER record
+  *
+  * @param  status  new charger status.(ptr)
+  * @param  t_ms    time of the read.
+  *
+  */
+static void m_pmic_charger_report(const max77658_chg_status_t *status, uint32_t t_ms)
+{
+   telemetry_record_t rec;
+
+   ESP_LOGD(TAG, "pmic_task() charger state %d jeita %d zone %d chgin %d flags 0x%02X",
+            status->state, status->jeita, status->zone, status->chgin, status->flags);
+
+   telemetry_begin(&rec, TELEMETRY_CHARGER);
+   telemetry_put_u32(&rec, t_ms);
+   telemetry_put_u8(&rec, status->state);
+   telemetry_put_u8(&rec, status->jeita);
+   telemetry_put_u8(&rec, status->zone);
+   telemetry_put_u8(&rec, status->chgin);
+   telemetry_put_u8(&rec, status->flags);
+   telemetry_send(&rec);
+
+   m_pmic_snapshot.chg = *status;
+   m_pmic_snapshot.chg_valid = 1;
+   pmic_state_publish(&m_pmic_state_t, &m_pmic_snapshot);
+
+   pmic_event_publish(&m_pmic_event_bus_t, &(pmic_event_t){ .type = PMIC_EVENT_CHARGER, .t_ms = t_ms, .data.chg = *status });
+}
+
+/**
+  * @brief  Publish the die temperature alarms and rail faults latched in
+  *         INT_GLBL0 / INT_GLBL1
+  *
+  * @param  int_glbl0  INT_GLBL0 value.
+  * @param  int_glbl1  INT_GLBL1 value.
+  * @param  t_ms       time the registers were read.
+  *
+  */
+static void m_pmic_fault_events(uint8_t int_glbl0, uint8_t int_glbl1, uint32_t t_ms)
+{
+   uint8_t thermal = int_glbl0 & (MAX77658_INT_GLBL0_TJAL1_R_MASK | MAX77658_INT_GLBL0_TJAL2_R_MASK);
+   uint8_t fault = int_glbl1 & (MAX77658_INT_GLBL1_LDO0_F_MASK | MAX77658_INT_GLBL1_LDO1_F_MASK |
+                                MAX77658_INT_GLBL1_SBB_TO_MASK);
+
+   if(thermal)
+   {
+      ESP_LOGW(TAG, "m_pmic_fault_events() thermal alarm 0x%02X", thermal);
+      pmic_event_publish(&m_pmic_event_bus_t, &(pmic_event_t){ .type = PMIC_EVENT_THERMAL, .t_ms = t_ms, .data.int_glbl0 = thermal });
+   }
+   if(fault)
+   {
+      ESP_LOGE(TAG, "m_pmic_fault_events() rail fault 0x%02X", fault);
+      pmic_event_publish(&m_pmic_event_bus_t, &(pmic_event_t){ .type = PMIC_EVENT_RAIL_FAULT, .t_ms = t_ms, .data.int_glbl1 = fault });
+   }
+}
+
+/**
+  * @brief  Write the next SBB0 ramp step and schedule the one after it,
+  *         report the rail once the ramp ends
+  *
+  * @param  arg     unused.
+  * @param  now_ms  wake time.
+  *
+  */
+static void m_pmic_dvs_job(void *arg, uint32_t now_ms)
+{
+   int32_t ret = max77658_dvs_step(&m_max77658_dvs_t, now_ms);
+
+   if(ret < 0)
+   {
+      ESP_LOGE(TAG, "m_pmic_dvs_job() TV_SBB0 write failed");
+   }
+   else if(ret == 2)
+   {
+      m_pmic_rail_report(MAX77658_RAIL_SBB0, max77658_rail_code_to_mv(MAX77658_RAIL_SBB0, m_max77658_dvs_t.code), now_ms);
+   }
+
+   if(max77658_dvs_due(&m_max77658_dvs_t) != MAX77658_DVS_NO_WAKE)
+   {
+      pmic_supervisor_set_due(&m_pmic_supervisor_t, m_dvs_job, max77658_dvs_due(&m_max77658_dvs_t));
+   }
+}
+
+/**
+  * @brief  Step the power mode governor on a fuel gauge sample, write the
+  *         new mode and send a TELEMETRY_POWER_MODE record on a switch. A
+  *         failed write is tried again on the next sample.
+  *
+  * @param  avg_curr_ua  fuel gauge AvgCurrent.
+  * @param  t_ms         sample time.
+  *
+  */
+static void m_pmic_power_mode(int32_t avg_curr_ua, uint32_t t_ms)
+{
+   telemetry_record_t rec;
+
+   if(!max77658_lpm_step(&m_max77658_lpm_t, avg_curr_ua) && !m_max77658_lpm_t.dirty)
+   {
+      return;
+   }
+
+   if(max77658_lpm_apply(&m_max77658_lpm_t, &m_max77658_pm_t) != 0)
+   {
+      ESP_LOGE(TAG, "m_pmic_power_mode() mode %d not written", m_max77658_lpm_t.mode);
+      return;
+   }
+
+   ESP_LOGI(TAG, "m_pmic_power_mode() mode %d at %d uA, %u switches",
+            m_max77658_lpm_t.mode, (int)avg_curr_ua, (unsigned)m_max77658_lpm_t.switches);
+
+   telemetry_begin(&rec, TELEMETRY_POWER_MODE);
+   telemetry_put_u32(&rec, t_ms);
+   telemetry_put_u8(&rec, m_max77658_lpm_t.mode);
+   telemetry_put_u32(&rec, avg_curr_ua);
+   telemetry_put_u32(&rec, m_max77658_lpm_t.switches);
+   telemetry_send(&rec);
+}
+
+/**
+  * @brief  Capture a register image and send it as TELEMETRY_DUMP records,
+  *         reassemble them with tools/regdump.py. The clear-on-read
+  *         registers are left out so no interrupt is lost.
+  *
+  * @param  with_pm  1: PM and FG maps, 0: FG map only.
+  * @param  t_ms     capture time.
+  *
+  */
+static void m_pmic_dump_report(uint8_t with_pm, uint32_t t_ms)
+{
+   telemetry_record_t rec;
+   int64_t start_us = esp_timer_get_time();
+   i2c_bus_class_t cls = i2c_bus_set_class(I2C_BUS_BULK);
+
+   if(max77658_dump_capture(with_pm ? &m_max77658_pm_t : NULL, &m_max77658_fg_t, 0, t_ms, m_pmic_dump) != 0)
+   {
+      ESP_LOGE(TAG, "m_pmic_dump_report() incomplete image, flags 0x%02X", m_pmic_dump[5]);
+   }
+   i2c_bus_set_class(cls);
+   ESP_LOGI(TAG, "m_pmic_dump_report() %d bytes in %d us", MAX77658_DUMP_SIZE, (int)(esp_timer_get_time() - start_us));
+
+   for(uint16_t offset = 0; offset < MAX77658_DUMP_SIZE; offset += PMIC_DUMP_CHUNK)
+   {
+      telemetry_begin(&rec, TELEMETRY_DUMP);
+      telemetry_put_u16(&rec, offset);
+      telemetry_put_u16(&rec, MAX77658_DUMP_SIZE);
+      for(uint16_t i = offset; i < offset + PMIC_DUMP_CHUNK && i < MAX77658_DUMP_SIZE; i++)
+      {
+         telemetry_put_u8(&rec, m_pmic_dump[i]);
       }
+      telemetry_send(&rec);
    }
+}
 
-  return None;
+/**
+  * @brief  Send a rail voltage as a TELEMETRY_RAIL record
+  *
+  * @param  rail  regulator output.
+  * @param  mv    output voltage in mV.
+  * @param  t_ms  time of the change.
+  *
+  */
+static void m_pmic_rail_report(max77658_rail_t rail, uint16_t mv, uint32_t t_ms)
+{
+   telemetry_record_t rec;
+
+   telemetry_begin(&rec, TELEMETRY_RAIL);
+   telemetry_put_u32(&rec, t_ms);
+   telemetry_put_u8(&rec, rail);
+   telemetry_put_u16(&rec, mv);
+   telemetry_send(&rec);
+
+   if(rail == MAX77658_RAIL_SBB0)
+   {
+      m_pmic_snapshot.sbb0_mv = mv;
+      pmic_state_publish(&m_pmic_state_t, &m_pmic_snapshot);
+   }
 }
 
+/**
+  * @brief  Continue the rail bring-up and schedule its next step, end the
+  *         rails boot stage once every rail is up
+  *
+  * @param  arg     unused.
+  * @param  now_ms  wake time.
+  *
+  */
+static void m_pmic_seq_job(void *arg, uint32_t now_ms)
+{
+   i2c_bus_class_t cls = i2c_bus_set_class(I2C_BUS_URGENT);
+
+   m_pmic_seq_report(max77658_seq_step(&m_max77658_seq_t, now_ms), now_ms);
+   i2c_bus_set_class(cls);
 
+   if(max77658_seq_due(&m_max77658_seq_t, now_ms) != MAX77658_SEQ_NO_WAKE)
+   {
+      pmic_supervisor_set_due(&m_pmic_supervisor_t, m_seq_job, max77658_seq_due(&m_max77658_seq_t, now_ms));
+      return;
+   }
+   m_pmic_boot_done(BOOT_RAILS, 0, now_ms);
+}
+
+/**
+  * @brief  Send a TELEMETRY_RAIL_UP record per rail that came up
+  *
+  * @param  up    max77658_seq_step() result.
+  * @param  t_ms  time of the step.
+  *
+  */
+static void m_pmic_seq_report(int32_t up, uint32_t t_ms)
+{
+   const max77658_seq_node_t *node;
+   telemetry_record_t rec;
+
+   if(up < 0)
+   {
+      ESP_LOGE(TAG, "m_pmic_seq_report() EN write failed");
+      return;
+   }
+
+   for(uint8_t rail = 0; rail < MAX77658_RAIL_COUNT; rail++)
+   {
+      node = max77658_seq_node(&m_max77658_seq_t, rail);
+      if(!(up & MAX77658_SEQ_RAIL(rail)) || node == NULL)
+      {
+         continue;
+      }
+
+      telemetry_begin(&rec, TELEMETRY_RAIL_UP);
+      telemetry_put_u32(&rec, t_ms);
+      telemetry_put_u8(&rec, rail);
+      telemetry_put_u8(&rec, node->slot);
+      telemetry_put_u16(&rec, node->en_ms - m_max77658_seq_t.start_ms);
+      telemetry_put_u16(&rec, node->up_ms - node->en_ms);
+      telemetry_send(&rec);
+   }
+}
@@ -8,6 +8,19 @@
 #ifndef MAIN_TASK_PMIC_TASK_H_
 #define MAIN_TASK_PMIC_TASK_H_
 
+#include "pmic_wdt.h"
+#include "pmic_state.h"
+#include "pmic_event.h"
+
+//PMIC watchdog, other tasks register with pmic_wdt_register() and check in
+extern pmic_wdt_t m_pmic_wdt_t;
+
+//Battery and charger state, other tasks copy it with pmic_state_read()
+extern pmic_state_t m_pmic_state_t;
+
+//PMIC state changes, other tasks subscribe with pmic_event_subscribe()
+extern pmic_event_bus_t m_pmic_event_bus_t;
+
 void pmic_main_task();
 void pmic_task();
 
@@ -0,0 +1,266 @@
+/*
+ * pmic_wdt.c
+ *
+ *  MAX77658 hardware watchdog manager.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "pmic_wdt.h"
+#include <stddef.h>
+#include <esp_log.h>
+
+/* Private defines ---------------------------------------------------- */
+#define PMIC_WDT_BASE_MS   16000  //tWD of WDT_PER = 0b00, doubled per step
+
+/* Private enumerate/structure ---------------------------------------- */
+/* Private macros ----------------------------------------------------- */
+#define SUCCESS   0
+#define ERROR     -1
+
+/* Opportunistic clears start at half of tWD, the forced clear is at 3/4 */
+#define M_WINDOW_MS(wdt)     ((wdt)->period_ms / 2)
+#define M_DEADLINE_MS(wdt)   ((wdt)->period_ms / 4 * 3)
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+static const char* TAG = "pmic WDT";
+
+/* Private function prototypes ---------------------------------------- */
+static uint8_t m_pmic_wdt_healthy(pmic_wdt_t *wdt, uint32_t now_ms);
+static int32_t m_pmic_wdt_clear(pmic_wdt_t *wdt, uint32_t now_ms);
+
+/* Function definitions ----------------------------------------------- */
+
+/**
+  * @brief  Program the watchdog with one write of CNFG_WDT: period, expiry
+  *         action, enable and a first clear.
+  *
+  * @param  wdt       manager.(ptr)
+  * @param  pm        PM interface.(ptr)
+  * @param  wdt_per   tWD: 0b00 16s, 0b01 32s, 0b10 64s, 0b11 128s.
+  * @param  wdt_mode  0: power-off, 1: power-reset on expiry.
+  * @param  now_ms    current time.
+  * @retval           interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t pmic_wdt_init(pmic_wdt_t *wdt, max77658_pm_t *pm, uint8_t wdt_per, uint8_t wdt_mode, uint32_t now_ms)
+{
+   int32_t ret;
+
+   *wdt = (pmic_wdt_t){0};
+   wdt->pm = pm;
+   wdt->period_ms = PMIC_WDT_BASE_MS << (wdt_per & 0b11);
+
+   max77658_pm_txn_begin(pm);
+   max77658_pm_set_WDT_PER(pm, wdt_per);
+   max77658_pm_set_WDT_MODE(pm, wdt_mode);
+   max77658_pm_set_WDT_EN(pm, 1);
+   max77658_pm_set_WDT_CLR(pm, 1);
+   ret = max77658_pm_txn_commit(pm);
+   if(ret != SUCCESS)
+   {
+      ret = max77658_pm_txn_retry(pm);
+   }
+   if(ret != SUCCESS)
+   {
+      ESP_LOGE(TAG, "pmic_wdt_init() CNFG_WDT write failed");
+      return ret;
+   }
+
+   wdt->enabled = 1;
+   wdt->last_clear_ms = now_ms;
+
+   return SUCCESS;
+}
+
+/**
+  * @brief  Set the callback of the health events
+  *
+  * @param  wdt     manager.(ptr)
+  * @param  health  callback, NULL for none.
+  * @param  arg     argument of health.(ptr)
+  *
+  */
+void pmic_wdt_set_health(pmic_wdt_t *wdt, pmic_wdt_health_ptr health, void *arg)
+{
+   wdt->health = health;
+   wdt->health_arg = arg;
+}
+
+/**
+  * @brief  Register a client
+  *
+  * @param  wdt         manager.(ptr)
+  * @param  name        client name for the logs.(ptr)
+  * @param  timeout_ms  longest time between two check-ins.
+  * @param  now_ms      current time, counts as the first check-in.
+  * @retval             -1: Table full, otherwise client id
+  *
+  */
+int32_t pmic_wdt_register(pmic_wdt_t *wdt, const char *name, uint32_t timeout_ms, uint32_t now_ms)
+{
+   if(wdt->count >= PMIC_WDT_MAX_CLIENTS)
+   {
+      ESP_LOGE(TAG, "pmic_wdt_register() no room for %s", name);
+      return ERROR;
+   }
+
+   wdt->client[wdt->count] = (pmic_wdt_client_t){ .name = name, .timeout_ms = timeout_ms, .last_ms = now_ms };
+
+   return wdt->count++;
+}
+
+/**
+  * @brief  Client check-in. A single aligned 32-bit store, safe from any task.
+  *
+  * @param  wdt     manager.(ptr)
+  * @param  id      client id.
+  * @param  now_ms  current time.
+  *
+  */
+void pmic_wdt_checkin(pmic_wdt_t *wdt, int32_t id, uint32_t now_ms)
+{
+   if(id >= 0 && id < wdt->count)
+   {
+      wdt->client[id].last_ms = now_ms;
+   }
+}
+
+/**
+  * @brief  Clear the watchdog on a wake that happened for other work, once
+  *         half of tWD has passed since the last clear. Earlier wakes are
+  *         left alone so a busy system does not write CNFG_WDT on every wake,
+  *         but the client check-ins are still checked, without bus traffic.
+  *
+  * @param  wdt     manager.(ptr)
+  * @param  now_ms  current time.
+  * @retval         1: Cleared, 0: Window not open or clear withheld, -1: I2C error
+  *
+  */
+int32_t pmic_wdt_piggyback(pmic_wdt_t *wdt, uint32_t now_ms)
+{
+   int32_t ret;
+
+   if(!wdt->enabled)
+   {
+      return 0;
+   }
+
+   if(now_ms - wdt->last_clear_ms < M_WINDOW_MS(wdt))
+   {
+      m_pmic_wdt_healthy(wdt, now_ms);
+      return 0;
+   }
+
+   ret = m_pmic_wdt_clear(wdt, now_ms);
+   if(ret == 1)
+   {
+      wdt->piggybacked++;
+   }
+
+   return ret;
+}
+
+/**
+  * @brief  Clear the watchdog now, for the wake scheduled at pmic_wdt_deadline()
+  *
+  * @param  wdt     manager.(ptr)
+  * @param  now_ms  current time.
+  * @retval         1: Cleared, 0: Clear withheld, -1: I2C error
+  *
+  */
+int32_t pmic_wdt_service(pmic_wdt_t *wdt, uint32_t now_ms)
+{
+   int32_t ret;
+
+   if(!wdt->enabled)
+   {
+      return 0;
+   }
+
+   ret = m_pmic_wdt_clear(wdt, now_ms);
+   if(ret == 1)
+   {
+      wdt->forced++;
+   }
+
+   return ret;
+}
+
+/**
+  * @brief  Latest time of the next clear, 3/4 of tWD after the last one.
+  *         The margin covers a missed wake and an I2C retry.
+  *
+  * @param  wdt  manager.(ptr)
+  * @retval      deadline in ms
+  *
+  */
+uint32_t pmic_wdt_deadline(const pmic_wdt_t *wdt)
+{
+   return wdt->last_clear_ms + M_DEADLINE_MS(wdt);
+}
+
+/* Private function definitions ---------------------------------------- */
+/**
+  * @brief  Check every client and report changes of its state
+  *
+  * @param  wdt     manager.(ptr)
+  * @param  now_ms  current time.
+  * @retval         1: All clients checked in on time, 0: At least one missed
+  *
+  */
+static uint8_t m_pmic_wdt_healthy(pmic_wdt_t *wdt, uint32_t now_ms)
+{
+   pmic_wdt_client_t *client;
+   uint8_t healthy = 1;
+   uint8_t missed;
+
+   for(uint8_t i = 0; i < wdt->count; i++)
+   {
+      client = &wdt->client[i];
+      missed = now_ms - client->last_ms > client->timeout_ms;
+
+      if(missed != client->missed)
+      {
+         client->missed = missed;
+         if(missed)
+         {
+            ESP_LOGE(TAG, "client %s missed its check-in", client->name);
+         }
+         if(wdt->health != NULL)
+         {
+            wdt->health(wdt->health_arg, i, missed, now_ms);
+         }
+      }
+
+      healthy &= !missed;
+   }
+
+   return healthy;
+}
+
+/**
+  * @brief  Write WDT_CLR unless a client missed its check-in
+  *
+  * @param  wdt     manager.(ptr)
+  * @param  now_ms  current time.
+  * @retval         1: Cleared, 0: Clear withheld, -1: I2C error
+  *
+  */
+static int32_t m_pmic_wdt_clear(pmic_wdt_t *wdt, uint32_t now_ms)
+{
+   if(!m_pmic_wdt_healthy(wdt, now_ms))
+   {
+      wdt->withheld++;
+      return 0;
+   }
+
+   if(max77658_pm_set_WDT_CLR(wdt->pm, 1) != SUCCESS && max77658_pm_retry(wdt->pm) != SUCCESS)
+   {
+      return ERROR;
+   }
+
+   wdt->last_clear_ms = now_ms;
+
+   return 1;
+}
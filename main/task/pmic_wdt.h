@@ -0,0 +1,94 @@
+/*
+ * pmic_wdt.h
+ *
+ *  MAX77658 hardware watchdog manager. WDT_CLR is written opportunistically
+ *  on wakes that happen anyway and only forced close to the expiry. Clears
+ *  stop while a registered client misses its check-in, so a hung task ends
+ *  in a PMIC power-off / reset. Tasks register on m_pmic_wdt_t (pmic_task.c)
+ *  and call pmic_wdt_checkin() from their loop.
+ */
+
+#ifndef MAIN_TASK_PMIC_WDT_H_
+#define MAIN_TASK_PMIC_WDT_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include "max77658_pm.h"
+
+/* Public defines ----------------------------------------------------- */
+#define PMIC_WDT_MAX_CLIENTS  8
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief  Health event: client id missed (missed = 1) or resumed (missed = 0) its check-ins
+ */
+typedef void (*pmic_wdt_health_ptr)(void *arg, int32_t id, uint8_t missed, uint32_t now_ms);
+
+/**
+ * @brief  Task that has to check in every timeout_ms
+ */
+typedef struct
+{
+   const char *name;
+   uint32_t timeout_ms;
+   volatile uint32_t last_ms;  //Written by the client task
+   uint8_t  missed;
+} pmic_wdt_client_t;
+
+/**
+ * @brief  Watchdog manager state
+ */
+typedef struct
+{
+   max77658_pm_t *pm;
+   uint32_t period_ms;         //tWD
+   uint32_t last_clear_ms;
+   uint8_t  enabled;
+   uint8_t  count;
+   pmic_wdt_client_t client[PMIC_WDT_MAX_CLIENTS];
+   pmic_wdt_health_ptr health;
+   void *health_arg;
+   uint32_t piggybacked;       //Clears done on a wake that happened anyway
+   uint32_t forced;            //Clears done at the deadline
+   uint32_t withheld;          //Clears skipped because a client missed its check-in
+} pmic_wdt_t;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+  * @brief  Program WDT_PER / WDT_MODE, enable and clear the watchdog
+ */
+int32_t pmic_wdt_init(pmic_wdt_t *wdt, max77658_pm_t *pm, uint8_t wdt_per, uint8_t wdt_mode, uint32_t now_ms);
+
+/**
+  * @brief  Callback of the health events
+ */
+void pmic_wdt_set_health(pmic_wdt_t *wdt, pmic_wdt_health_ptr health, void *arg);
+
+/**
+  * @brief  Register a client that must check in every timeout_ms. Returns the id or -1
+ */
+int32_t pmic_wdt_register(pmic_wdt_t *wdt, const char *name, uint32_t timeout_ms, uint32_t now_ms);
+
+/**
+  * @brief  Client check-in, may be called from any task
+ */
+void pmic_wdt_checkin(pmic_wdt_t *wdt, int32_t id, uint32_t now_ms);
+
+/**
+  * @brief  Clear if the opportunistic window is open, for wakes that happen anyway
+ */
+int32_t pmic_wdt_piggyback(pmic_wdt_t *wdt, uint32_t now_ms);
+
+/**
+  * @brief  Clear now if clients are healthy, for the deadline wake
+ */
+int32_t pmic_wdt_service(pmic_wdt_t *wdt, uint32_t now_ms);
+
+/**
+  * @brief  Latest time of the next clear, schedule the deadline wake here
+ */
+uint32_t pmic_wdt_deadline(const pmic_wdt_t *wdt);
+
+
+#endif /* MAIN_TASK_PMIC_WDT_H_ */
@@ -0,0 +1,23 @@
+/*
+ * esp_log.h
+ *
+ *  Host stand-in for the IDF logging macros, errors and warnings go to
+ *  stderr, the rest is dropped.
+ */
+
+#ifndef TEST_HOST_STUBS_ESP_LOG_H_
+#define TEST_HOST_STUBS_ESP_LOG_H_
+
+
+/* Includes ----------------------------------------------------------- */
+#include <stdio.h>
+
+/* Public defines ----------------------------------------------------- */
+#define ESP_LOGE(tag, fmt, ...)  fprintf(stderr, "E %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...)  fprintf(stderr, "W %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...)  do { (void)(tag); } while(0)
+#define ESP_LOGD(tag, fmt, ...)  do { (void)(tag); } while(0)
+#define ESP_LOGV(tag, fmt, ...)  do { (void)(tag); } while(0)
+
+
+#endif /* TEST_HOST_STUBS_ESP_LOG_H_ */
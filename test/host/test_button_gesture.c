@@ -0,0 +1,237 @@
+/*
+ * test_button_gesture.c
+ *
+ *  Replays edge traces through the button gesture recognizer on the host.
+ *  A trace lists the edges of one or more buttons and the gestures they
+ *  must produce:
+ *
+ *     E <button> <t_ms> <1 press / 0 release>
+ *     X <button> <t_ms> <button_gesture_event_t>
+ *
+ *  The replay behaves like the PMIC task: between edges it sleeps until the
+ *  earliest button_gesture_timeout() and polls that button, so every
+ *  gesture is reported at its deadline or at the edge that ends it.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include <stdio.h>
+#include <stdint.h>
+#include "button_gesture.h"
+
+/* Private defines ---------------------------------------------------- */
+#define TEST_BUTTONS     4
+#define TEST_MAX_LINES   64
+
+/* Private enumerate/structure ---------------------------------------- */
+typedef struct
+{
+   uint8_t  button;
+   uint32_t t_ms;
+   uint32_t value;         //Level of an edge, event of an expectation
+} test_line_t;
+
+typedef struct
+{
+   test_line_t edge[TEST_MAX_LINES];
+   uint32_t edges;
+   test_line_t expect[TEST_MAX_LINES];
+   uint32_t expects;
+} test_trace_t;
+
+/* Private variables -------------------------------------------------- */
+static const char *m_traces[] =
+{
+   "single.trace",
+   "double.trace",
+   "triple.trace",
+   "long.trace",
+   "boundary.trace",
+   "multi.trace",
+};
+
+/* Private function prototypes ---------------------------------------- */
+static int m_test_load(const char *path, test_trace_t *trace);
+static int m_test_replay(const char *name, const test_trace_t *trace);
+static uint8_t m_test_next_deadline(button_gesture_t *b, uint32_t now_ms, uint32_t *t_ms, uint8_t *button);
+
+/* Function definitions ----------------------------------------------- */
+int main(int argc, char **argv)
+{
+   const char *dir = argc > 1 ? argv[1] : "traces/button";
+   char path[256];
+   test_trace_t trace;
+   int failed = 0;
+
+   for(uint32_t i = 0; i < sizeof(m_traces) / sizeof(m_traces[0]); i++)
+   {
+      snprintf(path, sizeof(path), "%s/%s", dir, m_traces[i]);
+      if(m_test_load(path, &trace) != 0)
+      {
+         printf("FAIL %s: cannot read the trace\n", m_traces[i]);
+         failed++;
+         continue;
+      }
+      failed += m_test_replay(m_traces[i], &trace);
+   }
+
+   printf("%s: %d of %d traces failed\n", failed ? "FAIL" : "PASS", failed, (int)(sizeof(m_traces) / sizeof(m_traces[0])));
+
+   return failed ? 1 : 0;
+}
+
+/* Private function definitions ---------------------------------------- */
+/**
+  * @brief  Read a trace file, '#' starts a comment line
+  *
+  * @param  path   trace file.(ptr)
+  * @param  trace  parsed trace.(ptr)
+  * @retval        0: Success, -1: File missing or malformed
+  *
+  */
+static int m_test_load(const char *path, test_trace_t *trace)
+{
+   FILE *f = fopen(path, "r");
+   char line[128];
+   char kind;
+   unsigned button, t_ms, value;
+   test_line_t *entry;
+
+   if(f == NULL)
+   {
+      return -1;
+   }
+
+   *trace = (test_trace_t){0};
+   while(fgets(line, sizeof(line), f) != NULL)
+   {
+      if(line[0] == '#' || line[0] == '\n')
+      {
+         continue;
+      }
+      if(sscanf(line, " %c %u %u %u", &kind, &button, &t_ms, &value) != 4 || button >= TEST_BUTTONS ||
+         (kind == 'E' ? trace->edges : trace->expects) >= TEST_MAX_LINES || (kind != 'E' && kind != 'X'))
+      {
+         fclose(f);
+         return -1;
+      }
+      entry = kind == 'E' ? &trace->edge[trace->edges++] : &trace->expect[trace->expects++];
+      *entry = (test_line_t){ .button = button, .t_ms = t_ms, .value = value };
+   }
+
+   fclose(f);
+   return 0;
+}
+
+/**
+  * @brief  Feed the edges in order, poll every deadline that falls before
+  *         the next edge and after the last one, and compare the gestures
+  *         reported with the expected ones in order of time
+  *
+  * @param  name   trace name for the report.(ptr)
+  * @param  trace  trace.(ptr)
+  * @retval        0: Pass, 1: Fail
+  *
+  */
+static int m_test_replay(const char *name, const test_trace_t *trace)
+{
+   button_gesture_t b[TEST_BUTTONS];
+   test_line_t got[TEST_MAX_LINES];
+   uint32_t gots = 0;
+   uint32_t now_ms = 0;
+   uint32_t next = 0;
+   uint32_t t_ms;
+   uint8_t button;
+   button_gesture_event_t event;
+   int failed = 0;
+
+   for(uint8_t i = 0; i < TEST_BUTTONS; i++)
+   {
+      button_gesture_init(&b[i], NULL);
+   }
+
+   while(next < trace->edges || m_test_next_deadline(b, now_ms, &t_ms, &button))
+   {
+      if(m_test_next_deadline(b, now_ms, &t_ms, &button) &&
+         (next >= trace->edges || (int32_t)(t_ms - trace->edge[next].t_ms) <= 0))
+      {
+         now_ms = t_ms;
+         event = button_gesture_poll(&b[button], now_ms);
+      }
+      else
+      {
+         now_ms = trace->edge[next].t_ms;
+         button = trace->edge[next].button;
+         event = button_gesture_edge(&b[button], trace->edge[next].value, now_ms);
+         next++;
+      }
+
+      if(event != BUTTON_GESTURE_NONE && gots < TEST_MAX_LINES)
+      {
+         got[gots++] = (test_line_t){ .button = button, .t_ms = now_ms, .value = event };
+      }
+   }
+
+   for(uint32_t i = 0; i < gots || i < trace->expects; i++)
+   {
+      if(i >= gots || i >= trace->expects || got[i].button != trace->expect[i].button ||
+         got[i].t_ms != trace->expect[i].t_ms || got[i].value != trace->expect[i].value)
+      {
+         printf("FAIL %s: gesture %u expected ", name, (unsigned)i);
+         if(i < trace->expects)
+         {
+            printf("button %u event %u at %u", trace->expect[i].button, trace->expect[i].value, trace->expect[i].t_ms);
+         }
+         else
+         {
+            printf("none");
+         }
+         printf(", got ");
+         if(i < gots)
+         {
+            printf("button %u event %u at %u\n", got[i].button, got[i].value, got[i].t_ms);
+         }
+         else
+         {
+            printf("none\n");
+         }
+         failed = 1;
+      }
+   }
+
+   if(!failed)
+   {
+      printf("PASS %s: %u gestures\n", name, (unsigned)gots);
+   }
+
+   return failed;
+}
+
+/**
+  * @brief  Earliest pending deadline of all buttons
+  *
+  * @param  b       recognizers.(ptr)
+  * @param  now_ms  current time.
+  * @param  t_ms    time of the deadline.(ptr)
+  * @param  button  button it belongs to.(ptr)
+  * @retval         1: A deadline is pending, 0: All buttons idle
+  *
+  */
+static uint8_t m_test_next_deadline(button_gesture_t *b, uint32_t now_ms, uint32_t *t_ms, uint8_t *button)
+{
+   uint32_t wait;
+   uint32_t best = BUTTON_GESTURE_NO_TIMEOUT;
+
+   for(uint8_t i = 0; i < TEST_BUTTONS; i++)
+   {
+      wait = button_gesture_timeout(&b[i], now_ms);
+      if(wait < best)
+      {
+         best = wait;
+         *button = i;
+      }
+   }
+
+   *t_ms = now_ms + best;
+
+   return best != BUTTON_GESTURE_NO_TIMEOUT;
+}
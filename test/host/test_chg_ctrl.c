@@ -0,0 +1,243 @@
+/*
+ * test_chg_ctrl.c
+ *
+ *  Runs the charge current controller against the thermal model of the PM
+ *  simulator, the way the PMIC task does: every 5s the charger status is
+ *  read over the simulated bus, the controller steps on it and the battery
+ *  temperature / charge current of the model, and apply writes the result.
+ *
+ *  The start checks load a CHG_CC / ICHGIN_LIM "OTP" setting into the
+ *  simulator and look at what init takes from it. The thermal runs charge
+ *  the board battery (175mAh) to 80% at several ambients and compare the
+ *  time with the OTP setting left alone.
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include <stdio.h>
+#include <stdint.h>
+#include "max77658_pm.h"
+#include "max77658_pm_sim.h"
+#include "max77658_chg.h"
+#include "max77658_chg_ctrl.h"
+
+/* Private defines ---------------------------------------------------- */
+#define TEST_STEP_MS        5000                    //PMIC_CHG_CTRL_PERIOD_MS
+#define TEST_MODEL_MS       1000                    //Thermal model resolution
+#define TEST_BATT_CAP_MAH   175                     //PMIC_BATT_CAP_MAH
+#define TEST_CHARGE_UAS     ((uint64_t)TEST_BATT_CAP_MAH * 1000 * 3600 * 80 / 100)
+#define TEST_TIMEOUT_MS     (12UL * 3600 * 1000)
+#define TEST_OTP_CC         0x03                    //30mA
+#define TEST_OTP_ILIM       MAX77658_CHG_ILIM_CODE(1)   //190mA
+#define TEST_CC_MAX         MAX77658_CHG_CC_CODE(TEST_BATT_CAP_MAH * 500)   //0.5C
+#define TEST_BATT_LIMIT_MC  45000                   //JEITA warm zone
+
+#define TEST_CHECK(cond, ...)  do { if(!(cond)) { printf("FAIL " __VA_ARGS__); printf("\n"); return 1; } } while(0)
+
+/* Private enumerate/structure ---------------------------------------- */
+typedef struct
+{
+   uint32_t time_ms;           //Time to TEST_CHARGE_UAS, TEST_TIMEOUT_MS if not reached
+   int32_t  batt_max_mc;
+   uint8_t  cc_max;            //Highest CHG_CC code the registers held
+   uint32_t backoffs;
+} test_run_t;
+
+/* Private variables -------------------------------------------------- */
+static max77658_pm_t m_pm;
+
+static const max77658_chg_ctrl_cfg_t m_cfg =
+{
+   .cc_min       = 0x03,
+   .cc_max       = TEST_CC_MAX,
+   .ilim_max     = MAX77658_CHG_ILIM_MAX_LEVEL,
+   .jeita_pct    = 50,
+   .batt_max_c   = 44,
+   .batt_hyst_c  = 1,
+   .settle_steps = 6,
+   .batt_settle_steps = 60,
+   .probe_steps  = 120,
+   .track_pct    = 80,
+};
+
+/* Ambients of the thermal runs, m°C */
+static const int32_t m_ambient_mc[] = { 20000, 25000, 30000, 35000, 40000 };
+
+/* Private function prototypes ---------------------------------------- */
+static void m_test_otp(uint8_t cc, uint8_t ilim_code);
+static int m_test_start(void);
+static int m_test_thermal(void);
+static void m_test_run(int32_t ambient_mc, uint8_t with_ctrl, test_run_t *run);
+
+/* Function definitions ----------------------------------------------- */
+int main(void)
+{
+   int failed = 0;
+
+   failed += m_test_start();
+   failed += m_test_thermal();
+
+   printf("%s: charge controller\n", failed ? "FAIL" : "PASS");
+
+   return failed ? 1 : 0;
+}
+
+/* Private function definitions ---------------------------------------- */
+/**
+  * @brief  Reset the simulator with the charger enabled at an OTP setting
+  *         and a PM interface over it
+  *
+  * @param  cc         CHG_CC code.
+  * @param  ilim_code  ICHGIN_LIM register code.
+  *
+  */
+static void m_test_otp(uint8_t cc, uint8_t ilim_code)
+{
+   max77658_pm_sim_reset();
+   max77658_pm_sim_set(MAX77658_PM_ADDR_CNFG_CHG_B, MAX77658_PM_FIELD_PREP(CNFG_CHG_B, ICHGIN_LIM, ilim_code) |
+                                                    MAX77658_PM_FIELD_PREP(CNFG_CHG_B, CHG_EN, 1));
+   max77658_pm_sim_set(MAX77658_PM_ADDR_CNFG_CHG_E, MAX77658_PM_FIELD_PREP(CNFG_CHG_E, CHG_CC, cc));
+   max77658_pm_sim_set(MAX77658_PM_ADDR_CNFG_CHG_F, MAX77658_PM_FIELD_PREP(CNFG_CHG_F, CHG_CC_JEITA, cc / 2));
+
+   m_pm = (max77658_pm_t){0};
+   m_pm.device_address = 0x90;
+   m_pm.read_reg = max77658_pm_sim_read_reg;
+   m_pm.write_reg = max77658_pm_sim_write_reg;
+   max77658_pm_cache_enable(&m_pm, 1);
+}
+
+/**
+  * @brief  Init starts from the OTP setting, writes nothing unless it is
+  *         above the rating, and falls back to the floors on a bus error
+  *
+  * @retval  0: Pass, 1: Fail
+  *
+  */
+static int m_test_start(void)
+{
+   max77658_chg_ctrl_t ctrl;
+
+   //OTP below the rating: taken as is, nothing to write
+   m_test_otp(TEST_OTP_CC, TEST_OTP_ILIM);
+   TEST_CHECK(max77658_chg_ctrl_init(&ctrl, &m_cfg, &m_pm) == 0, "start: init failed");
+   TEST_CHECK(ctrl.cc == TEST_OTP_CC && ctrl.ilim == 1 && !ctrl.dirty,
+              "start: cc %u ilim %u dirty %u from the OTP setting", ctrl.cc, ctrl.ilim, ctrl.dirty);
+   TEST_CHECK(max77658_chg_ctrl_apply(&ctrl, &m_pm) == 0 && max77658_pm_sim_stats()->write_txn == 0,
+              "start: apply wrote an unchanged setting");
+
+   //OTP at the silicon maximum: lowered to the rating by the first apply
+   m_test_otp(MAX77658_CHG_CC_MAX_CODE, MAX77658_CHG_ILIM_CODE(MAX77658_CHG_ILIM_MAX_LEVEL));
+   max77658_chg_ctrl_init(&ctrl, &m_cfg, &m_pm);
+   TEST_CHECK(ctrl.cc == TEST_CC_MAX && ctrl.dirty, "start: cc %u above the rating %u", ctrl.cc, TEST_CC_MAX);
+   max77658_chg_ctrl_apply(&ctrl, &m_pm);
+   TEST_CHECK(MAX77658_PM_FIELD_GET(CNFG_CHG_E, CHG_CC, max77658_pm_sim_get(MAX77658_PM_ADDR_CNFG_CHG_E)) == TEST_CC_MAX,
+              "start: CHG_CC not lowered to the rating");
+
+   //No rating: the OTP setting is the ceiling
+   m_test_otp(TEST_OTP_CC, TEST_OTP_ILIM);
+   max77658_chg_ctrl_init(&ctrl, NULL, &m_pm);
+   TEST_CHECK(ctrl.cc == TEST_OTP_CC && ctrl.cfg.cc_max == TEST_OTP_CC, "start: default ceiling %u", ctrl.cfg.cc_max);
+
+   //Unknown setting: the floors
+   m_test_otp(TEST_OTP_CC, TEST_OTP_ILIM);
+   max77658_pm_sim_fail_next(1, -1);
+   TEST_CHECK(max77658_chg_ctrl_init(&ctrl, &m_cfg, &m_pm) != 0 && ctrl.cc == m_cfg.cc_min && ctrl.ilim == 0 &&
+              ctrl.dirty, "start: read failure, cc %u ilim %u", ctrl.cc, ctrl.ilim);
+
+   printf("PASS start\n");
+
+   return 0;
+}
+
+/**
+  * @brief  Controller against the OTP setting at each ambient: CHG_CC stays
+  *         at or below the rating, the battery out of the JEITA warm zone,
+  *         and the charge is never slower than the OTP setting left alone
+  *
+  * @retval  0: Pass, 1: Fail
+  *
+  */
+static int m_test_thermal(void)
+{
+   test_run_t fixed;
+   test_run_t ctrl;
+   int failed = 0;
+
+   for(uint32_t i = 0; i < sizeof(m_ambient_mc) / sizeof(m_ambient_mc[0]); i++)
+   {
+      m_test_run(m_ambient_mc[i], 0, &fixed);
+      m_test_run(m_ambient_mc[i], 1, &ctrl);
+
+      printf("%s %2ldC: fixed %3lu min, controller %3lu min, CHG_CC max 0x%02X, battery max %ld.%ldC, %lu back-offs\n",
+             ctrl.cc_max <= TEST_CC_MAX && ctrl.batt_max_mc < TEST_BATT_LIMIT_MC && ctrl.time_ms <= fixed.time_ms &&
+             ctrl.time_ms < TEST_TIMEOUT_MS ? "PASS" : "FAIL",
+             (long)(m_ambient_mc[i] / 1000), (unsigned long)(fixed.time_ms / 60000), (unsigned long)(ctrl.time_ms / 60000),
+             ctrl.cc_max, (long)(ctrl.batt_max_mc / 1000), (long)(ctrl.batt_max_mc % 1000 / 100),
+             (unsigned long)ctrl.backoffs);
+
+      if(ctrl.cc_max > TEST_CC_MAX || ctrl.batt_max_mc >= TEST_BATT_LIMIT_MC || ctrl.time_ms > fixed.time_ms ||
+         ctrl.time_ms >= TEST_TIMEOUT_MS)
+      {
+         failed = 1;
+      }
+   }
+
+   return failed;
+}
+
+/**
+  * @brief  Charge from the OTP setting until TEST_CHARGE_UAS is delivered
+  *
+  * @param  ambient_mc  enclosure temperature.
+  * @param  with_ctrl   1: controller every TEST_STEP_MS, 0: OTP setting left alone.
+  * @param  run         result.(ptr)
+  *
+  */
+static void m_test_run(int32_t ambient_mc, uint8_t with_ctrl, test_run_t *run)
+{
+   max77658_pm_sim_charger_t model =
+   {
+      .ambient_mc      = ambient_mc,
+      .vchgin_mv       = 5000,
+      .vbat_mv         = 3800,
+      .die_rth         = 250,          //Small package on a crowded board, ~25°C at 100mW
+      .die_tau_ms      = 20000,
+      .batt_couple_pct = 40,
+      .batt_tau_ms     = 600000,
+      .die_mc          = ambient_mc,
+      .batt_mc         = ambient_mc,
+   };
+   max77658_chg_t chg;
+   max77658_chg_ctrl_t ctrl;
+   max77658_chg_ctrl_in_t in;
+   uint8_t cc;
+
+   m_test_otp(TEST_OTP_CC, TEST_OTP_ILIM);
+   max77658_chg_init(&chg, &m_pm);
+   max77658_chg_ctrl_init(&ctrl, &m_cfg, &m_pm);
+   *run = (test_run_t){ .time_ms = TEST_TIMEOUT_MS, .batt_max_mc = ambient_mc };
+
+   for(uint32_t t_ms = 0; t_ms < TEST_TIMEOUT_MS; t_ms += TEST_MODEL_MS)
+   {
+      max77658_pm_sim_charger_step(&model, TEST_MODEL_MS);
+
+      cc = MAX77658_PM_FIELD_GET(CNFG_CHG_E, CHG_CC, max77658_pm_sim_get(MAX77658_PM_ADDR_CNFG_CHG_E));
+      run->cc_max = cc > run->cc_max ? cc : run->cc_max;
+      run->batt_max_mc = model.batt_mc > run->batt_max_mc ? model.batt_mc : run->batt_max_mc;
+      if(model.charged_uas >= TEST_CHARGE_UAS)
+      {
+         run->time_ms = t_ms + TEST_MODEL_MS;
+         break;
+      }
+
+      if(with_ctrl && (t_ms + TEST_MODEL_MS) % TEST_STEP_MS == 0 && max77658_chg_update(&chg) >= 0)
+      {
+         in.status = chg.status;
+         in.temp_c = (int16_t)(model.batt_mc / 1000);
+         in.avg_curr_ua = (int32_t)model.ichg_ua;
+         max77658_chg_ctrl_step(&ctrl, &in);
+         max77658_chg_ctrl_apply(&ctrl, &m_pm);
+      }
+   }
+
+   run->backoffs = ctrl.backoffs;
+}
@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+"""
+regdump.py
+
+Decode and diff MAX77658 register images, see max77658_dump.h.
+
+Images are pulled out of a telemetry capture (TELEMETRY_DUMP records) with
+"extract", one file per image named after its capture time. PM registers
+and fields are named from max77658_pm_regmap.def, FG registers from the
+register enum of max77658_fg_types.h, so the tool follows the firmware.
+
+    python3 tools/regdump.py extract capture.bin -o dumps/board7
+    python3 tools/regdump.py decode dumps/board7_12034.bin
+    python3 tools/regdump.py diff dumps/board7_12034.bin dumps/board7_98110.bin
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+from telemetry_decode import frames
+
+PMIC_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "main", "component", "pmic")
+
+# Image layout, keep in sync with max77658_dump.h
+MAGIC = b"MXRD"
+VERSION = 1
+FLAG_PM_OK, FLAG_FG_OK, FLAG_COR = 0x01, 0x02, 0x04
+PM_SPAN = 0x50
+BITMAP_OFFSET = 10
+PM_OFFSET = 20
+FG_OFFSET = PM_OFFSET + PM_SPAN
+FG_RANGES = [(0x00, 0x50), (0xB0, 0x10), (0xD0, 0x30)]
+SIZE = FG_OFFSET + 2 * sum(count for _, count in FG_RANGES)
+TELEMETRY_DUMP = 0x0B
+
+
+def load_pm_map():
+    """Return {address: (name, [(field, msb, lsb)])} from the .def file."""
+    regs, names = {}, {}
+    with open(os.path.join(PMIC_DIR, "max77658_pm_regmap.def")) as f:
+        for line in f:
+            m = re.search(r"\bREG\((\w+),\s*(0x[0-9A-Fa-f]+),", line)
+            if m:
+                addr = int(m.group(2), 16)
+                regs[addr] = (m.group(1), [])
+                names[m.group(1)] = addr
+                continue
+            m = re.search(r"\bFIELD\(arg,\s*(\w+),\s*(\w+),\s*(\d+),\s*(\d+),", line)
+            if m:
+                regs[names[m.group(1)]][1].append((m.group(2), int(m.group(3)), int(m.group(4))))
+    return regs
+
+
+def load_fg_map():
+    """Return {address: name} from the register enum, aliases joined by '/'."""
+    regs = {}
+    with open(os.path.join(PMIC_DIR, "max77658_fg_types.h")) as f:
+        for m in re.finditer(r"\b(\w+)_REG\s*=\s*(0[xX][0-9A-Fa-f]+)", f.read()):
+            addr = int(m.group(2), 16)
+            regs[addr] = regs[addr] + "/" + m.group(1) if addr in regs else m.group(1)
+    return regs
+
+
+def parse(data, path):
+    """Return (t_ms, flags, {pm address: value}, {fg address: value})."""
+    if len(data) != SIZE or data[:4] != MAGIC or data[4] != VERSION:
+        sys.exit("%s: not a version %d register image of %d bytes" % (path, VERSION, SIZE))
+    t_ms = struct.unpack_from("<I", data, 6)[0]
+    flags = data[5]
+    pm = {}
+    for addr in range(PM_SPAN):
+        if data[BITMAP_OFFSET + addr // 8] & (1 << (addr % 8)):
+            pm[addr] = data[PM_OFFSET + addr]
+    fg = {}
+    if flags & FLAG_FG_OK:
+        offset = FG_OFFSET
+        for first, count in FG_RANGES:
+            for addr in range(first, first + count):
+                fg[addr] = struct.unpack_from("<H", data, offset)[0]
+                offset += 2
+    return t_ms, flags, pm, fg
+
+
+def read_image(path):
+    with open(path, "rb") as f:
+        return parse(f.read(), path)
+
+
+def fields(value, layout):
+    return [(name, (value >> lsb) & ((1 << (msb - lsb + 1)) - 1)) for name, msb, lsb in layout]
+
+
+def describe(t_ms, flags):
+    parts = [name for bit, name in ((FLAG_PM_OK, "pm"), (FLAG_FG_OK, "fg"), (FLAG_COR, "cor")) if flags & bit]
+    return "t_ms %d, %s" % (t_ms, "+".join(parts) or "empty")
+
+
+def decode(args):
+    pm_map, fg_map = load_pm_map(), load_fg_map()
+    t_ms, flags, pm, fg = read_image(args.image)
+    print("# " + describe(t_ms, flags))
+    for addr, value in sorted(pm.items()):
+        if addr not in pm_map:
+            continue
+        name, layout = pm_map[addr]
+        text = " ".join("%s=%d" % f for f in fields(value, layout))
+        print("PM 0x%02X %-16s 0x%02X  %s" % (addr, name, value, text))
+    for addr, value in sorted(fg.items()):
+        if addr in fg_map or args.all:
+            print("FG 0x%02X %-16s 0x%04X" % (addr, fg_map.get(addr, ""), value))
+
+
+def diff(args):
+    pm_map, fg_map = load_pm_map(), load_fg_map()
+    t_a, flags_a, pm_a, fg_a = read_image(args.a)
+    t_b, flags_b, pm_b, fg_b = read_image(args.b)
+    print("# a: " + describe(t_a, flags_a))
+    print("# b: " + describe(t_b, flags_b))
+    changed = 0
+    for addr in sorted(set(pm_a) & set(pm_b)):
+        if pm_a[addr] == pm_b[addr] or addr not in pm_map:
+            continue
+        name, layout = pm_map[addr]
+        text = " ".join("%s %d->%d" % (fa[0], fa[1], fb[1])
+                        for fa, fb in zip(fields(pm_a[addr], layout), fields(pm_b[addr], layout)) if fa != fb)
+        print("PM 0x%02X %-16s 0x%02X -> 0x%02X  %s" % (addr, name, pm_a[addr], pm_b[addr], text))
+        changed += 1
+    for addr in sorted(set(fg_a) & set(fg_b)):
+        if fg_a[addr] != fg_b[addr] and (addr in fg_map or args.all):
+            print("FG 0x%02X %-16s 0x%04X -> 0x%04X  %+d" % (addr, fg_map.get(addr, ""), fg_a[addr], fg_b[addr],
+                                                           fg_b[addr] - fg_a[addr]))
+            changed += 1
+    print("# %d registers differ" % changed)
+
+
+def extract(args):
+    stream = open(args.capture, "rb") if args.capture else sys.stdin.buffer
+    image = None
+    count = 0
+    for _, tag, payload in frames(stream):
+        if tag != TELEMETRY_DUMP or len(payload) < 4:
+            continue
+        offset, size = struct.unpack_from("<HH", payload)
+        if offset == 0:
+            image = bytearray(size)
+            filled = 0
+        if image is None or size != len(image) or offset != filled:
+            image = None  # a record was lost, wait for the next image
+            continue
+        chunk = payload[4:]
+        image[offset:offset + len(chunk)] = chunk
+        filled += len(chunk)
+        if filled == size:
+            t_ms = struct.unpack_from("<I", image, 6)[0]
+            path = "%s_%d.bin" % (args.output, t_ms)
+            with open(path, "wb") as f:
+                f.write(image)
+            print(path)
+            count += 1
+            image = None
+    if not count:
+        print("no complete image in the capture", file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    sub = parser.add_subparsers(dest="command", required=True)
+    p = sub.add_parser("decode", help="print every register with its fields")
+    p.add_argument("image")
+    p.add_argument("--all", action="store_true", help="include FG addresses without a name")
+    p.set_defaults(func=decode)
+    p = sub.add_parser("diff", help="print the registers that differ between two images")
+    p.add_argument("a")
+    p.add_argument("b")
+    p.add_argument("--all", action="store_true", help="include FG addresses without a name")
+    p.set_defaults(func=diff)
+    p = sub.add_parser("extract", help="write the images of a telemetry capture to files")
+    p.add_argument("capture", nargs="?", help="captured stream, stdin if omitted")
+    p.add_argument("-o", "--output", default="regdump", help="file name prefix")
+    p.set_defaults(func=extract)
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
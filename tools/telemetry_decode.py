@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+"""
+telemetry_decode.py
+
+Decode the binary telemetry stream of main/component/telemetry into CSV.
+
+Frames are [type][seq][payload][crc16] COBS encoded between 0x00 delimiters,
+see telemetry.h. Boot messages and ESP_LOG text on the same UART are skipped,
+as are frames with a bad CRC or an unexpected length.
+
+    python3 tools/telemetry_decode.py capture.bin > battery.csv
+    python3 tools/telemetry_decode.py --type battery < /dev/ttyUSB0
+"""
+
+import argparse
+import csv
+import struct
+import sys
+
+# type tag -> (name, struct format, field names), keep in sync with telemetry.h
+RECORDS = {
+    0x01: ("battery", "<Iiiiihiii",
+           ["t_ms", "avg_vcell_uv", "avg_current_ua", "current_ua", "rep_cap_mah",
+            "rep_soc", "power_uw", "energy_out_uwh", "energy_in_uwh"]),
+    0x02: ("button", "<IB", ["t_ms", "event"]),
+    0x03: ("rail", "<IBH", ["t_ms", "rail", "mv"]),
+    0x04: ("stats", "<III", ["t_ms", "wakes", "kicked_wakes"]),
+    0x05: ("alert", "<IH", ["t_ms", "status"]),
+    0x06: ("health", "<IBB", ["t_ms", "client", "missed"]),
+    0x07: ("charger", "<IBBBBB", ["t_ms", "state", "jeita", "zone", "chgin", "flags"]),
+    0x08: ("charge", "<IBBBb", ["t_ms", "reason", "chg_cc", "ichgin_lim", "temp_c"]),
+    0x09: ("rail_up", "<IBBHH", ["t_ms", "rail", "slot", "en_ms", "ramp_ms"]),
+    0x0A: ("power_mode", "<IBiI", ["t_ms", "mode", "avg_current_ua", "switches"]),
+    # 0x0B register image chunks are reassembled by tools/regdump.py
+    0x0C: ("boot", "<IBHHbB", ["t_ms", "stage", "start_ms", "dur_ms", "status", "flags"]),
+}
+
+BUTTON_EVENTS = {1: "single", 2: "double", 3: "triple", 4: "long"}
+RAILS = {0: "SBB0", 1: "SBB1", 2: "SBB2", 3: "LDO0", 4: "LDO1"}
+CHG_STATES = ["no_input", "off", "prequal", "fast_cc", "fast_cv", "top_off", "done",
+              "fault_prequal_timer", "fault_fast_timer", "fault_temp", "unknown"]
+CHG_ZONES = ["off", "cold", "cool", "warm", "hot", "normal", "unknown"]
+CHG_INPUTS = ["uvlo", "ovp", "debounce", "ok"]
+CHG_CTRL_REASONS = ["hold", "raise", "die_hot", "batt_hot", "ilim_up", "ilim_cc"]
+POWER_MODES = ["normal", "save", "low"]
+BOOT_STAGES = ["bus", "fg_por", "pm_base", "rails", "pm_run", "fg_model", "fg_ready", "dump"]
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    """Return the decoded frame or None when the encoding is broken."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def frames(stream):
+    """Yield (seq, type, payload) of every valid frame in a byte stream."""
+    buf = bytearray()
+    while True:
+        chunk = stream.read(4096)
+        if not chunk:
+            break
+        buf += chunk
+        *parts, buf = buf.split(b"\x00")
+        for part in parts:
+            raw = cobs_decode(bytes(part))
+            if raw is None or len(raw) < 4:
+                continue
+            body, crc = raw[:-2], struct.unpack("<H", raw[-2:])[0]
+            if crc16(body) != crc:
+                continue
+            yield body[1], body[0], body[2:]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    parser.add_argument("capture", nargs="?", help="captured stream, stdin if omitted")
+    parser.add_argument("--type", choices=[r[0] for r in RECORDS.values()],
+                        help="only emit records of this type")
+    args = parser.parse_args()
+
+    stream = open(args.capture, "rb") if args.capture else sys.stdin.buffer
+    writer = csv.writer(sys.stdout)
+    headers = set()
+    last_seq = None
+    dropped = 0
+
+    for seq, tag, payload in frames(stream):
+        if last_seq is not None:
+            dropped += (seq - last_seq - 1) & 0xFF
+        last_seq = seq
+
+        if tag not in RECORDS:
+            continue
+        name, fmt, fields = RECORDS[tag]
+        if len(payload) != struct.calcsize(fmt) or (args.type and name != args.type):
+            continue
+
+        values = list(struct.unpack(fmt, payload))
+        if name == "button":
+            values[1] = BUTTON_EVENTS.get(values[1], values[1])
+        elif name == "rail":
+            values[1] = RAILS.get(values[1], values[1])
+        elif name == "rail_up":
+            values[1] = RAILS.get(values[1], values[1])
+            values[2] = "sw" if values[2] == 0xFF else "fps%d" % values[2]
+        elif name == "charger":
+            for i, names in ((1, CHG_STATES), (3, CHG_ZONES), (4, CHG_INPUTS)):
+                values[i] = names[values[i]] if values[i] < len(names) else values[i]
+        elif name == "charge":
+            values[1] = CHG_CTRL_REASONS[values[1]] if values[1] < len(CHG_CTRL_REASONS) else values[1]
+        elif name == "power_mode":
+            values[1] = POWER_MODES[values[1]] if values[1] < len(POWER_MODES) else values[1]
+        elif name == "boot":
+            values[1] = BOOT_STAGES[values[1]] if values[1] < len(BOOT_STAGES) else values[1]
+            values[5] = "skipped" if values[5] & 2 else ("critical" if values[5] & 1 else "")
+
+        # One header per record type, so a single-type capture is plain CSV
+        if name not in headers:
+            writer.writerow(["type", "seq"] + fields)
+            headers.add(name)
+        writer.writerow([name, seq] + values)
+
+    if dropped:
+        print("%d records lost (sequence gaps)" % dropped, file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()